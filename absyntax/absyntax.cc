@@ -45,6 +45,107 @@
 
 
 
+/*** Data type analysis ***/
+/* The set of candidate datatypes of an expression/literal/etc. */
+# define CANDIDATE_CAP_INCR 8
+
+candidate_datatypes_c::candidate_datatypes_c(void) {
+  elements = inline_elements;
+  c = inline_capacity;
+  clear();
+}
+
+
+candidate_datatypes_c::candidate_datatypes_c(const candidate_datatypes_c &other) {
+  elements = inline_elements;
+  c = inline_capacity;
+  clear();
+  *this = other;
+}
+
+
+candidate_datatypes_c::~candidate_datatypes_c(void) {
+  if (elements != inline_elements) free(elements);
+}
+
+
+candidate_datatypes_c &candidate_datatypes_c::operator=(const candidate_datatypes_c &other) {
+  if (this == &other) return *this;
+  if (c < other.n) {
+    element_entry_t *new_elements = (element_entry_t *)malloc(other.n * sizeof(element_entry_t));
+    if (NULL == new_elements) ERROR_MSG("out of memory");
+    if (elements != inline_elements) free(elements);
+    elements = new_elements;
+    c = other.n;
+  }
+  for (int i = 0; i < other.n; i++) elements[i] = other.elements[i];
+  n                    = other.n;
+  non_elementary_count = other.non_elementary_count;
+  elementary_set       = other.elementary_set;
+  return *this;
+}
+
+
+void candidate_datatypes_c::push_back(symbol_c *datatype, int ordinal) {
+  /* the bitset only has room for 64 ordinals. Any other datatype is handled as a non elementary datatype. */
+  if (ordinal >= 64) ordinal = -1;
+  
+  if (c <= n) {
+    element_entry_t *new_elements;
+    if (elements == inline_elements) {
+      new_elements = (element_entry_t *)malloc((c+CANDIDATE_CAP_INCR) * sizeof(element_entry_t));
+      if (NULL != new_elements) 
+        for (int i = 0; i < n; i++) new_elements[i] = inline_elements[i];
+    } else
+      new_elements = (element_entry_t *)realloc(elements, (c+CANDIDATE_CAP_INCR) * sizeof(element_entry_t));
+    if (NULL == new_elements) ERROR_MSG("out of memory");
+    elements = new_elements;
+    c += CANDIDATE_CAP_INCR;
+  }
+  elements[n].datatype = datatype;
+  elements[n].ordinal  = ordinal;
+  n++;
+  
+  if (ordinal < 0) non_elementary_count++;
+  else             elementary_set |= ((uint64_t)1 << ordinal);
+}
+
+
+void candidate_datatypes_c::erase(int pos) {
+  if ((pos < 0) || (n <= pos)) ERROR;
+  
+  int ordinal = elements[pos].ordinal;
+  /* Shift all elements down one position, starting at the entry to delete. */
+  for (int i = pos; i < n-1; i++) elements[i] = elements[i+1];
+  n--;
+  
+  if (ordinal < 0) {non_elementary_count--; return;}
+  /* The same elementary datatype may have been inserted more than once. Only clear the bit if this was the last one! */
+  for (int i = 0; i < n; i++) 
+    if (elements[i].ordinal == ordinal) return;
+  elementary_set &= ~((uint64_t)1 << ordinal);
+}
+
+
+void candidate_datatypes_c::clear(void) {
+  n = 0;
+  non_elementary_count = 0;
+  elementary_set = 0;
+  /* NOTE: we keep any memory already allocated on the heap, as the set will most probably be filled in again. */
+}
+
+
+int candidate_datatypes_c::find_elementary(int ordinal) const {
+  if ((ordinal < 0) || (ordinal >= 64))                  return -1;
+  if (0 == (elementary_set & ((uint64_t)1 << ordinal)))  return -1;
+  for (int i = 0; i < n; i++)
+    if (elements[i].ordinal == ordinal) return i;
+  return -1; /* should never occur! */
+}
+
+
+
+
 /* The base class of all symbols */
 symbol_c::symbol_c(
                    int first_line, int first_column, const char *ffile, long int first_order,
@@ -59,6 +160,10 @@ symbol_c::symbol_c(
   this->last_order   = last_order;
   this->parent       = NULL;
   this->token        = NULL;
+  this->basetype_cached = false;
+  this->basetype_decl   = NULL;
+  this->equivtype_decl  = NULL;
+  this->basetype_id     = NULL;
   this->datatype     = NULL;
   this->scope        = NULL;
 }
@@ -154,8 +154,115 @@ class const_value_c {
       {return (_int64.is_valid() || _uint64.is_valid() || _real64.is_valid() || _bool.is_valid());}   
 };
 
-// A forward declaration
+// Forward declarations
 class token_c;
+class symbol_c;
+
+
+
+/*** Data type analysis ***/
+/* The set of candidate datatypes of an expression/literal/etc., filled in stage 3 by the datatype analysis algorithm.
+ * Most expressions only ever have one or two candidate datatypes, so the first few datatypes are stored
+ * inside the object itself, and we only allocate memory on the heap when the set grows beyond that.
+ *
+ * Elementary datatypes are identified by their class (and not by the object instance), so they are
+ * stored together with the ordinal of that class (see get_datatype_info_c::get_elementary_type_ordinal()).
+ * We also keep a bitset of the ordinals in the set, so checking whether a specific elementary
+ * datatype is in the set does not require walking the whole set.
+ * Datatypes inserted without an ordinal (ordinal < 0) are treated as non-elementary datatypes. These will
+ * need to be compared by the caller one by one (using get_datatype_info_c::is_type_equal()).
+ *
+ * NOTE: The order in which datatypes are inserted in the set is preserved, as some algorithms depend on it.
+ */
+class candidate_datatypes_c {
+  private:
+    typedef struct {
+      symbol_c *datatype;
+      int       ordinal;  /* ordinal of the elementary datatype, or -1 */
+    } element_entry_t;
+    
+    static const int inline_capacity = 2;
+    element_entry_t  inline_elements[inline_capacity];
+    element_entry_t *elements;   /* points to inline_elements[], or to memory on the heap once the set grows */
+    int              n;          /* number of elements in the set */
+    int              c;          /* capacity of elements[] */
+    int              non_elementary_count;  /* number of elements inserted without an ordinal */
+    uint64_t         elementary_set;        /* bit i is set when the elementary datatype with ordinal i is in the set */
+
+  public:
+     candidate_datatypes_c(void);
+     candidate_datatypes_c(const candidate_datatypes_c &other);
+    ~candidate_datatypes_c(void);
+    candidate_datatypes_c &operator=(const candidate_datatypes_c &other);
+
+    unsigned int size (void) const {return n;}
+    bool         empty(void) const {return (0 == n);}
+    symbol_c    *operator[](unsigned int pos) const {return elements[pos].datatype;}
+    
+    void push_back(symbol_c *datatype, int ordinal = -1);
+    void erase    (int pos);
+    void clear    (void);
+    
+    /* return whether the set contains any datatype that was inserted without an ordinal */
+    bool has_non_elementary(void) const {return (non_elementary_count > 0);}
+    /* return position of the first elementary datatype with the given ordinal, or -1 if not in the set */
+    int  find_elementary   (int ordinal) const;
+};
+
+
+
+/*** Parameter binding ***/
+/* The binding of a single formal parameter of a POU (Function, FB or Program) to the actual value
+ * passed to it in a specific invocation of that POU. See call_param_bindings_c (in absyntax_utils)
+ * for the algorithm used to resolve these bindings.
+ */
+class param_binding_c {
+  public:
+    symbol_c *param_name;       /* name of the formal parameter. For extensible parameters the index is appended (e.g. IN1, IN2, ...) */
+    symbol_c *decl_param_name;  /* name of the formal parameter, as it is declared in the POU (e.g. IN for all extensible parameters) */
+    symbol_c *param_type;       /* datatype of the formal parameter */
+    symbol_c *param_value;      /* the value passed to the parameter, or NULL if no value is passed */
+    symbol_c *default_value;    /* the default value of the parameter in the POU declaration (may be NULL) */
+    int       param_direction;  /* a function_param_iterator_c::param_direction_t */
+    bool      en_eno_implicit;  /* parameter is an implicitly declared EN or ENO parameter */
+    bool      extensible;       /* parameter is an extensible parameter */
+    bool      implicit_variable;/* value is taken from the IL implicit variable (accumulator); param_value will be NULL */
+    bool      extensible_count; /* not a real parameter! Marks the position, just before the first extensible parameter, 
+                                 * where the C code for extensible functions passes the number of extensible parameters.
+                                 * All other fields are NULL/false.
+                                 */
+};
+
+/* The parameter bindings of a POU invocation, in the order in which the parameters are declared in the POU.
+ * Filled in stage 3 (once the POU being called has been determined), and then used by any later
+ * stage that needs to know which value is passed to each parameter.
+ */
+class param_binding_list_c : public std::vector <param_binding_c> {
+  public:
+    symbol_c *pou_decl;        /* the POU declaration these bindings were resolved against, or NULL if not yet resolved */
+    bool      unbound_values;  /* some of the values passed in the invocation could not be bound to any parameter */
+    
+    param_binding_list_c(void): pou_decl(NULL), unbound_values(false) {}
+};
+
+
+
+/*** EN/ENO usage analysis ***/
+/* Whether the EN and ENO parameters of a Function or Function Block are ever used from outside the POU,
+ * i.e. whether any invocation passes a value to EN or reads ENO (or, for FBs, whether the EN or ENO 
+ * of any instance is accessed directly as in 'fb_inst.ENO').
+ * Filled in stage 3 by en_eno_analysis_c. Until then (or when EN/ENO are explicitly declared by the
+ * user) we assume they are used, so stage 4 keeps the full EN/ENO semantics.
+ */
+class en_eno_usage_c {
+  public:
+    bool en_used;
+    bool eno_used;
+    
+    en_eno_usage_c(void): en_used(true), eno_used(true) {}
+};
+
+
 
 /* The base class of all symbols */
 class symbol_c {
@@ -192,11 +299,26 @@ class symbol_c {
     long int last_order;    /* relative order in which it is read by lexcial analyser */
 
 
+    /*
+     * Annotations produced after stage 1_2 (i.e. once the symbol tables have been populated)
+     */    
+    /*** Base type resolution ***/
+    /* Memoised results of search_base_type_c for this symbol. These are filled in the first time
+     * search_base_type_c is asked for the base/equivalent type of this symbol, and simply returned
+     * on every subsequent call.
+     * Do not access directly! Use search_base_type_c::get_basetype_decl(), get_equivtype_decl() and get_basetype_id().
+     */
+    bool      basetype_cached;
+    symbol_c *basetype_decl;
+    symbol_c *equivtype_decl;
+    symbol_c *basetype_id;
+
+
     /*
      * Annotations produced during stage 3
      */    
     /*** Data type analysis ***/
-    std::vector <symbol_c *> candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
+    candidate_datatypes_c candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
     /* Data type of the expression/literal/etc. Filled in stage3 by narrow_candidate_datatypes_c 
      * If set to NULL, it means it has not yet been evaluated.
      * If it points to an object of type invalid_type_name_c, it means it is invalid.
@@ -88,6 +88,7 @@ extern  type_symtable_t type_symtable;
 #include "function_param_iterator.hh"
 #include "function_call_iterator.hh"
 #include "function_call_param_iterator.hh"
+#include "call_param_bindings.hh"
 #include "type_initial_value.hh"
 #include "search_fb_instance_decl.hh"
 #include "search_fb_typedecl.hh"
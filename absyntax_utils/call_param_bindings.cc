@@ -0,0 +1,141 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  A small helper class that resolves, and caches, the binding of the
+ *  formal parameters of a POU (Function, FB or Program) to the values
+ *  passed in a specific invocation of that POU.
+ *
+ *  See call_param_bindings.hh for details.
+ */
+
+
+
+#include "absyntax_utils.hh"
+#include "../util/strdup.hh"
+
+
+
+call_param_bindings_c *call_param_bindings_c::singleton_instance_ = NULL;
+
+
+
+const param_binding_list_c &call_param_bindings_c::get(symbol_c *f_call, symbol_c *pou_decl) {
+  if (NULL == singleton_instance_) singleton_instance_ = new call_param_bindings_c(); 
+  if (NULL == singleton_instance_) ERROR; 
+  if (NULL == pou_decl) ERROR;
+
+  param_binding_list_c *bindings = (param_binding_list_c *)f_call->accept(*singleton_instance_);
+  if (NULL == bindings) ERROR;  /* not a POU invocation! */
+
+  if (bindings->pou_decl != pou_decl) {
+    /* Only non formal IL function calls get the value of the first parameter from the IL implicit variable */
+    bool implicit_first_param = (NULL != dynamic_cast<il_function_call_c *>(f_call));
+    resolve(f_call, pou_decl, implicit_first_param, *bindings);
+  }
+  return *bindings;
+}
+
+
+
+void call_param_bindings_c::resolve(symbol_c *f_call, symbol_c *pou_decl, bool implicit_first_param, param_binding_list_c &bindings) {
+  function_param_iterator_c      fp_iterator(pou_decl);
+  function_call_param_iterator_c fcp_iterator(f_call);
+  identifier_c *param_name;
+    /* flag to remember whether we have already used the value stored in the IL implicit variable to pass to the first parameter */
+  bool used_implicit_variable = !implicit_first_param;
+    /* flag to correctly handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
+  bool found_first_extensible_parameter = false;
+
+  bindings.clear();
+  while ((param_name = fp_iterator.next()) != NULL) {
+    param_binding_c binding;
+    binding.decl_param_name   = param_name;
+    binding.param_name        = param_name;
+    binding.param_type        = fp_iterator.param_type();
+    binding.param_value       = NULL;
+    binding.default_value     = fp_iterator.default_value();
+    binding.param_direction   = fp_iterator.param_direction();
+    binding.en_eno_implicit   = fp_iterator.is_en_eno_param_implicit();
+    binding.extensible        = fp_iterator.is_extensible_param();
+    binding.implicit_variable = false;
+    binding.extensible_count  = false;
+    if (NULL == binding.param_type) ERROR;
+
+    if (binding.extensible && !found_first_extensible_parameter) {
+      /* Mark the position in which the number of extensible parameters must be passed */
+      param_binding_c count_binding = {NULL, NULL, NULL, NULL, NULL, function_param_iterator_c::direction_in, false, false, false, true};
+      bindings.push_back(count_binding);
+      found_first_extensible_parameter = true;
+    }
+
+    if (binding.extensible) {
+      /* since we are handling an extensible parameter, we must add the index to the
+       * parameter name so we can go looking for the value passed to the correct
+       * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
+       */
+      char tmp[32]; /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
+      int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
+      if ((res >= 32) || (res < 0)) ERROR;
+      binding.param_name = new identifier_c(strdup2(param_name->value, tmp));
+    }
+
+    /* Get the value from a foo(<param_name> = <param_value>) style call */
+    binding.param_value = fcp_iterator.search_f(binding.param_name);
+
+    /* Get the value off the IL implicit variable. 
+     * If the parameter is an implicitly defined EN or ENO parameter, we should not
+     * use the IL implicit variable as a source of data to pass to those parameters!
+     */
+    if ((NULL == binding.param_value) && !used_implicit_variable && !binding.en_eno_implicit) {
+      binding.implicit_variable = true;
+      used_implicit_variable = true;
+    }
+
+    /* Get the value from a foo(<param_value>) style call */
+    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
+     * were implicitly defined!
+     */
+    if ((NULL == binding.param_value) && !binding.implicit_variable && !binding.en_eno_implicit)
+      binding.param_value = fcp_iterator.next_nf();
+
+    /* if no more parameter values in the call, and the current parameter
+     * of the POU declaration is an extensible parameter, we
+     * have reached the end, and should simply stop here.
+     */
+    if ((NULL == binding.param_value) && !binding.implicit_variable && binding.extensible)
+      break;
+
+    bindings.push_back(binding);
+  }
+
+  bindings.unbound_values = (NULL != fcp_iterator.next_nf());
+  bindings.pou_decl = pou_decl;
+}
+
@@ -0,0 +1,73 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  A small helper class that resolves, and caches, the binding of the
+ *  formal parameters of a POU (Function, FB or Program) to the values
+ *  passed in a specific invocation of that POU.
+ *
+ *  For each parameter declared in the POU being called, determine the
+ *  value being passed to it, following the exact same rules used by
+ *  stage 3 and stage 4 when handling POU invocations:
+ *    - a value passed in a formal invocation ( foo(<param_name> := <value>) );
+ *    - otherwise, the next value passed in a non formal invocation ( foo(<value>) ),
+ *      unless the parameter is an implicitly declared EN or ENO;
+ *    - in non formal IL function calls, the first parameter gets the value
+ *      stored in the IL implicit variable (i.e. the accumulator).
+ *  Extensible parameters (IN1, IN2, ...) are bound until no more values are found.
+ *
+ *  The resulting table is stored in the param_bindings annotation of the
+ *  invocation, so it is only ever resolved once for each call site (as long
+ *  as it is requested against the same POU declaration).
+ *
+ *  Supported invocations:
+ *    function_invocation_c, fb_invocation_c,
+ *    il_function_call_c, il_formal_funct_call_c, il_fb_call_c
+ */
+
+
+
+class call_param_bindings_c : public null_visitor_c {
+  public:
+    /* Return the bindings of the invocation <f_call> to the POU declared in <pou_decl> */
+    static const param_binding_list_c &get(symbol_c *f_call, symbol_c *pou_decl);
+
+  private:
+    call_param_bindings_c(void) {};
+    static call_param_bindings_c *singleton_instance_;
+    static void resolve(symbol_c *f_call, symbol_c *pou_decl, bool implicit_first_param, param_binding_list_c &bindings);
+
+    /* return a pointer to the param_bindings annotation of the invocation */
+    void *visit(function_invocation_c  *symbol) {return &symbol->param_bindings;}
+    void *visit(fb_invocation_c        *symbol) {return &symbol->param_bindings;}
+    void *visit(il_function_call_c     *symbol) {return &symbol->param_bindings;}
+    void *visit(il_formal_funct_call_c *symbol) {return &symbol->param_bindings;}
+    void *visit(il_fb_call_c           *symbol) {return &symbol->param_bindings;}
+};
+
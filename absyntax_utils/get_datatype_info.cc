@@ -315,6 +315,185 @@ get_datatype_id_str_c *get_datatype_id_str_c::singleton = NULL;
 
 
 
+
+/****************************************************************/
+/****************************************************************/
+/* map each elementary data type class onto a dense ordinal     */
+/****************************************************************/
+/****************************************************************/
+
+/* Elementary datatypes are identified by their class (not by the object instance), since
+ * stage 1_2 creates a new object for every occurrence of an elementary type name in the source code.
+ * This helper class maps each of these classes onto a small dense integer, so
+ * that algorithms working on pairs of elementary datatypes (e.g. the widening tables used by
+ * stage 3) may use it to index into a table, instead of comparing typeid()s one by one.
+ */
+class get_elementary_type_ordinal_c: public null_visitor_c {
+  private:
+    int ordinal;
+    /* singleton class! */
+    static get_elementary_type_ordinal_c *singleton;
+
+  public:
+    static int get_ordinal(symbol_c *symbol) {
+      if (NULL == singleton)    singleton = new get_elementary_type_ordinal_c;
+      if (NULL == singleton)    ERROR;
+      singleton->ordinal = -1;
+      symbol->accept(*singleton);
+      return singleton->ordinal;
+    }
+
+  protected:
+    /***********************************/
+    /* B 1.3.1 - Elementary Data Types */
+    /***********************************/
+    void *visit(time_type_name_c        *symbol) {ordinal =  0; return NULL;};
+    void *visit(bool_type_name_c        *symbol) {ordinal =  1; return NULL;};
+    void *visit(sint_type_name_c        *symbol) {ordinal =  2; return NULL;};
+    void *visit(int_type_name_c         *symbol) {ordinal =  3; return NULL;};
+    void *visit(dint_type_name_c        *symbol) {ordinal =  4; return NULL;};
+    void *visit(lint_type_name_c        *symbol) {ordinal =  5; return NULL;};
+    void *visit(usint_type_name_c       *symbol) {ordinal =  6; return NULL;};
+    void *visit(uint_type_name_c        *symbol) {ordinal =  7; return NULL;};
+    void *visit(udint_type_name_c       *symbol) {ordinal =  8; return NULL;};
+    void *visit(ulint_type_name_c       *symbol) {ordinal =  9; return NULL;};
+    void *visit(real_type_name_c        *symbol) {ordinal = 10; return NULL;};
+    void *visit(lreal_type_name_c       *symbol) {ordinal = 11; return NULL;};
+    void *visit(date_type_name_c        *symbol) {ordinal = 12; return NULL;};
+    void *visit(tod_type_name_c         *symbol) {ordinal = 13; return NULL;};
+    void *visit(dt_type_name_c          *symbol) {ordinal = 14; return NULL;};
+    void *visit(byte_type_name_c        *symbol) {ordinal = 15; return NULL;};
+    void *visit(word_type_name_c        *symbol) {ordinal = 16; return NULL;};
+    void *visit(dword_type_name_c       *symbol) {ordinal = 17; return NULL;};
+    void *visit(lword_type_name_c       *symbol) {ordinal = 18; return NULL;};
+    void *visit(string_type_name_c      *symbol) {ordinal = 19; return NULL;};
+    void *visit(wstring_type_name_c     *symbol) {ordinal = 20; return NULL;};
+
+    void *visit(safetime_type_name_c    *symbol) {ordinal = 21; return NULL;};
+    void *visit(safebool_type_name_c    *symbol) {ordinal = 22; return NULL;};
+    void *visit(safesint_type_name_c    *symbol) {ordinal = 23; return NULL;};
+    void *visit(safeint_type_name_c     *symbol) {ordinal = 24; return NULL;};
+    void *visit(safedint_type_name_c    *symbol) {ordinal = 25; return NULL;};
+    void *visit(safelint_type_name_c    *symbol) {ordinal = 26; return NULL;};
+    void *visit(safeusint_type_name_c   *symbol) {ordinal = 27; return NULL;};
+    void *visit(safeuint_type_name_c    *symbol) {ordinal = 28; return NULL;};
+    void *visit(safeudint_type_name_c   *symbol) {ordinal = 29; return NULL;};
+    void *visit(safeulint_type_name_c   *symbol) {ordinal = 30; return NULL;};
+    void *visit(safereal_type_name_c    *symbol) {ordinal = 31; return NULL;};
+    void *visit(safelreal_type_name_c   *symbol) {ordinal = 32; return NULL;};
+    void *visit(safedate_type_name_c    *symbol) {ordinal = 33; return NULL;};
+    void *visit(safetod_type_name_c     *symbol) {ordinal = 34; return NULL;};
+    void *visit(safedt_type_name_c      *symbol) {ordinal = 35; return NULL;};
+    void *visit(safebyte_type_name_c    *symbol) {ordinal = 36; return NULL;};
+    void *visit(safeword_type_name_c    *symbol) {ordinal = 37; return NULL;};
+    void *visit(safedword_type_name_c   *symbol) {ordinal = 38; return NULL;};
+    void *visit(safelword_type_name_c   *symbol) {ordinal = 39; return NULL;};
+    void *visit(safestring_type_name_c  *symbol) {ordinal = 40; return NULL;};
+    void *visit(safewstring_type_name_c *symbol) {ordinal = 41; return NULL;};
+    /* NOTE: VOID is not a real datatype (it may never be used in an expression), so it does not get an ordinal. */
+}; // get_elementary_type_ordinal_c
+
+get_elementary_type_ordinal_c *get_elementary_type_ordinal_c::singleton = NULL;
+
+
+
+/* The classification of each elementary datatype, indexed by the ordinal of the datatype.
+ * All the is_ANY_xxx() predicates on elementary datatypes are answered by looking up this table,
+ * instead of comparing the typeid() of the datatype against every class in the category.
+ */
+enum {
+  tc_signed_INT   = 0x0001,
+  tc_unsigned_INT = 0x0002,
+  tc_REAL         = 0x0004,
+  tc_TIME         = 0x0008,
+  tc_DATE         = 0x0010,
+  tc_BOOL         = 0x0020,
+  tc_nBIT         = 0x0040,
+  tc_STRING       = 0x0080,
+  tc_SAFE         = 0x0100,  /* SAFExxx datatypes */
+  
+  tc_INT              = tc_signed_INT | tc_unsigned_INT,
+  tc_NUM              = tc_INT | tc_REAL,
+  tc_signed_NUM       = tc_signed_INT | tc_REAL,
+  tc_MAGNITUDE        = tc_NUM | tc_TIME,
+  tc_signed_MAGNITUDE = tc_signed_NUM | tc_TIME,
+  tc_BIT              = tc_BOOL | tc_nBIT,
+  tc_ELEMENTARY       = tc_MAGNITUDE | tc_BIT | tc_STRING | tc_DATE
+};
+
+static const int elementary_type_class[get_datatype_info_c::elementary_type_count] = {
+  /*  0: TIME     */ tc_TIME,
+  /*  1: BOOL     */ tc_BOOL,
+  /*  2: SINT     */ tc_signed_INT,
+  /*  3: INT      */ tc_signed_INT,
+  /*  4: DINT     */ tc_signed_INT,
+  /*  5: LINT     */ tc_signed_INT,
+  /*  6: USINT    */ tc_unsigned_INT,
+  /*  7: UINT     */ tc_unsigned_INT,
+  /*  8: UDINT    */ tc_unsigned_INT,
+  /*  9: ULINT    */ tc_unsigned_INT,
+  /* 10: REAL        */ tc_REAL,
+  /* 11: LREAL       */ tc_REAL,
+  /* 12: DATE        */ tc_DATE,
+  /* 13: TOD         */ tc_DATE,
+  /* 14: DT          */ tc_DATE,
+  /* 15: BYTE        */ tc_nBIT,
+  /* 16: WORD        */ tc_nBIT,
+  /* 17: DWORD       */ tc_nBIT,
+  /* 18: LWORD       */ tc_nBIT,
+  /* 19: STRING      */ tc_STRING,
+  /* 20: WSTRING     */ tc_STRING,
+  /* 21: SAFETIME    */ tc_TIME | tc_SAFE,
+  /* 22: SAFEBOOL    */ tc_BOOL | tc_SAFE,
+  /* 23: SAFESINT    */ tc_signed_INT | tc_SAFE,
+  /* 24: SAFEINT     */ tc_signed_INT | tc_SAFE,
+  /* 25: SAFEDINT    */ tc_signed_INT | tc_SAFE,
+  /* 26: SAFELINT    */ tc_signed_INT | tc_SAFE,
+  /* 27: SAFEUSINT   */ tc_unsigned_INT | tc_SAFE,
+  /* 28: SAFEUINT    */ tc_unsigned_INT | tc_SAFE,
+  /* 29: SAFEUDINT   */ tc_unsigned_INT | tc_SAFE,
+  /* 30: SAFEULINT   */ tc_unsigned_INT | tc_SAFE,
+  /* 31: SAFEREAL    */ tc_REAL | tc_SAFE,
+  /* 32: SAFELREAL   */ tc_REAL | tc_SAFE,
+  /* 33: SAFEDATE    */ tc_DATE | tc_SAFE,
+  /* 34: SAFETOD     */ tc_DATE | tc_SAFE,
+  /* 35: SAFEDT      */ tc_DATE | tc_SAFE,
+  /* 36: SAFEBYTE    */ tc_nBIT | tc_SAFE,
+  /* 37: SAFEWORD    */ tc_nBIT | tc_SAFE,
+  /* 38: SAFEDWORD   */ tc_nBIT | tc_SAFE,
+  /* 39: SAFELWORD   */ tc_nBIT | tc_SAFE,
+  /* 40: SAFESTRING  */ tc_STRING | tc_SAFE,
+  /* 41: SAFEWSTRING */ tc_STRING | tc_SAFE
+};
+
+
+/* returns the classification of the elementary datatype, or 0 if not an elementary datatype (or NULL) */
+static inline int get_elementary_type_class(symbol_c *type_symbol) {
+  if (type_symbol == NULL)                                     {return 0;}
+  int ordinal = get_elementary_type_ordinal_c::get_ordinal(type_symbol);
+  if (ordinal < 0)                                             {return 0;}
+  return elementary_type_class[ordinal];
+}
+
+/* is it a (non SAFE) elementary datatype in any of the categories in class_mask? */
+static inline bool is_elementary_class    (symbol_c *type_symbol, int class_mask) {
+  int type_class = get_elementary_type_class(type_symbol);
+  return ((type_class & class_mask) != 0) && ((type_class & tc_SAFE) == 0);
+}
+
+/* is it a SAFE elementary datatype in any of the categories in class_mask? */
+static inline bool is_safeelementary_class(symbol_c *type_symbol, int class_mask) {
+  int type_class = get_elementary_type_class(type_symbol);
+  return ((type_class & class_mask) != 0) && ((type_class & tc_SAFE) != 0);
+}
+
+/* is it a SAFE or non SAFE elementary datatype in any of the categories in class_mask? */
+static inline bool is_compatible_class    (symbol_c *type_symbol, int class_mask) {
+  return ((get_elementary_type_class(type_symbol) & class_mask) != 0);
+}
+
+
+
 /*********************************************************/
 /*********************************************************/
 /* get the datatype of a field inside a struct data type */
@@ -446,6 +625,12 @@ symbol_c *get_datatype_info_c::get_id(symbol_c *datatype) {
 }
 
 
+int get_datatype_info_c::get_elementary_type_ordinal(symbol_c *datatype) {
+  if (NULL == datatype) return -1;
+  return get_elementary_type_ordinal_c::get_ordinal(datatype);
+}
+
+
 symbol_c *get_datatype_info_c::get_struct_field_type_id(symbol_c *struct_datatype, symbol_c *struct_fieldname) {
   return get_struct_info_c::get_field_type_id(struct_datatype, struct_fieldname);
 }
@@ -895,30 +1080,17 @@ bool get_datatype_info_c::is_ANY_generic_type(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_ELEMENTARY(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_MAGNITUDE(type_symbol))                           {return true;}
-  if (is_ANY_BIT      (type_symbol))                           {return true;}
-  if (is_ANY_STRING   (type_symbol))                           {return true;}
-  if (is_ANY_DATE     (type_symbol))                           {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_ELEMENTARY);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEELEMENTARY(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_SAFEMAGNITUDE(type_symbol))                       {return true;}
-  if (is_ANY_SAFEBIT      (type_symbol))                       {return true;}
-  if (is_ANY_SAFESTRING   (type_symbol))                       {return true;}
-  if (is_ANY_SAFEDATE     (type_symbol))                       {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_ELEMENTARY);
 }
 
 
 bool get_datatype_info_c::is_ANY_ELEMENTARY_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_ELEMENTARY    (type_symbol))                      {return true;}
-  if (is_ANY_SAFEELEMENTARY(type_symbol))                      {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_ELEMENTARY);
 }
 
 
@@ -928,26 +1100,17 @@ bool get_datatype_info_c::is_ANY_ELEMENTARY_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_MAGNITUDE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_TIME(type_symbol))                                    {return true;}
-  if (is_ANY_NUM(type_symbol))                                 {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_MAGNITUDE);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEMAGNITUDE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_SAFETIME(type_symbol))                                {return true;}
-  if (is_ANY_SAFENUM(type_symbol))                             {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_MAGNITUDE);
 }
 
 
 bool get_datatype_info_c::is_ANY_MAGNITUDE_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_MAGNITUDE    (type_symbol))                       {return true;}
-  if (is_ANY_SAFEMAGNITUDE(type_symbol))                       {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_MAGNITUDE);
 }
 
 
@@ -957,25 +1120,17 @@ bool get_datatype_info_c::is_ANY_MAGNITUDE_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_signed_MAGNITUDE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(time_type_name_c))        {return true;}
-  if (is_ANY_signed_NUM(type_symbol))                          {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_signed_MAGNITUDE);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_SAFEMAGNITUDE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safetime_type_name_c))    {return true;}
-  return is_ANY_signed_SAFENUM(type_symbol);
+  return is_safeelementary_class(type_symbol, tc_signed_MAGNITUDE);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_MAGNITUDE_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_signed_MAGNITUDE    (type_symbol))                {return true;}
-  if (is_ANY_signed_SAFEMAGNITUDE(type_symbol))                {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_signed_MAGNITUDE);
 }
 
 
@@ -985,26 +1140,17 @@ bool get_datatype_info_c::is_ANY_signed_MAGNITUDE_compatible(symbol_c *type_symb
 
 
 bool get_datatype_info_c::is_ANY_NUM(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_REAL(type_symbol))                                {return true;}
-  if (is_ANY_INT (type_symbol))                                {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_NUM);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFENUM(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_SAFEREAL(type_symbol))                            {return true;}
-  if (is_ANY_SAFEINT (type_symbol))                            {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_NUM);
 }
 
 
 bool get_datatype_info_c::is_ANY_NUM_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_NUM    (type_symbol))                             {return true;}
-  if (is_ANY_SAFENUM(type_symbol))                             {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_NUM);
 }
 
 
@@ -1014,26 +1160,17 @@ bool get_datatype_info_c::is_ANY_NUM_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_signed_NUM(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_REAL      (type_symbol))                          {return true;}
-  if (is_ANY_signed_INT(type_symbol))                          {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_signed_NUM);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_SAFENUM(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_SAFEREAL      (type_symbol))                      {return true;}
-  if (is_ANY_signed_SAFEINT(type_symbol))                      {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_signed_NUM);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_NUM_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_signed_NUM    (type_symbol))                      {return true;}
-  if (is_ANY_signed_SAFENUM(type_symbol))                      {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_signed_NUM);
 }
 
 
@@ -1043,26 +1180,17 @@ bool get_datatype_info_c::is_ANY_signed_NUM_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_INT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_signed_INT  (type_symbol))                        {return true;}
-  if (is_ANY_unsigned_INT(type_symbol))                        {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEINT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_signed_SAFEINT  (type_symbol))                    {return true;}
-  if (is_ANY_unsigned_SAFEINT(type_symbol))                    {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_INT_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_INT    (type_symbol))                             {return true;}
-  if (is_ANY_SAFEINT(type_symbol))                             {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_INT);
 }
 
 
@@ -1071,30 +1199,17 @@ bool get_datatype_info_c::is_ANY_INT_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_signed_INT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(sint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(int_type_name_c))         {return true;}
-  if (typeid(*type_symbol) == typeid(dint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(lint_type_name_c))        {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_signed_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_SAFEINT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safesint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeint_type_name_c))     {return true;}
-  if (typeid(*type_symbol) == typeid(safedint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safelint_type_name_c))    {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_signed_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_INT_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_signed_INT    (type_symbol))                      {return true;}
-  if (is_ANY_signed_SAFEINT(type_symbol))                      {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_signed_INT);
 }
 
 
@@ -1106,30 +1221,17 @@ bool get_datatype_info_c::is_ANY_signed_INT_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_unsigned_INT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(usint_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(uint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(udint_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(ulint_type_name_c))       {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_unsigned_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_unsigned_SAFEINT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safeusint_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safeuint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeudint_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safeulint_type_name_c))   {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_unsigned_INT);
 }
 
 
 bool get_datatype_info_c::is_ANY_unsigned_INT_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_unsigned_INT    (type_symbol))                    {return true;}
-  if (is_ANY_unsigned_SAFEINT(type_symbol))                    {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_unsigned_INT);
 }
 
 
@@ -1140,26 +1242,17 @@ bool get_datatype_info_c::is_ANY_unsigned_INT_compatible(symbol_c *type_symbol)
 
 
 bool get_datatype_info_c::is_ANY_REAL(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(real_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(lreal_type_name_c))       {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_REAL);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEREAL(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safereal_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safelreal_type_name_c))   {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_REAL);
 }
 
 
 bool get_datatype_info_c::is_ANY_REAL_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_REAL    (type_symbol))                            {return true;}
-  if (is_ANY_SAFEREAL(type_symbol))                            {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_REAL);
 }
 
 
@@ -1170,30 +1263,17 @@ bool get_datatype_info_c::is_ANY_REAL_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_nBIT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(byte_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(word_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(dword_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(lword_type_name_c))       {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_nBIT);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEnBIT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safebyte_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeword_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safedword_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safelword_type_name_c))   {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_nBIT);
 }
 
 
 bool get_datatype_info_c::is_ANY_nBIT_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_nBIT    (type_symbol))                            {return true;}
-  if (is_ANY_SAFEnBIT(type_symbol))                            {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_nBIT);
 }
 
 
@@ -1206,24 +1286,17 @@ bool get_datatype_info_c::is_ANY_nBIT_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_BOOL(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(bool_type_name_c))        {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_BOOL);
 }
 
 
 bool get_datatype_info_c::is_SAFEBOOL(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safebool_type_name_c))    {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_BOOL);
 }
 
 
 bool get_datatype_info_c::is_BOOL_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_BOOL    (type_symbol))                                {return true;}
-  if (is_SAFEBOOL(type_symbol))                                {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_BOOL);
 }
 
 
@@ -1235,26 +1308,17 @@ bool get_datatype_info_c::is_BOOL_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_BIT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_BOOL    (type_symbol))                                {return true;}
-  if (is_ANY_nBIT(type_symbol))                                {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_BIT);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEBIT(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_SAFEBOOL    (type_symbol))                            {return true;}
-  if (is_ANY_SAFEnBIT(type_symbol))                            {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_BIT);
 }
 
 
 bool get_datatype_info_c::is_ANY_BIT_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_BIT    (type_symbol))                             {return true;}
-  if (is_ANY_SAFEBIT(type_symbol))                             {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_BIT);
 }
 
 
@@ -1265,24 +1329,17 @@ bool get_datatype_info_c::is_ANY_BIT_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_TIME(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(time_type_name_c))        {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_TIME);
 }
 
 
 bool get_datatype_info_c::is_SAFETIME(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safetime_type_name_c))    {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_TIME);
 }
 
 
 bool get_datatype_info_c::is_TIME_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_TIME    (type_symbol))                                {return true;}
-  if (is_SAFETIME(type_symbol))                                {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_TIME);
 }
 
 
@@ -1293,28 +1350,17 @@ bool get_datatype_info_c::is_TIME_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_DATE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(date_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(tod_type_name_c))         {return true;}
-  if (typeid(*type_symbol) == typeid(dt_type_name_c))          {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_DATE);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEDATE(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safedate_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safetod_type_name_c))     {return true;}
-  if (typeid(*type_symbol) == typeid(safedt_type_name_c))      {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_DATE);
 }
 
 
 bool get_datatype_info_c::is_ANY_DATE_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_DATE    (type_symbol))                            {return true;}
-  if (is_ANY_SAFEDATE(type_symbol))                            {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_DATE);
 }
 
 
@@ -1328,26 +1374,17 @@ bool get_datatype_info_c::is_ANY_DATE_compatible(symbol_c *type_symbol) {
 
 
 bool get_datatype_info_c::is_ANY_STRING(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(string_type_name_c))      {return true;}
-  if (typeid(*type_symbol) == typeid(wstring_type_name_c))     {return true;}
-  return false;
+  return is_elementary_class(type_symbol, tc_STRING);
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFESTRING(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safestring_type_name_c))  {return true;}
-  if (typeid(*type_symbol) == typeid(safewstring_type_name_c)) {return true;}
-  return false;
+  return is_safeelementary_class(type_symbol, tc_STRING);
 }
 
 
 bool get_datatype_info_c::is_ANY_STRING_compatible(symbol_c *type_symbol) {
-  if (type_symbol == NULL)                                     {return false;}
-  if (is_ANY_STRING    (type_symbol))                          {return true;}
-  if (is_ANY_SAFESTRING(type_symbol))                          {return true;}
-  return false;
+  return is_compatible_class(type_symbol, tc_STRING);
 }
 
 
@@ -62,38 +62,41 @@ void search_base_type_c::create_singleton(void) {
   if (NULL == search_base_type_singleton)   ERROR;
 }
 
-/* static method! */
-symbol_c *search_base_type_c::get_equivtype_decl(symbol_c *symbol) {
+/* Determine the base type, equivalent type and base type name of the symbol, and store them in the symbol itself.
+ * The base type of a symbol never changes once the symbol tables have been populated, so
+ * we only ever need to walk the chain of type declarations once for each symbol.
+ */
+void search_base_type_c::resolve(symbol_c *symbol) {
   create_singleton();
-  if (NULL == symbol)    return NULL; 
   search_base_type_singleton->current_basetype_name = NULL;
   search_base_type_singleton->current_basetype  = NULL; 
   search_base_type_singleton->current_equivtype = NULL; 
   symbol_c *basetype = (symbol_c *)symbol->accept(*search_base_type_singleton);
-  if (NULL != search_base_type_singleton->current_equivtype)
-    return search_base_type_singleton->current_equivtype;
-  return basetype;
+  symbol->basetype_decl  = basetype;
+  symbol->equivtype_decl = (NULL != search_base_type_singleton->current_equivtype)? search_base_type_singleton->current_equivtype : basetype;
+  symbol->basetype_id    = search_base_type_singleton->current_basetype_name;
+  symbol->basetype_cached = true;
+}
+
+/* static method! */
+symbol_c *search_base_type_c::get_equivtype_decl(symbol_c *symbol) {
+  if (NULL == symbol)    return NULL; 
+  if (!symbol->basetype_cached) resolve(symbol);
+  return symbol->equivtype_decl;
 }
 
 /* static method! */
 symbol_c *search_base_type_c::get_basetype_decl(symbol_c *symbol) {
-  create_singleton();
   if (NULL == symbol)    return NULL; 
-  search_base_type_singleton->current_basetype_name = NULL;
-  search_base_type_singleton->current_basetype  = NULL; 
-  search_base_type_singleton->current_equivtype = NULL; 
-  return (symbol_c *)symbol->accept(*search_base_type_singleton);
+  if (!symbol->basetype_cached) resolve(symbol);
+  return symbol->basetype_decl;
 }
 
 /* static method! */
 symbol_c *search_base_type_c::get_basetype_id  (symbol_c *symbol) {
-  create_singleton();
   if (NULL == symbol)    return NULL; 
-  search_base_type_singleton->current_basetype_name = NULL;
-  search_base_type_singleton->current_basetype  = NULL; 
-  search_base_type_singleton->current_equivtype = NULL; 
-  symbol->accept(*search_base_type_singleton);
-  return (symbol_c *)search_base_type_singleton->current_basetype_name;
+  if (!symbol->basetype_cached) resolve(symbol);
+  return symbol->basetype_id;
 }
 
 
@@ -74,6 +74,7 @@ class search_base_type_c: public null_visitor_c {
     
   private:  
     static void create_singleton(void);
+    static void resolve(symbol_c *symbol);
     void *handle_datatype_identifier(token_c *type_name);
 
   public:
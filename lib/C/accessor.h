@@ -133,4 +133,25 @@
 #define __SET_LOCATED(prefix, name, suffix, new_value)\
 	if (!(prefix name.flags & __IEC_FORCE_FLAG)) *(prefix name.value) suffix = new_value
 
+// packed SFC state bit macros (bits is an array of DWORD)
+#define __GET_SFC_BIT(bits, index)\
+	(((bits)[(index) >> 5] >> ((index) & 31)) & 1)
+#define __SET_SFC_BIT(bits, index, new_value)\
+	do {if (new_value) (bits)[(index) >> 5] |= ((DWORD)1 << ((index) & 31));\
+	    else (bits)[(index) >> 5] &= ~((DWORD)1 << ((index) & 31));} while (0)
+
+// vectorisation hints for FOR loops over arrays
+#if defined(__GNUC__)
+#define __RESTRICT __restrict__
+#else
+#define __RESTRICT
+#endif
+#if defined(__clang__)
+#define __IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define __IVDEP _Pragma("GCC ivdep")
+#else
+#define __IVDEP
+#endif
+
 #endif //__ACCESSOR_H
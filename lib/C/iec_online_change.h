@@ -0,0 +1,116 @@
+/*
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Online change: migration of the state of FB and Program instances
+ */
+
+/* When the 'o' stage4 option is given (-O o), iec2c generates for each FB and Program
+ * (e.g. PROG) whose code is generated:
+ *   const __pou_layout_t PROG_layout__;
+ *   unsigned long PROG_migrate__(PROG *data__, const void *old_data, const __pou_layout_t *old_layout, BOOL retain);
+ *
+ * The layout descriptor lists the variables of the PROG data structure that keep their
+ * value between invocations. PROG_migrate__() initialises the instance data__, and then
+ * copies into it the state of the instance old_data of the previous version of PROG,
+ * whose layout descriptor is old_layout. It returns the number of variables that kept
+ * their initial value, as they did not exist (with the same datatype) in the previous version.
+ *
+ * A PLC runtime that loads the new version of the generated code next to the old one
+ * may therefore swap them between two cycles:
+ *   config_init__();                  // of the new version, initialises the globals
+ *   PROG_migrate__(&new_RES__INSTANCE, &old_RES__INSTANCE, old_PROG_layout__, 0);
+ *   ...                               // for each program instance
+ * and then continue calling config_run__() of the new version.
+ */
+
+#ifndef _IEC_ONLINE_CHANGE_H
+#define _IEC_ONLINE_CHANGE_H
+
+#include <stddef.h>
+#include <string.h>
+
+
+typedef struct __pou_layout_s __pou_layout_t;
+
+typedef struct {
+  const char           *name;    /* name of the variable, SFC step or SFC action */
+  const char           *type;    /* name of its C datatype */
+  unsigned long         offset;  /* offset in the data structure */
+  unsigned long         size;
+  const __pou_layout_t *layout;  /* for instances of FBs with a layout descriptor, the FB's layout descriptor */
+} __pou_layout_var_t;
+
+struct __pou_layout_s {
+  const char               *name;     /* name of the FB or Program */
+  unsigned long             hash;     /* hash of the variables of the FB or Program, calculated by iec2c */
+  unsigned long             size;     /* size of the data structure */
+  unsigned long             nb_vars;
+  const __pou_layout_var_t *vars;
+};
+
+
+/* Entries of the layout descriptors, as generated by iec2c (__LAYOUT_POU is the name of the FB or Program) */
+#define __LAYOUT_ENTRY(name, type, element, layout) \
+  {name, type, offsetof(__LAYOUT_POU, element), sizeof(((__LAYOUT_POU *)0)->element), layout},
+#define __LAYOUT_VAR(type, name)  __LAYOUT_ENTRY(#name, #type,    name, NULL)
+#define __LAYOUT_FB(type, name)   __LAYOUT_ENTRY(#name, #type,    name, &type##_layout__)
+/* the step and action names are #defined by the generated code as the step's element of __step_list[], and the action's index */
+#define __LAYOUT_STEP(name)       __LAYOUT_ENTRY(#name, "STEP",   name, NULL)
+#define __LAYOUT_ACTION(name)     __LAYOUT_ENTRY(#name, "ACTION", __action_list[__SFC_##name], NULL)
+
+
+/* Copy the state of an instance of a FB or Program from <old_data>, laid out as described by
+ * <old_layout>, to the (already initialised) instance <new_data> laid out as described by
+ * <new_layout>. A variable is copied if <old_layout> has a variable with the same name and
+ * datatype (and size); instances of FBs with a layout descriptor are migrated recursively.
+ * Only the variables listed in the layout descriptors are copied, so that the pointers of the
+ * VAR_EXTERNAL, VAR_IN_OUT and located variables keep the values set by the _init__() function.
+ * Returns the number of variables that were not copied.
+ */
+static inline unsigned long __pou_migrate(void *new_data, const __pou_layout_t *new_layout,
+                                          const void *old_data, const __pou_layout_t *old_layout) {
+  unsigned long i, j, k = 0, not_copied = 0;
+  /* with the same layout, the variables are listed in the same order */
+  int same_layout = (   (new_layout->hash == old_layout->hash) && (new_layout->size == old_layout->size)
+                     && (new_layout->nb_vars == old_layout->nb_vars)
+                     && (strcmp(new_layout->name, old_layout->name) == 0));
+
+  for (i = 0; i < new_layout->nb_vars; i++) {
+    const __pou_layout_var_t *new_var = &new_layout->vars[i];
+    const __pou_layout_var_t *old_var = NULL;
+    if (same_layout) old_var = &old_layout->vars[i];
+    /* otherwise look for the variable starting after the previous one found, as the variables are
+     * usually still declared in the same order */
+    else for (j = 0; j < old_layout->nb_vars; j++, k = (k + 1) % old_layout->nb_vars) {
+      if (   (strcmp(old_layout->vars[k].name, new_var->name) == 0)
+          && (strcmp(old_layout->vars[k].type, new_var->type) == 0)) {
+        old_var = &old_layout->vars[k];
+        break;
+      }
+    }
+    if (old_var == NULL)
+      not_copied++;
+    else if ((new_var->layout != NULL) && (old_var->layout != NULL))
+      not_copied += __pou_migrate((char *)new_data + new_var->offset, new_var->layout,
+                                  (const char *)old_data + old_var->offset, old_var->layout);
+    else if (new_var->size == old_var->size)
+      memcpy((char *)new_data + new_var->offset, (const char *)old_data + old_var->offset, new_var->size);
+    else
+      not_copied++;
+  }
+  return not_copied;
+}
+
+#endif /* _IEC_ONLINE_CHANGE_H */
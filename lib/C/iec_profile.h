@@ -0,0 +1,117 @@
+/*
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Profiling: execution time of each POU and program instance
+ */
+
+/* When the 't' stage4 option is given (-O t), iec2c measures the execution time of the
+ * body of each FB and Program whose code is generated, and of each program instance of
+ * the configuration, and generates (in the configuration's C file, e.g. for
+ * configuration CONF):
+ *   unsigned long config_profile_snapshot__(__profile_entry_t *snapshot, unsigned long size);
+ *   void          config_profile_reset__(void);
+ *
+ * config_profile_snapshot__() copies (at most <size>) entries of the profiling table to
+ * <snapshot>, and returns the number of entries in the table. There is one entry per
+ * POU, named after the POU (e.g. "FB1"), followed by one entry per program instance,
+ * named after the instance (e.g. "CONF.RES1.INST1").
+ * config_profile_reset__() clears the table.
+ *
+ * Times are inclusive (i.e. they include the time spent in the Functions and FBs called
+ * by the POU), and are measured in the units of __PROFILE_NOW(): CPU timestamp counter
+ * cycles on x86 processors, nanoseconds otherwise. A runtime may use another clock by
+ * defining __PROFILE_NOW() before including the generated code.
+ * Invocations of Functions and FBs with EN = FALSE are not measured.
+ *
+ * Each measured invocation costs two readings of the clock and the update of one entry,
+ * which is negligible except for POUs that do very little work (note that some
+ * hypervisors trap the reading of the timestamp counter, making it much slower). This
+ * is why Functions are only measured when the 'f' stage4 option is given (-O f), which
+ * otherwise works as -O t.
+ *
+ * The table is updated without any locking, so when the resources run in separate threads,
+ * the entries of the POUs they share are approximate, and a snapshot taken while the PLC is
+ * running may mix values of consecutive invocations.
+ */
+
+#ifndef _IEC_PROFILE_H
+#define _IEC_PROFILE_H
+
+
+typedef unsigned long long __profile_ticks_t;
+
+typedef struct {
+  const char        *name;   /* name of the POU or of the program instance */
+  unsigned long long count;  /* number of invocations measured */
+  __profile_ticks_t  total;
+  __profile_ticks_t  min;    /* ~0 while count is 0 */
+  __profile_ticks_t  max;
+} __profile_entry_t;
+
+
+#ifndef __PROFILE_NOW
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define __PROFILE_NOW() ((__profile_ticks_t)__rdtsc())
+#else
+#include <time.h>
+static inline __profile_ticks_t __profile_now(void) {
+  struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return (__profile_ticks_t)ts.tv_sec * 1000000000ULL + (__profile_ticks_t)ts.tv_nsec;
+}
+#define __PROFILE_NOW() __profile_now()
+#endif
+#endif
+
+
+static inline void __profile_update(__profile_entry_t *entry, __profile_ticks_t start) {
+  __profile_ticks_t ticks = __PROFILE_NOW() - start;
+  entry->count++;
+  entry->total += ticks;
+  if (ticks < entry->min) entry->min = ticks;
+  if (ticks > entry->max) entry->max = ticks;
+}
+
+
+/* Used by the generated code (the entries are named after the POU or program instance) */
+#define __PROFILE_ENTRY(name)  {name, 0, 0, ~(__profile_ticks_t)0, 0}
+#define __PROFILE_BEGIN        __profile_ticks_t __profile_start = __PROFILE_NOW();
+#define __PROFILE_END(entry)   __profile_update(&(entry), __profile_start);
+
+
+static inline unsigned long __profile_snapshot(__profile_entry_t *const *table, unsigned long count,
+                                               __profile_entry_t *snapshot, unsigned long size) {
+  unsigned long i;
+  for (i = 0; (i < count) && (i < size); i++)
+    snapshot[i] = *table[i];
+  return count;
+}
+
+static inline void __profile_reset(__profile_entry_t *const *table, unsigned long count) {
+  unsigned long i;
+  for (i = 0; i < count; i++) {
+    table[i]->count = 0;
+    table[i]->total = 0;
+    table[i]->min   = ~(__profile_ticks_t)0;
+    table[i]->max   = 0;
+  }
+}
+
+#endif /* _IEC_PROFILE_H */
@@ -0,0 +1,303 @@
+/*
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Incremental persistence of RETAIN variables
+ */
+
+/* When the 'b' stage4 option is given (-O b), iec2c also generates the functions
+ *   void config_retain_backup__ (__retain_image_t *image);
+ *   void config_retain_restore__(__retain_image_t *image);
+ * which copy the RETAIN global variables of the configuration (and of its resources),
+ * and the RETAIN variables of the program instances (and of their FB instances), to/from
+ * a single contiguous retain image. A backup only copies the variables whose
+ * value changed since the previous backup, and marks the blocks of the image it wrote
+ * to as dirty. The retain image may then be flushed to a file, writing only the dirty
+ * blocks.
+ *
+ * A PLC runtime would use these as follows:
+ *   __retain_image_t image = __RETAIN_IMAGE_INIT;
+ *   __retain_file_t  file;
+ *   config_retain_backup__(&image);        // measure the image's size and layout
+ *   __retain_image_alloc(&image);
+ *   if (__retain_file_open(&file, "plc.retain", &image) > 0)
+ *     config_retain_restore__(&image);     // after config_init__()
+ *   ...
+ *   config_run__(tick);
+ *   config_retain_backup__(&image);
+ *   __retain_file_flush(&file, &image);
+ *
+ * The file holds two copies (slots) of the retain image, each with a checksum per block,
+ * and a sequence number. A flush writes to the slot not holding the most recent copy, so
+ * that an interrupted flush never leaves the file without a valid copy. The file also
+ * stores a hash of the image's layout (names and sizes of the variables), so that a file
+ * written by a different program is ignored.
+ */
+
+#ifndef _IEC_RETAIN_H
+#define _IEC_RETAIN_H
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Size of the blocks of the retain image that are tracked as dirty (a cache line) */
+#define __RETAIN_BLOCK_SIZE 64
+#define __RETAIN_BLOCKS(size) (((size) + __RETAIN_BLOCK_SIZE - 1) / __RETAIN_BLOCK_SIZE)
+
+#define __RETAIN_HASH_INIT  2166136261UL  /* FNV-1a */
+#define __RETAIN_HASH_PRIME 16777619UL
+
+typedef struct {
+  char          *data;    /* the retain image, NULL while its layout is being measured */
+  unsigned long  size;    /* size of the retain image, in bytes */
+  unsigned long  offset;  /* offset in the image of the next variable to copy */
+  unsigned long  hash;    /* hash of the image's layout */
+  unsigned char *dirty;   /* one bit per block of the image written since the last flush */
+} __retain_image_t;
+
+#define __RETAIN_IMAGE_INIT {NULL, 0, 0, __RETAIN_HASH_INIT, NULL}
+
+
+static inline unsigned long __retain_hash(unsigned long hash, const void *data, unsigned long size) {
+  const unsigned char *p = (const unsigned char *)data;
+  while (size-- > 0) hash = ((hash ^ *p++) * __RETAIN_HASH_PRIME) & 0xFFFFFFFFUL;
+  return hash;
+}
+
+static inline void __retain_mark_dirty(__retain_image_t *image, unsigned long offset, unsigned long size) {
+  unsigned long b;
+  for (b = offset / __RETAIN_BLOCK_SIZE; b <= (offset + size - 1) / __RETAIN_BLOCK_SIZE; b++)
+    image->dirty[b / 8] |= 1 << (b % 8);
+}
+
+/* Allocate the retain image, once its layout has been measured */
+static inline int __retain_image_alloc(__retain_image_t *image) {
+  image->size  = image->offset;
+  image->data  = (char *)calloc(image->size + 1, 1);
+  image->dirty = (unsigned char *)calloc(__RETAIN_BLOCKS(image->size) / 8 + 1, 1);
+  if ((image->data == NULL) || (image->dirty == NULL)) return -1;
+  /* the variables are copied in full on the first backup */
+  memset(image->dirty, 0xFF, __RETAIN_BLOCKS(image->size) / 8 + 1);
+  return 0;
+}
+
+
+/* Functions called by the generated code for each RETAIN variable */
+static inline void __retain_begin(__retain_image_t *image) {
+  image->offset = 0;
+  if (image->data == NULL) image->hash = __RETAIN_HASH_INIT;
+}
+
+static inline void __retain_backup(__retain_image_t *image, const char *name, void *varptr, unsigned long varsize) {
+  if (image->data == NULL) {
+    image->hash = __retain_hash(image->hash, name, strlen(name) + 1);
+    image->hash = __retain_hash(image->hash, &varsize, sizeof(varsize));
+  } else if ((image->offset + varsize <= image->size) && (memcmp(image->data + image->offset, varptr, varsize) != 0)) {
+    memcpy(image->data + image->offset, varptr, varsize);
+    __retain_mark_dirty(image, image->offset, varsize);
+  }
+  image->offset += varsize;
+}
+
+static inline void __retain_restore(__retain_image_t *image, const char *name, void *varptr, unsigned long varsize) {
+  if ((image->data != NULL) && (image->offset + varsize <= image->size))
+    memcpy(varptr, image->data + image->offset, varsize);
+  image->offset += varsize;
+}
+
+/* Used by the <POU>_retain__() function of each FB and Program, whose parameters are
+ * the instance (data__), the retain image (image), the direction of the copy (backup)
+ * and whether the instance itself is RETAIN (retain).
+ */
+#define __RETAIN_VAR(name, retained) do {\
+	if (retained) {\
+	  if (backup) __retain_backup (image, #name, &(name), sizeof(name));\
+	  else        __retain_restore(image, #name, &(name), sizeof(name));\
+	}\
+} while (0)
+
+
+
+#ifdef __unix__
+/**********************/
+/* The retain file    */
+/**********************/
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define __RETAIN_FILE_MAGIC 0x52434549UL  /* "IECR" */
+
+typedef struct {
+  unsigned long magic;
+  unsigned long hash;     /* layout hash of the retain image */
+  unsigned long size;     /* size of the retain image */
+} __retain_file_header_t;
+
+typedef struct {
+  unsigned long seq;      /* sequence number of the copy in this slot (0 if never written) */
+  unsigned long sum;      /* sum of the checksums of the blocks */
+} __retain_slot_header_t;
+
+typedef struct {
+  int            fd;
+  char          *map;
+  unsigned long  map_size;
+  unsigned long  blocks;
+  unsigned long  slot_size;
+  int            current;   /* slot holding the most recent copy of the image */
+  unsigned char *pending[2];/* blocks in which each slot differs from the retain image */
+} __retain_file_t;
+
+
+static inline __retain_slot_header_t *__retain_slot_header(__retain_file_t *file, int slot) {
+  return (__retain_slot_header_t *)(file->map + sizeof(__retain_file_header_t) + slot * file->slot_size);
+}
+static inline unsigned long *__retain_slot_sums(__retain_file_t *file, int slot) {
+  return (unsigned long *)(__retain_slot_header(file, slot) + 1);
+}
+static inline char *__retain_slot_data(__retain_file_t *file, int slot) {
+  return (char *)(__retain_slot_sums(file, slot) + file->blocks);
+}
+
+static inline unsigned long __retain_block_sum(__retain_file_t *file, int slot, unsigned long b, unsigned long size) {
+  unsigned long len = size - b * __RETAIN_BLOCK_SIZE;
+  if (len > __RETAIN_BLOCK_SIZE) len = __RETAIN_BLOCK_SIZE;
+  return __retain_hash(__RETAIN_HASH_INIT, __retain_slot_data(file, slot) + b * __RETAIN_BLOCK_SIZE, len);
+}
+
+/* Write <len> bytes at <addr> in the mapped file to disk */
+static inline void __retain_file_sync(__retain_file_t *file, void *addr, unsigned long len) {
+  unsigned long page  = (unsigned long)sysconf(_SC_PAGESIZE);
+  unsigned long start = ((unsigned long)addr - (unsigned long)file->map) / page * page;
+  msync(file->map + start, (unsigned long)addr - (unsigned long)file->map + len - start, MS_SYNC);
+}
+
+/* Is the copy of the retain image in <slot> complete and uncorrupted? */
+static inline int __retain_slot_valid(__retain_file_t *file, int slot, unsigned long size) {
+  unsigned long b, sum = 0;
+  if (__retain_slot_header(file, slot)->seq == 0) return 0;
+  for (b = 0; b < file->blocks; b++) {
+    if (__retain_slot_sums(file, slot)[b] != __retain_block_sum(file, slot, b, size)) return 0;
+    sum += __retain_slot_sums(file, slot)[b];
+  }
+  return (sum == __retain_slot_header(file, slot)->sum);
+}
+
+/* Open (or create) the retain file at <path> for the retain image <image>.
+ * Returns 1 if the retain image was loaded from the file (it may then be restored
+ * with config_retain_restore__()), 0 if the file holds no valid copy of the image, or
+ * -1 on error.
+ */
+static inline int __retain_file_open(__retain_file_t *file, const char *path, __retain_image_t *image) {
+  __retain_file_header_t *header;
+  unsigned long bitmap_size;
+  int valid[2], slot, loaded = 0;
+
+  file->blocks    = __RETAIN_BLOCKS(image->size);
+  file->slot_size = sizeof(__retain_slot_header_t) + file->blocks * (sizeof(unsigned long) + __RETAIN_BLOCK_SIZE);
+  file->map_size  = sizeof(__retain_file_header_t) + 2 * file->slot_size;
+  bitmap_size     = file->blocks / 8 + 1;
+  file->fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (file->fd < 0) return -1;
+  if (ftruncate(file->fd, file->map_size) != 0) {close(file->fd); return -1;}
+  file->map = (char *)mmap(NULL, file->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+  if (file->map == MAP_FAILED) {close(file->fd); return -1;}
+  file->pending[0] = (unsigned char *)malloc(bitmap_size);
+  file->pending[1] = (unsigned char *)malloc(bitmap_size);
+  if ((file->pending[0] == NULL) || (file->pending[1] == NULL)) {
+    free(file->pending[0]);
+    free(file->pending[1]);
+    munmap(file->map, file->map_size);
+    close(file->fd);
+    return -1;
+  }
+  memset(file->pending[0], 0xFF, bitmap_size);
+  memset(file->pending[1], 0xFF, bitmap_size);
+
+  header = (__retain_file_header_t *)file->map;
+  if ((header->magic == __RETAIN_FILE_MAGIC) && (header->hash == image->hash) && (header->size == image->size)) {
+    valid[0] = __retain_slot_valid(file, 0, image->size);
+    valid[1] = __retain_slot_valid(file, 1, image->size);
+    if (valid[0] || valid[1]) {
+      slot = (valid[0] && valid[1])? (__retain_slot_header(file, 1)->seq > __retain_slot_header(file, 0)->seq)
+                                   : valid[1];
+      memcpy(image->data, __retain_slot_data(file, slot), image->size);
+      memset(image->dirty, 0, bitmap_size);
+      memset(file->pending[slot], 0, bitmap_size);
+      file->current = slot;
+      loaded = 1;
+    }
+  }
+  if (!loaded) {
+    /* a new (or unusable) file */
+    memset(file->map, 0, file->map_size);
+    header->magic = __RETAIN_FILE_MAGIC;
+    header->hash  = image->hash;
+    header->size  = image->size;
+    __retain_file_sync(file, file->map, file->map_size);
+    file->current = 1;
+  }
+  return loaded;
+}
+
+/* Write the blocks of the retain image that changed since the last flush to the retain file */
+static inline void __retain_file_flush(__retain_file_t *file, __retain_image_t *image) {
+  int slot = 1 - file->current;
+  __retain_slot_header_t *header = __retain_slot_header(file, slot);
+  unsigned long *sums = __retain_slot_sums(file, slot);
+  char *data = __retain_slot_data(file, slot);
+  unsigned long i, b, sum = 0;
+  int changed = 0;
+
+  for (i = 0; i < file->blocks / 8 + 1; i++) {
+    if (image->dirty[i] == 0) continue;
+    file->pending[0][i] |= image->dirty[i];
+    file->pending[1][i] |= image->dirty[i];
+    image->dirty[i] = 0;
+    changed = 1;
+  }
+  if (!changed) return;
+
+  for (b = 0; b < file->blocks; b++) {
+    unsigned long len = image->size - b * __RETAIN_BLOCK_SIZE;
+    if (!(file->pending[slot][b / 8] & (1 << (b % 8)))) continue;
+    if (len > __RETAIN_BLOCK_SIZE) len = __RETAIN_BLOCK_SIZE;
+    memcpy(data + b * __RETAIN_BLOCK_SIZE, image->data + b * __RETAIN_BLOCK_SIZE, len);
+    sums[b] = __retain_block_sum(file, slot, b, image->size);
+  }
+  /* the total is recomputed, as a previous flush to this slot may have been interrupted */
+  for (b = 0; b < file->blocks; b++) sum += sums[b];
+  memset(file->pending[slot], 0, file->blocks / 8 + 1);
+  /* only the pages we wrote to are actually written to disk */
+  __retain_file_sync(file, sums, file->slot_size - sizeof(*header));
+
+  /* the copy in this slot only becomes valid once its header is written */
+  header->sum = sum;
+  header->seq = __retain_slot_header(file, file->current)->seq + 1;
+  __retain_file_sync(file, header, sizeof(*header));
+  file->current = slot;
+}
+
+static inline void __retain_file_close(__retain_file_t *file) {
+  munmap(file->map, file->map_size);
+  close(file->fd);
+  free(file->pending[0]);
+  free(file->pending[1]);
+}
+
+#endif /* __unix__ */
+
+#endif /* _IEC_RETAIN_H */
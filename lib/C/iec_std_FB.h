@@ -381,8 +381,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TP;
 
@@ -400,8 +402,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TON;
 
@@ -419,8 +423,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TOF;
 
@@ -1404,8 +1410,10 @@ static void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1422,21 +1430,40 @@ static void TP_body__(TP *data__) {
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,STATE,,1);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+      #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+      #undef GetFbVar
+      #undef SetFbVar
+;
     };
   };
   if (((__GET_VAR(data__->STATE,) == 2) && !(__GET_VAR(data__->IN,)))) {
@@ -1464,8 +1491,10 @@ static void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1482,26 +1511,45 @@ static void TON_body__(TON *data__) {
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,STATE,,1);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
   } else {
     if (!(__GET_VAR(data__->IN,))) {
       __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+      #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+      #undef GetFbVar
+      #undef SetFbVar
+;
+      __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+      if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
       } else {
-        __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+        #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+        #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+        #undef GetFbVar
+        #undef SetFbVar
+;
       };
     };
   };
@@ -1526,8 +1574,10 @@ static void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1544,23 +1594,42 @@ static void TOF_body__(TOF *data__) {
 
   #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
   #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
   #undef GetFbVar
   #undef SetFbVar
 ;
   if ((((__GET_VAR(data__->STATE,) == 0) && __GET_VAR(data__->PREV_IN,)) && !(__GET_VAR(data__->IN,)))) {
     __SET_VAR(data__->,STATE,,1);
-    __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+    __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
   } else {
     if (__GET_VAR(data__->IN,)) {
       __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+      #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+      #undef GetFbVar
+      #undef SetFbVar
+;
+      __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+      if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
       } else {
-        __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+        #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+        #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+        #undef GetFbVar
+        #undef SetFbVar
+;
       };
     };
   };
@@ -0,0 +1,239 @@
+/*
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Batch versions of IEC 61131-3 standard function blocks
+ */
+
+/* Each of these kernels executes <n> instances of a standard function block in a single
+ * call, with the same result as calling the function block's body on each instance
+ * (with EN = TRUE). Instead of an array of function block instances, each kernel takes
+ * one array per input, output and internal variable of the function block. BOOL
+ * variables are packed, 64 instances per LWORD (instance i being bit (i % 64) of
+ * word (i / 64)), so that the edge detection and bistable function blocks may handle
+ * 64 instances with a few bitwise operations.
+ *
+ * The arrays are passed as C pointers, so these kernels may be called from the C code
+ * in a pragma, e.g.
+ *   VAR CLK, Q, M : ARRAY [0..15] OF LWORD; END_VAR
+ *   {__R_TRIG_batch(1024, __GET_VAR(data__->CLK,.table), __GET_VAR(data__->Q,.table), __GET_VAR(data__->M,.table))}
+ * Note that the outputs are written directly, i.e. forcing them with the debugger
+ * has no effect.
+ *
+ * The internal variables (M, STATE, START_TICK, ...) must be initialised as the
+ * function block's initialisation would, i.e. set to 0 (FALSE).
+ */
+
+#ifndef _IEC_STD_FB_BATCH_H
+#define _IEC_STD_FB_BATCH_H
+
+
+/* Number of LWORDs holding <n> packed BOOLs */
+#define __BATCH_WORDS(n) (((n) + 63) / 64)
+#define __BATCH_BIT(i) ((LWORD)1 << ((i) & 63))
+
+
+/************************************/
+/* Edge detection and bistable FBs  */
+/************************************/
+
+/* R_TRIG:  Q := CLK AND NOT M;  M := CLK; */
+static inline void __R_TRIG_batch(UDINT n, const LWORD *CLK, LWORD *Q, LWORD *M) {
+  UDINT w;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    Q[w] = CLK[w] & ~M[w];
+    M[w] = CLK[w];
+  }
+}
+
+/* F_TRIG:  Q := NOT CLK AND NOT M;  M := NOT CLK; */
+static inline void __F_TRIG_batch(UDINT n, const LWORD *CLK, LWORD *Q, LWORD *M) {
+  UDINT w;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    Q[w] = ~CLK[w] & ~M[w];
+    M[w] = ~CLK[w];
+  }
+}
+
+/* SR:  Q1 := S1 OR ((NOT R) AND Q1); */
+static inline void __SR_batch(UDINT n, const LWORD *S1, const LWORD *R, LWORD *Q1) {
+  UDINT w;
+  for (w = 0; w < __BATCH_WORDS(n); w++)
+    Q1[w] = S1[w] | (~R[w] & Q1[w]);
+}
+
+/* RS:  Q1 := (NOT R1) AND (S OR Q1); */
+static inline void __RS_batch(UDINT n, const LWORD *S, const LWORD *R1, LWORD *Q1) {
+  UDINT w;
+  for (w = 0; w < __BATCH_WORDS(n); w++)
+    Q1[w] = ~R1[w] & (S[w] | Q1[w]);
+}
+
+
+/*****************/
+/* Counter FBs   */
+/*****************/
+
+/* CTU, with CU_T_M being the M variable of the CU_T (R_TRIG) instance */
+static inline void __CTU_batch(UDINT n, const LWORD *CU, const LWORD *R, const INT *PV,
+                               LWORD *Q, INT *CV, LWORD *CU_T_M) {
+  UDINT w, i;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    LWORD cu_q = CU[w] & ~CU_T_M[w];
+    LWORD q = 0;
+    CU_T_M[w] = CU[w];
+    for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {
+      if (R[w] & __BATCH_BIT(i))                      CV[i] = 0;
+      else if ((cu_q & __BATCH_BIT(i)) && (CV[i] < PV[i])) CV[i] = CV[i] + 1;
+      if (CV[i] >= PV[i]) q |= __BATCH_BIT(i);
+    }
+    Q[w] = q;
+  }
+}
+
+/* CTD, with CD_T_M being the M variable of the CD_T (R_TRIG) instance */
+static inline void __CTD_batch(UDINT n, const LWORD *CD, const LWORD *LD, const INT *PV,
+                               LWORD *Q, INT *CV, LWORD *CD_T_M) {
+  UDINT w, i;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    LWORD cd_q = CD[w] & ~CD_T_M[w];
+    LWORD q = 0;
+    CD_T_M[w] = CD[w];
+    for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {
+      if (LD[w] & __BATCH_BIT(i))                   CV[i] = PV[i];
+      else if ((cd_q & __BATCH_BIT(i)) && (CV[i] > 0)) CV[i] = CV[i] - 1;
+      if (CV[i] <= 0) q |= __BATCH_BIT(i);
+    }
+    Q[w] = q;
+  }
+}
+
+
+/*****************/
+/* Timer FBs     */
+/*****************/
+
+/* The timers share a single reading of the current time (see the tick conversion
+ * helpers in iec_std_lib.h). STATE is 0 (reset), 1 (counting) or 2 (set), as in timer.txt.
+ * Words of 64 timers that are all being reset (or, for TP, none of which is
+ * counting nor started) are handled as a whole.
+ */
+
+static inline void __TP_batch(UDINT n, const LWORD *IN, const TIME *PT, LWORD *Q, TIME *ET,
+                              LWORD *PREV_IN, SINT *STATE, LINT *START_TICK) {
+  static const TIME zero = {0, 0};
+  LINT now = __current_ticks();
+  UDINT w, i;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    LWORD q = Q[w];
+    if ((IN[w] == 0) && (PREV_IN[w] == 0) && (q == 0)) {
+      /* no timer counting, and no rising edge */
+      for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++)
+        if (STATE[i] == 2) {ET[i] = zero; STATE[i] = 0;}
+      continue;
+    }
+    for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {
+      BOOL in = ((IN[w] & __BATCH_BIT(i)) != 0);
+      if ((STATE[i] == 0) && !(PREV_IN[w] & __BATCH_BIT(i)) && in) {
+        STATE[i] = 1;
+        q |= __BATCH_BIT(i);
+        START_TICK[i] = now;
+      } else if (STATE[i] == 1) {
+        if (START_TICK[i] + __time_to_ticks(PT[i]) <= now) {
+          STATE[i] = 2;
+          q &= ~__BATCH_BIT(i);
+          ET[i] = PT[i];
+        } else
+          ET[i] = __ticks_to_time(now - START_TICK[i]);
+      }
+      if ((STATE[i] == 2) && !in) {ET[i] = zero; STATE[i] = 0;}
+    }
+    Q[w] = q;
+    PREV_IN[w] = IN[w];
+  }
+}
+
+static inline void __TON_batch(UDINT n, const LWORD *IN, const TIME *PT, LWORD *Q, TIME *ET,
+                               LWORD *PREV_IN, SINT *STATE, LINT *START_TICK) {
+  static const TIME zero = {0, 0};
+  LINT now = __current_ticks();
+  UDINT w, i;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    LWORD q = Q[w];
+    if (IN[w] == 0) {
+      /* every timer is (or is being) reset */
+      for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {ET[i] = zero; STATE[i] = 0;}
+      Q[w] = 0;
+      PREV_IN[w] = IN[w];
+      continue;
+    }
+    for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {
+      if ((STATE[i] == 0) && !(PREV_IN[w] & __BATCH_BIT(i)) && (IN[w] & __BATCH_BIT(i))) {
+        STATE[i] = 1;
+        q &= ~__BATCH_BIT(i);
+        START_TICK[i] = now;
+      } else if (!(IN[w] & __BATCH_BIT(i))) {
+        ET[i] = zero;
+        q &= ~__BATCH_BIT(i);
+        STATE[i] = 0;
+      } else if (STATE[i] == 1) {
+        if (START_TICK[i] + __time_to_ticks(PT[i]) <= now) {
+          STATE[i] = 2;
+          q |= __BATCH_BIT(i);
+          ET[i] = PT[i];
+        } else
+          ET[i] = __ticks_to_time(now - START_TICK[i]);
+      }
+    }
+    Q[w] = q;
+    PREV_IN[w] = IN[w];
+  }
+}
+
+static inline void __TOF_batch(UDINT n, const LWORD *IN, const TIME *PT, LWORD *Q, TIME *ET,
+                               LWORD *PREV_IN, SINT *STATE, LINT *START_TICK) {
+  static const TIME zero = {0, 0};
+  LINT now = __current_ticks();
+  UDINT w, i;
+  for (w = 0; w < __BATCH_WORDS(n); w++) {
+    LWORD q = IN[w];
+    if (IN[w] == ~(LWORD)0) {
+      /* every timer is (or is being) reset */
+      for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {ET[i] = zero; STATE[i] = 0;}
+      Q[w] = q;
+      PREV_IN[w] = IN[w];
+      continue;
+    }
+    for (i = w * 64; (i < n) && (i < (w + 1) * 64); i++) {
+      if ((STATE[i] == 0) && (PREV_IN[w] & __BATCH_BIT(i)) && !(IN[w] & __BATCH_BIT(i))) {
+        STATE[i] = 1;
+        START_TICK[i] = now;
+      } else if (IN[w] & __BATCH_BIT(i)) {
+        ET[i] = zero;
+        STATE[i] = 0;
+      } else if (STATE[i] == 1) {
+        if (START_TICK[i] + __time_to_ticks(PT[i]) <= now) {
+          STATE[i] = 2;
+          ET[i] = PT[i];
+        } else
+          ET[i] = __ticks_to_time(now - START_TICK[i]);
+      }
+      if (STATE[i] == 1) q |= __BATCH_BIT(i);
+    }
+    Q[w] = q;
+    PREV_IN[w] = IN[w];
+  }
+}
+
+#endif /* _IEC_STD_FB_BATCH_H */
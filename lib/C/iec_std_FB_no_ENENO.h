@@ -340,8 +340,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TP;
 
@@ -357,8 +359,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TON;
 
@@ -374,8 +378,10 @@ typedef struct {
   // FB private variables - TEMP, private and located variables
   __DECLARE_VAR(SINT,STATE)
   __DECLARE_VAR(BOOL,PREV_IN)
-  __DECLARE_VAR(TIME,CURRENT_TIME)
-  __DECLARE_VAR(TIME,START_TIME)
+  __DECLARE_VAR(LINT,CURRENT_TICK)
+  __DECLARE_VAR(LINT,START_TICK)
+  __DECLARE_VAR(LINT,DEADLINE)
+  __DECLARE_VAR(TIME,DEADLINE_PT)
 
 } TOF;
 
@@ -1147,8 +1153,10 @@ static void TP_init__(TP *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1157,21 +1165,40 @@ static void TP_body__(TP *data__) {
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
   __SET_VAR(data__->,STATE,,1);
   __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+  __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+  #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+  #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+  #undef GetFbVar
+  #undef SetFbVar
+;
 } else if ((__GET_VAR(data__->STATE,) == 1)) {
-  if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+  #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+  #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+  #undef GetFbVar
+  #undef SetFbVar
+;
+  __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+  if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
     __SET_VAR(data__->,STATE,,2);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
   } else {
-    __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
   };
 };
 if (((__GET_VAR(data__->STATE,) == 2) && !(__GET_VAR(data__->IN,)))) {
@@ -1197,8 +1224,10 @@ static void TON_init__(TON *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1207,26 +1236,45 @@ static void TON_body__(TON *data__) {
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __GET_VAR(data__->IN,))) {
   __SET_VAR(data__->,STATE,,1);
   __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+  __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+  #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+  #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+  #undef GetFbVar
+  #undef SetFbVar
+;
 } else {
   if (!(__GET_VAR(data__->IN,))) {
     __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+      #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+      #undef GetFbVar
+      #undef SetFbVar
+;
     };
   };
 };
@@ -1249,8 +1297,10 @@ static void TOF_init__(TOF *data__, BOOL retain) {
   __INIT_VAR(data__->ET,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
   __INIT_VAR(data__->STATE,0,retain)
   __INIT_VAR(data__->PREV_IN,__BOOL_LITERAL(FALSE),retain)
-  __INIT_VAR(data__->CURRENT_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
-  __INIT_VAR(data__->START_TIME,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
+  __INIT_VAR(data__->CURRENT_TICK,0,retain)
+  __INIT_VAR(data__->START_TICK,0,retain)
+  __INIT_VAR(data__->DEADLINE,0,retain)
+  __INIT_VAR(data__->DEADLINE_PT,__time_to_timespec(1, 0, 0, 0, 0, 0),retain)
 }
 
 // Code part
@@ -1259,23 +1309,42 @@ static void TOF_body__(TOF *data__) {
 
 #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
 #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
-__SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
+__SET_VAR(data__->,CURRENT_TICK,,__current_ticks())
 #undef GetFbVar
 #undef SetFbVar
 ;
 if ((((__GET_VAR(data__->STATE,) == 0) && __GET_VAR(data__->PREV_IN,)) && !(__GET_VAR(data__->IN,)))) {
   __SET_VAR(data__->,STATE,,1);
-  __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
+  __SET_VAR(data__->,START_TICK,,__GET_VAR(data__->CURRENT_TICK,));
+  __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+  #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+  #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+  #undef GetFbVar
+  #undef SetFbVar
+;
 } else {
   if (__GET_VAR(data__->IN,)) {
     __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+    #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+if (__time_cmp(__GET_VAR(data__->PT,), __GET_VAR(data__->DEADLINE_PT,)) != 0) __SET_VAR(data__->,DEADLINE,,__GET_VAR(data__->START_TICK,) + __time_to_ticks(__GET_VAR(data__->PT,)))
+    #undef GetFbVar
+    #undef SetFbVar
+;
+    __SET_VAR(data__->,DEADLINE_PT,,__GET_VAR(data__->PT,));
+    if ((__GET_VAR(data__->DEADLINE,) <= __GET_VAR(data__->CURRENT_TICK,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
-      __SET_VAR(data__->,ET,,__time_sub(__GET_VAR(data__->CURRENT_TIME,), __GET_VAR(data__->START_TIME,)));
+      #define GetFbVar(var,...) __GET_VAR(data__->var,__VA_ARGS__)
+      #define SetFbVar(var,val,...) __SET_VAR(data__->,var,__VA_ARGS__,val)
+__SET_VAR(data__->,ET,,__ticks_to_time(__GET_VAR(data__->CURRENT_TICK,) - __GET_VAR(data__->START_TICK,)))
+      #undef GetFbVar
+      #undef SetFbVar
+;
     };
   };
 };
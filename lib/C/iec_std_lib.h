@@ -111,34 +111,6 @@ typedef struct {
 #define __LWORD_LITERAL(value) __literal(LWORD,value,__64b_sufix)
 
 
-typedef union __IL_DEFVAR_T {
-    BOOL    BOOLvar;
-
-    SINT    SINTvar;
-    INT     INTvar;
-    DINT    DINTvar;
-    LINT    LINTvar;
-
-    USINT   USINTvar;
-    UINT    UINTvar;
-    UDINT   UDINTvar;
-    ULINT   ULINTvar;
-
-    BYTE    BYTEvar;
-    WORD    WORDvar;
-    DWORD   DWORDvar;
-    LWORD   LWORDvar;
-
-    REAL    REALvar;
-    LREAL   LREALvar;
-
-    TIME    TIMEvar;
-    TOD TODvar;
-    DT  DTvar;
-    DATE    DATEvar;
-} __IL_DEFVAR_T;
-
-
 /**********************************************************************/
 /**********************************************************************/
 /*****                                                            *****/
@@ -399,6 +371,23 @@ static inline TIME __time_div(TIME IN1, LREAL IN2){
   return res;
 }
 
+/* Tick conversion helpers, used by the TP, TON and TOF standard function blocks.
+ * The timers keep time as a count of nanoseconds (ticks), so that a running timer
+ * only compares the current tick against the deadline calculated when it started
+ * (or when its PT changed), instead of adding and comparing TIME values on every call.
+ */
+static inline LINT __time_to_ticks(TIME IN){
+  return (LINT)IN.tv_sec * 1000000000 + IN.tv_nsec;
+}
+static inline TIME __ticks_to_time(LINT IN){
+  TIME res = {(long)(IN / 1000000000), (long)(IN % 1000000000)};
+  return res;
+}
+/* __CURRENT_TIME, in ticks */
+static inline LINT __current_ticks(void){
+  return __time_to_ticks(__CURRENT_TIME);
+}
+
 
 /***************/
 /* Convertions */
@@ -753,4 +742,6 @@ __ANY(__move_)
   #include "iec_std_FB.h"
 #endif
 
+#include "iec_std_FB_batch.h"
+
 #endif /* _IEC_STD_LIB_H */
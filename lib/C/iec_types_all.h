@@ -138,6 +138,11 @@ typedef struct {
   __IEC_TIME_t T;  // elapsed_time;  --> time since step is active.   We name it 'T' as it may be accessed from IEC 61131.3 code using stepname.T syntax!!
 } STEP;
 
+/* step whose elapsed time is never read (used instead of STEP when the SFC state is packed, i.e. iec2c -O k) */
+typedef struct {
+  __IEC_BOOL_t X;  // state;  --> current step state. 0 : inative, 1: active.   We name it 'X' as it may be accessed from IEC 61131.3 code using stepname.X syntax!!
+} UNTIMED_STEP;
+
 
 typedef struct {
   BOOL stored;  // action storing state. 0 : not stored, 1: stored
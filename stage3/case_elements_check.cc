@@ -44,6 +44,8 @@
 
 
 #include "case_elements_check.hh"
+#include <algorithm>  /* required for std::sort() */
+#include <strings.h>  /* required for strcasecmp() */
 
 
 #define FIRST_(symbol1, symbol2) (((symbol1)->first_order < (symbol2)->first_order)   ? (symbol1) : (symbol2))
@@ -97,81 +99,91 @@ int case_elements_check_c::get_error_count() {
 
 
 
-/* compare two integer constants, and determins if s1 < s2 */
-static bool less_than(symbol_c *s1, symbol_c *s2) {
-  if (   (VALID_CVALUE( int64, s1))
-      && (VALID_CVALUE( int64, s2))
-      && (  GET_CVALUE( int64, s1) < GET_CVALUE( int64, s2)))
-    return true;
-  
-  if (   (VALID_CVALUE(uint64, s1))
-      && (VALID_CVALUE(uint64, s2))
-      && (  GET_CVALUE(uint64, s1) < GET_CVALUE(uint64, s2)))
+/* The value of a CASE element (or of a limit of a subrange in a CASE element), as determined by constant folding.
+ * Both signed and unsigned values are placed on a single ordered line, so that we may compare 
+ * the values of elements with different datatypes (e.g. -5 and 16#FFFFFFFFFFFFFFFF).
+ */
+typedef struct {
+  bool     negative;
+  uint64_t value;   /* for negative values, this is the two's complement value, which keeps the ordering among the negative values! */
+} case_value_t;
+
+static bool get_case_value(symbol_c *symbol, case_value_t &case_value) {
+  if (VALID_CVALUE( int64, symbol)) {
+    case_value.negative = (GET_CVALUE(int64, symbol) < 0);
+    case_value.value    = (uint64_t)GET_CVALUE(int64, symbol);
     return true;
-  
-  if (   (VALID_CVALUE( int64, s1))
-      && (VALID_CVALUE(uint64, s2))
-      && (  GET_CVALUE( int64, s1) < 0))
+  }
+  if (VALID_CVALUE(uint64, symbol)) {
+    case_value.negative = false;
+    case_value.value    = GET_CVALUE(uint64, symbol);
     return true;
-  
+  }
   return false;
 }
 
+/* compare two CASE element values, and determine if v1 < v2 */
+static bool less_than(const case_value_t &v1, const case_value_t &v2) {
+  if (v1.negative != v2.negative)  return v1.negative;
+  return (v1.value < v2.value);
+}
 
 
-void case_elements_check_c::check_subr_subr(symbol_c *s1, symbol_c *s2) {
-  subrange_c *sub1 = dynamic_cast<subrange_c *>(s1);
-  subrange_c *sub2 = dynamic_cast<subrange_c *>(s2);
-  
-  if ((NULL == sub1) || (NULL == sub2)) return;
-  symbol_c *l1 = sub1->lower_limit;
-  symbol_c *u1 = sub1->upper_limit;
-  symbol_c *l2 = sub2->lower_limit;
-  symbol_c *u2 = sub2->upper_limit;
-  
-  if (less_than(u1, l2))  return; // no overlap!
-  if (less_than(u2, l1))  return; // no overlap!
-
-  if (   (VALID_CVALUE( int64, l1) || (VALID_CVALUE(uint64, l1)))
-      && (VALID_CVALUE( int64, l2) || (VALID_CVALUE(uint64, l2)))
-      && (VALID_CVALUE( int64, u1) || (VALID_CVALUE(uint64, u1)))
-      && (VALID_CVALUE( int64, u2) || (VALID_CVALUE(uint64, u2))))
-    STAGE3_WARNING(s1, s2, "Elements in CASE options have overlapping ranges.");
+
+/* A CASE element whose value(s) are known at compile time, handled as the closed interval [lower, upper].
+ * A single value (e.g. '5:') is handled as the interval [5, 5].
+ */
+typedef struct {
+  case_value_t lower;
+  case_value_t upper;
+  symbol_c    *element;
+} case_interval_t;
+
+static bool get_case_interval(symbol_c *element, case_interval_t &interval) {
+  interval.element = element;
+  subrange_c *subr = dynamic_cast<subrange_c *>(element);
+  if (NULL == subr)
+    return get_case_value(element, interval.lower) && get_case_value(element, interval.upper);
+  return get_case_value(subr->lower_limit, interval.lower) && get_case_value(subr->upper_limit, interval.upper);
 }
 
+/* Sort by lower value. Elements with the same lower value are kept in the order they appear in the source code. */
+static bool interval_lower_than(const case_interval_t &i1, const case_interval_t &i2) {
+  if (less_than(i1.lower, i2.lower))  return true;
+  if (less_than(i2.lower, i1.lower))  return false;
+  return (i1.element->first_order < i2.element->first_order);
+}
+
+/* The identifier of a CASE element that is an enumerated value (e.g. 'RED', or 'COLOUR#RED'), or NULL.
+ * All the enumerated values in a CASE have the datatype of the CASE expression, so the optional
+ * datatype name is ignored.
+ */
+static token_c *get_case_identifier(symbol_c *element) {
+  enumerated_value_c *enumerated_value = dynamic_cast<enumerated_value_c *>(element);
+  if (NULL != enumerated_value)  return dynamic_cast<token_c *>(enumerated_value->value);
+  return dynamic_cast<token_c *>(element);
+}
 
+/* Sort by (case insensitive) name. Elements with the same name are kept in the order they appear in the source code. */
+static bool identifier_lower_than(symbol_c *s1, symbol_c *s2) {
+  int cmp = strcasecmp(get_case_identifier(s1)->value, get_case_identifier(s2)->value);
+  if (cmp != 0)  return (cmp < 0);
+  return (s1->first_order < s2->first_order);
+}
 
 
-void case_elements_check_c::check_subr_symb(symbol_c *s1, symbol_c *s2) {
-  subrange_c *subr = NULL;
-  symbol_c   *symb = NULL;
-  if ((subr = dynamic_cast<subrange_c *>(s1)) != NULL) {symb = s2;}
-  if ((subr = dynamic_cast<subrange_c *>(s2)) != NULL) {symb = s1;}
-  
-  if ((NULL == subr) || (NULL == symb)) return;
-  symbol_c   *lowl = subr->lower_limit;
-  symbol_c   *uppl = subr->upper_limit;
+
+
+void case_elements_check_c::check_overlap(symbol_c *s1, symbol_c *s2) {
+  bool is_subr1 = (dynamic_cast<subrange_c *>(s1) != NULL);
+  bool is_subr2 = (dynamic_cast<subrange_c *>(s2) != NULL);
   
-  if (   (VALID_CVALUE(int64, symb))
-      && (VALID_CVALUE(int64, lowl))
-      && (VALID_CVALUE(int64, uppl))
-      && (  GET_CVALUE(int64, symb) >= GET_CVALUE(int64, lowl))
-      && (  GET_CVALUE(int64, symb) <= GET_CVALUE(int64, uppl)))
-    {STAGE3_WARNING(s1, s2, "Element in CASE option falls within range of another element."); return;}
-    
-  if (   (VALID_CVALUE(uint64, symb))
-      && (VALID_CVALUE( int64, lowl))
-      && (VALID_CVALUE(uint64, uppl))
-      && (  GET_CVALUE( int64, lowl) < 0)
-      && (  GET_CVALUE(uint64, symb) <= GET_CVALUE(uint64, uppl)))
-    {STAGE3_WARNING(s1, s2, "Element in CASE option falls within range of another element."); return;}
-
-  if (   (VALID_CVALUE(uint64, symb))
-      && (VALID_CVALUE(uint64, lowl))
-      && (VALID_CVALUE(uint64, uppl))
-      && (  GET_CVALUE(uint64, symb) >= GET_CVALUE(uint64, lowl))
-      && (  GET_CVALUE(uint64, symb) <= GET_CVALUE(uint64, uppl)))
-    {STAGE3_WARNING(s1, s2, "Element in CASE option falls within range of another element."); return;}
+  if (is_subr1 && is_subr2)
+    STAGE3_WARNING(s1, s2, "Elements in CASE options have overlapping ranges.")
+  else if (is_subr1 || is_subr2)
+    STAGE3_WARNING(s1, s2, "Element in CASE option falls within range of another element.")
+  else
+    STAGE3_WARNING(s1, s2, "Duplicate element found in CASE options.")
 }
 
 
@@ -213,19 +225,48 @@ void *case_elements_check_c::visit(case_statement_c *symbol) {
   case_elements_list.clear();
   symbol->case_element_list->accept(*this); // will fill up the case_elements_list with all the elements in the case!
   
-  // OK, now check whether we have any overlappings...
-  std::vector<symbol_c *>::iterator s1 = case_elements_list.begin();
-  for (  ; s1 != case_elements_list.end(); s1++) {
-    std::vector<symbol_c *>::iterator s2 = s1;
-    s2++; // do not compare the value with itself!
-    for (; s2 != case_elements_list.end(); s2++) {
-      // Check for overlapping elements
-      check_subr_subr(*s1, *s2);
-      check_subr_symb(*s1, *s2);
-      check_symb_symb(*s2, *s1);
-    }
+  /* CASE statements may have thousands of elements (e.g. in generated code), so we do not compare every element
+   * against every other element. Instead, we split the elements into:
+   *   - elements whose value (or subrange limits) are known integer constants. These are handled as intervals.
+   *   - elements that are identifiers (e.g. enumerated values), with no known constant value.
+   *   - anything else (should be rare).
+   */
+  std::vector<case_interval_t> intervals;
+  std::vector<symbol_c *>      identifiers;
+  std::vector<symbol_c *>      others;
+  for (unsigned int i = 0; i < case_elements_list.size(); i++) {
+    case_interval_t interval;
+    symbol_c *element = case_elements_list[i];
+    if      (get_case_interval(element, interval))
+      intervals.push_back(interval);
+    else if (!element->const_value.is_const() && (get_case_identifier(element) != NULL))
+      identifiers.push_back(element);
+    else
+      others.push_back(element);
+  }
+  
+  /* Sort the intervals by their lower value. An interval overlaps a previous interval iff it starts before
+   * the highest upper value of all the previous intervals.
+   */
+  std::sort(intervals.begin(), intervals.end(), interval_lower_than);
+  for (unsigned int i = 1, widest = 0; i < intervals.size(); i++) {
+    if (!less_than(intervals[widest].upper, intervals[i].lower))
+      check_overlap(intervals[widest].element, intervals[i].element);
+    if (less_than(intervals[widest].upper, intervals[i].upper))
+      widest = i;
   }
   
+  /* Sort the identifiers by name. Duplicate identifiers will end up next to each other. */
+  std::sort(identifiers.begin(), identifiers.end(), identifier_lower_than);
+  for (unsigned int i = 1; i < identifiers.size(); i++)
+    if (compare_identifiers(get_case_identifier(identifiers[i]), get_case_identifier(identifiers[i-1])) == 0)
+      check_overlap(identifiers[i], identifiers[i-1]);
+  
+  /* Whatever is left must be compared one by one. */
+  for (unsigned int i = 0; i < others.size(); i++)
+    for (unsigned int j = i+1; j < others.size(); j++)
+      check_symb_symb(others[j], others[i]);
+  
   case_elements_list = case_elements_list_local;
   return NULL;
 }
@@ -54,8 +54,7 @@ class case_elements_check_c: public iterator_visitor_c {
     int current_display_error_level;
 
     std::vector<symbol_c *> case_elements_list;
-    void check_subr_subr(symbol_c *s1, symbol_c *s2);
-    void check_subr_symb(symbol_c *s1, symbol_c *s2);
+    void check_overlap  (symbol_c *s1, symbol_c *s2);
     void check_symb_symb(symbol_c *s1, symbol_c *s2);
   
 
@@ -1240,8 +1240,10 @@ constant_propagation_c::constant_propagation_c(symbol_c *symbol)
     current_resource = NULL;
     current_configuration = NULL;
     fixed_init_value_ = false;
+    constant_var_ = false;
     function_pou_ = false;
     values = NULL;
+    constant_values = NULL;
   }
 
 
@@ -1395,6 +1397,17 @@ void *constant_propagation_c::visit(symbolic_variable_c *symbol) {
 		symbol->const_value = (*values)[varName];
 	return NULL;
 }
+#else
+/* Even without constant propagation, references to variables declared CONSTANT always have the initial
+ * value of that variable, so we may safely use it (stage 4 will then emit it as a literal).
+ */
+void *constant_propagation_c::visit(symbolic_variable_c *symbol) {
+	if (NULL == constant_values) return NULL;
+	std::string varName = get_var_name_c::get_name(symbol->var_name)->value;
+	if (constant_values->count(varName) > 0) 
+		symbol->const_value = (*constant_values)[varName];
+	return NULL;
+}
 #endif  // DO_CONSTANT_PROPAGATION__
 
 void *constant_propagation_c::visit(symbolic_constant_c *symbol) {
@@ -1409,10 +1422,12 @@ void *constant_propagation_c::visit(symbolic_constant_c *symbol) {
 /* B 1.4.3 - Declaration & Initialisation */
 /******************************************/
   
-void *constant_propagation_c::handle_var_decl(symbol_c *var_list, bool fixed_init_value) {
+void *constant_propagation_c::handle_var_decl(symbol_c *var_list, bool fixed_init_value, bool constant_var) {
   fixed_init_value_ = fixed_init_value;
+  constant_var_     = constant_var;
   var_list->accept(*this); 
   fixed_init_value_ = false; 
+  constant_var_     = false;
   return NULL;
 }
 
@@ -1480,6 +1495,8 @@ void *constant_propagation_c::handle_var_list_decl(symbol_c *var_list, symbol_c
         // Notice that global variables are also placed in the values map!!
         var_global_values[var_name->value] = init_value->const_value;
     }
+    if (constant_var_ && (NULL != constant_values))
+      (*constant_values)[var_name->value] = init_value->const_value;
   }
   return NULL;
 }
@@ -1561,7 +1578,7 @@ void *constant_propagation_c::visit(input_output_declarations_c *symbol) {return
 /* VAR [CONSTANT] var_init_decl_list END_VAR */
 /* option -> may be NULL ! */
 //SYM_REF2(var_declarations_c, option, var_init_decl_list)
-void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, false);}
+void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, false, is_constant(symbol->option));}
 
 /*  VAR RETAIN var_init_decl_list END_VAR */
 //SYM_REF1(retentive_var_declarations_c, var_init_decl_list)             // Not needed since we inherit from iterator_visitor_c!
@@ -1585,7 +1602,7 @@ SYM_REF3(located_var_decl_c, variable_name, location, located_var_spec_init)
 /*| VAR_EXTERNAL [CONSTANT] external_declaration_list END_VAR */
 /* option -> may be NULL ! */
 // SYM_REF2(external_var_declarations_c, option, external_declaration_list)
-void *constant_propagation_c::visit(external_var_declarations_c *symbol) {return handle_var_decl(symbol->external_declaration_list, is_constant(symbol->option));}
+void *constant_propagation_c::visit(external_var_declarations_c *symbol) {return handle_var_decl(symbol->external_declaration_list, is_constant(symbol->option), is_constant(symbol->option));}
 
 /* helper symbol for external_var_declarations */
 /*| external_declaration_list external_declaration';' */
@@ -1628,6 +1645,8 @@ void *constant_propagation_c::visit(external_declaration_c *symbol) {
 //  (*values)[symbol->global_var_name->get_value()] = symbol->specification->const_value;
     (*values)[get_var_name_c::get_name(symbol->global_var_name)->value] = symbol->specification->const_value;
   }
+  if (constant_var_ && (NULL != constant_values))
+    (*constant_values)[get_var_name_c::get_name(symbol->global_var_name)->value] = symbol->specification->const_value;
   // If the datatype specification is a subrange or array, do constant folding of all the literals in that type declaration... (ex: literals in array subrange limits)
   symbol->specification->accept(*this);  // should never get to change the const_value of the symbol->specification symbol (only its children!).
   return NULL;
@@ -1656,7 +1675,7 @@ void *constant_propagation_c::visit(external_declaration_c *symbol) {
  * Nevertheless, since constant folding is idem-potent, it is simpler to just call handle_var_decl() instead
  * of writing some code specific for this situation!
  */
-void *constant_propagation_c::visit(global_var_declarations_c *symbol) {return handle_var_decl(symbol->global_var_decl_list, is_constant(symbol->option));}
+void *constant_propagation_c::visit(global_var_declarations_c *symbol) {return handle_var_decl(symbol->global_var_decl_list, is_constant(symbol->option), is_constant(symbol->option));}
 
 
 /* helper symbol for global_var_declarations */
@@ -1740,8 +1759,11 @@ SYM_LIST(var_init_decl_list_c)
 //SYM_REF4(function_declaration_c, derived_function_name, type_name, var_declarations_list, function_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(function_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever called this Function (a program, configuration, or resource)
 	values = &local_values;
+	prev_pou_constant_values = constant_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope - Not really needed, but do it just to be consistent. */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1752,6 +1774,7 @@ void *constant_propagation_c::visit(function_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -1766,7 +1789,7 @@ void *constant_propagation_c::visit(function_declaration_c *symbol) {
 /* option -> storage method, CONSTANT or <null> */
 // SYM_REF2(function_var_decls_c, option, decl_list)
 // NOTE: function_var_decls_c is only used inside Functions, so it is safe to call with fixed_init_value_ = true 
-void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle_var_decl(symbol->decl_list, true);}
+void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle_var_decl(symbol->decl_list, true, is_constant(symbol->option));}
 
 /* intermediate helper symbol for function_var_decls */
 // SYM_LIST(var2_init_decl_list_c) // Not needed since we inherit from iterator_c
@@ -1780,8 +1803,11 @@ void *constant_propagation_c::visit(function_var_decls_c *symbol) {return handle
 //SYM_REF3(function_block_declaration_c, fblock_name, var_declarations, fblock_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(function_block_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever instantited this FB (a program, configuration, or resource)
 	values = &local_values;
+	prev_pou_constant_values = constant_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1791,6 +1817,7 @@ void *constant_propagation_c::visit(function_block_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -1814,8 +1841,11 @@ void *constant_propagation_c::visit(non_retentive_var_decls_c *symbol) {return h
 //SYM_REF3(program_declaration_c, program_type_name, var_declarations, function_block_body, enumvalue_symtable_t enumvalue_symtable;)
 void *constant_propagation_c::visit(program_declaration_c *symbol) {
 	map_values_t local_values, *prev_pou_values;
+	map_values_t local_constant_values, *prev_pou_constant_values;
 	prev_pou_values = values; // store the current values map of whoever instantited this Program (a configuration, or resource)
 	values = &local_values;
+	prev_pou_constant_values = constant_values;
+	constant_values = &local_constant_values;
 	var_global_values.push(); /* Create inner scope */
 
 	/* Add initial value of all declared variables into Values map. */
@@ -1825,6 +1855,7 @@ void *constant_propagation_c::visit(program_declaration_c *symbol) {
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
+	constant_values = prev_pou_constant_values;
 	return NULL;
 }
 
@@ -2112,3 +2143,83 @@ void *constant_propagation_c::visit(repeat_statement_c *symbol) {
 
 
 
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***     Re-fold REAL expressions, now that datatypes are known     ***/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+real_constant_folding_c::real_constant_folding_c(symbol_c *symbol) {}
+real_constant_folding_c::~real_constant_folding_c(void) {}
+
+
+/* REAL and SAFEREAL are stored in C as a float (LREAL and SAFELREAL as a double) */
+static bool is_single_precision(symbol_c *datatype) {
+	if (NULL == datatype) return false;
+	symbol_c *base_type = search_base_type_c::get_basetype_decl(datatype);
+	return (   (NULL != dynamic_cast<    real_type_name_c *>(base_type))
+	        || (NULL != dynamic_cast<safereal_type_name_c *>(base_type)));
+}
+
+
+static void *round_to_single_precision(symbol_c *symbol) {
+	if (!is_single_precision(symbol->datatype)) return NULL;
+	if (!VALID_CVALUE(real64, symbol))          return NULL;
+	real64_t value = GET_CVALUE(real64, symbol);
+	if ((value > REAL32_MAX) || (value < -REAL32_MAX)) {SET_OVFLOW(real64, symbol); return NULL;}
+	SET_CVALUE(real64, symbol, (real64_t)(float)value);
+	CHECK_OVERFLOW_real64(symbol);
+	return NULL;
+}
+
+
+/******************************/
+/* B 1.2.1 - Numeric Literals */
+/******************************/
+void *real_constant_folding_c::visit(real_c         *symbol) {return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(neg_real_c     *symbol) {return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(real_literal_c *symbol) {return round_to_single_precision(symbol);}
+
+
+/*********************/
+/* B 1.4 - Variables */
+/*********************/
+void *real_constant_folding_c::visit(symbolic_variable_c *symbol) {
+	if (is_single_precision(symbol->datatype) && VALID_CVALUE(real64, symbol)) SET_NONCONST(real64, symbol);
+	return NULL;
+}
+
+
+/***********************/
+/* B 3.1 - Expressions */
+/***********************/
+/* NOTE: the BOOL and ANY_BIT expressions are also folded again, as their operands may be comparisons of REAL values */
+void *real_constant_folding_c::visit(    or_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); return handle_or (symbol, symbol->l_exp, symbol->r_exp);}
+void *real_constant_folding_c::visit(   xor_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); return handle_xor(symbol, symbol->l_exp, symbol->r_exp);}
+void *real_constant_folding_c::visit(   and_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); return handle_and(symbol, symbol->l_exp, symbol->r_exp);}
+
+void *real_constant_folding_c::visit(   equ_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, ==);}
+void *real_constant_folding_c::visit(notequ_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, !=);}
+void *real_constant_folding_c::visit(    lt_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, < );}
+void *real_constant_folding_c::visit(    gt_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, > );}
+void *real_constant_folding_c::visit(    le_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, <=);}
+void *real_constant_folding_c::visit(    ge_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this);        handle_cmp (symbol, symbol->l_exp, symbol->r_exp, >=);}
+
+void *real_constant_folding_c::visit(   add_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); handle_add(symbol, symbol->l_exp, symbol->r_exp); return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(   sub_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); handle_sub(symbol, symbol->l_exp, symbol->r_exp); return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(   mul_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); handle_mul(symbol, symbol->l_exp, symbol->r_exp); return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(   div_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); handle_div(symbol, symbol->l_exp, symbol->r_exp); return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(   mod_expression_c *symbol) {symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); return handle_mod(symbol, symbol->l_exp, symbol->r_exp);}
+/* The generated C code calls the EXPT() standard function, whose single precision result we can not reproduce here. */
+void *real_constant_folding_c::visit( power_expression_c *symbol) {
+	symbol->l_exp->accept(*this); symbol->r_exp->accept(*this); handle_pow(symbol, symbol->l_exp, symbol->r_exp);
+	if (is_single_precision(symbol->datatype) && VALID_CVALUE(real64, symbol)) SET_NONCONST(real64, symbol);
+	return NULL;
+}
+
+void *real_constant_folding_c::visit(   neg_expression_c *symbol) {symbol->  exp->accept(*this); handle_neg(symbol, symbol->exp); return round_to_single_precision(symbol);}
+void *real_constant_folding_c::visit(   not_expression_c *symbol) {symbol->  exp->accept(*this); return handle_not(symbol, symbol->exp);}
@@ -213,15 +213,22 @@ class constant_propagation_c : public constant_folding_c {
     symbol_c *current_configuration;
     map_values_t *values;
     map_values_t var_global_values;
+    /* The values of the variables declared CONSTANT in the POU currently being analysed.
+     * Unlike the values[] map, these may be used even when not doing constant propagation, as
+     * these variables never change value.
+     */
+    map_values_t *constant_values;
     /* A stack of all the FB declarations currently being recursively constant propagated */
     std::deque<function_block_declaration_c *> fbs_currently_being_visited; // We use a deque instead of stack, so we can search in the stack using direct access to its elements!
 
     void *handle_var_list_decl(symbol_c *var_list, symbol_c *type_decl, bool is_global_var = false);
-    void *handle_var_decl     (symbol_c *var_list, bool fixed_init_value);
+    void *handle_var_decl     (symbol_c *var_list, bool fixed_init_value, bool constant_var = false);
     // Flag to indicate whether the variables in the variable declaration list will always have a fixed value when the POU is executed!
     // VAR CONSTANT ... END_VAR will always be true
     // VAR          ... END_VAR will always be true for functions (who initialise local variables every time they are called), but false for FBs and PROGRAMS
     bool fixed_init_value_; 
+    // Flag to indicate whether the variables in the variable declaration list were declared CONSTANT
+    bool constant_var_; 
     bool function_pou_;
     bool is_constant(symbol_c *option);
     bool is_retain  (symbol_c *option);
@@ -237,9 +244,7 @@ class constant_propagation_c : public constant_folding_c {
     /*********************/
     /* B 1.4 - Variables */
     /*********************/
-    #if DO_CONSTANT_PROPAGATION__
     void *visit(symbolic_variable_c *symbol);
-    #endif // DO_CONSTANT_PROPAGATION__
     void *visit(symbolic_constant_c *symbol);
                              
     /******************************************/
@@ -335,3 +340,59 @@ class constant_propagation_c : public constant_folding_c {
     #endif // DO_CONSTANT_PROPAGATION__
 };
 
+
+
+/* Constant folding (see constant_folding_c) is done before the datatype of each expression is known, so every
+ * ANY_REAL expression is folded in double precision. The C code generated for a REAL (and SAFEREAL) expression
+ * however computes it in single precision, e.g. 16777216.0 + 1.0 - 16777216.0 is 0.0 at run-time, and not 1.0.
+ *
+ * This class must be run once the datatypes have been narrowed. It folds the ST expressions again, rounding the
+ * value of every REAL literal and intermediate result to single precision. The REAL values of the variables
+ * declared CONSTANT were folded from their initial value in double precision, so these are discarded.
+ */
+class real_constant_folding_c : public iterator_visitor_c {
+  public:
+    real_constant_folding_c(symbol_c *symbol = NULL);
+    virtual ~real_constant_folding_c(void);
+
+  private:
+    /*********************/
+    /* B 1.2 - Constants */
+    /*********************/
+    /******************************/
+    /* B 1.2.1 - Numeric Literals */
+    /******************************/
+    void *visit(real_c *symbol);
+    void *visit(neg_real_c *symbol);
+    void *visit(real_literal_c *symbol);
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    void *visit(symbolic_variable_c *symbol);
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(    or_expression_c *symbol);
+    void *visit(   xor_expression_c *symbol);
+    void *visit(   and_expression_c *symbol);
+    void *visit(   equ_expression_c *symbol);
+    void *visit(notequ_expression_c *symbol);
+    void *visit(    lt_expression_c *symbol);
+    void *visit(    gt_expression_c *symbol);
+    void *visit(    le_expression_c *symbol);
+    void *visit(    ge_expression_c *symbol);
+    void *visit(   add_expression_c *symbol);
+    void *visit(   sub_expression_c *symbol);
+    void *visit(   mul_expression_c *symbol);
+    void *visit(   div_expression_c *symbol);
+    void *visit(   mod_expression_c *symbol);
+    void *visit( power_expression_c *symbol);
+    void *visit(   neg_expression_c *symbol);
+    void *visit(   not_expression_c *symbol);
+};
+
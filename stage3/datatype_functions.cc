@@ -25,6 +25,9 @@
 #include "datatype_functions.hh"
 #include "../absyntax_utils/absyntax_utils.hh"
 #include <vector>
+#include <string>
+#include <ctype.h>  /* required for toupper() */
+#include <stdio.h>  /* required for snprintf() */
 
 
 
@@ -86,7 +89,7 @@
 //#define ANYTIME_OPER_DEPRECATION_STATUS widen_entry::deprecated
 
 
-const struct widen_entry widen_ADD_table[] = {
+static const struct widen_entry widen_ADD_entries[] = {
 #define __add(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -158,7 +161,7 @@ const struct widen_entry widen_ADD_table[] = {
 
 
 
-const struct widen_entry widen_SUB_table[] = {
+static const struct widen_entry widen_SUB_entries[] = {
 #define __sub(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -218,7 +221,7 @@ const struct widen_entry widen_SUB_table[] = {
 
 
 
-const struct widen_entry widen_MUL_table[] = {
+static const struct widen_entry widen_MUL_entries[] = {
 #define __mul(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -252,7 +255,7 @@ const struct widen_entry widen_MUL_table[] = {
 
 
 
-const struct widen_entry widen_DIV_table[] = {
+static const struct widen_entry widen_DIV_entries[] = {
 #define __div(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -280,7 +283,7 @@ const struct widen_entry widen_DIV_table[] = {
  
 
 
-const struct widen_entry widen_MOD_table[] = {
+static const struct widen_entry widen_MOD_entries[] = {
 #define __mod(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -295,7 +298,7 @@ const struct widen_entry widen_MOD_table[] = {
  
 
 
-const struct widen_entry widen_EXPT_table[] = {
+static const struct widen_entry widen_EXPT_entries[] = {
 #define __expt(IN2TYPE, IN1TYPE)       \
     { &get_datatype_info_c::IN1TYPE##_type_name,        &get_datatype_info_c::IN2TYPE##_type_name,          &get_datatype_info_c::IN1TYPE##_type_name,       widen_entry::ok        }, \
     { &get_datatype_info_c::safe##IN1TYPE##_type_name,  &get_datatype_info_c::IN2TYPE##_type_name,          &get_datatype_info_c::IN1TYPE##_type_name,       widen_entry::ok        }, \
@@ -320,7 +323,7 @@ const struct widen_entry widen_EXPT_table[] = {
 /**************************************************************/
 /**************************************************************/
 /* table used by AND and ANDN operators, and and_expression */
-const struct widen_entry widen_AND_table[] = {
+static const struct widen_entry widen_AND_entries[] = {
 #define __and(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -333,7 +336,7 @@ const struct widen_entry widen_AND_table[] = {
 };
 
 /* table used by OR and ORN operators, and or_expression */
-const struct widen_entry widen_OR_table[] = {
+static const struct widen_entry widen_OR_entries[] = {
 #define __or(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -347,7 +350,7 @@ const struct widen_entry widen_OR_table[] = {
 
 
 /* table used by XOR and XORN operators, and xor_expression */
-const struct widen_entry widen_XOR_table[] = {
+static const struct widen_entry widen_XOR_entries[] = {
 #define __xor(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::TYPE##_type_name,       widen_entry::ok                 }, \
@@ -369,7 +372,7 @@ const struct widen_entry widen_XOR_table[] = {
 /**************************************************************/
 /**************************************************************/
 /* table used by GT, GE, EQ, LE, LT, and NE  operators, and equivalent ST expressions. */
-const struct widen_entry widen_CMP_table[] = {
+static const struct widen_entry widen_CMP_entries[] = {
 #define __cmp(TYPE)       \
     { &get_datatype_info_c::TYPE##_type_name,        &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::bool_type_name,         widen_entry::ok                 }, \
     { &get_datatype_info_c::safe##TYPE##_type_name,  &get_datatype_info_c::TYPE##_type_name,          &get_datatype_info_c::bool_type_name,         widen_entry::ok                 }, \
@@ -382,13 +385,201 @@ const struct widen_entry widen_CMP_table[] = {
 };
 
 
+
+/**************************************************************/
+/**************************************************************/
+/**************************************************************/
+/*******                                                *******/
+/*******  Compiled (lookup matrix) version of the above *******/
+/*******                                                *******/
+/**************************************************************/
+/**************************************************************/
+/**************************************************************/
+widen_table_c widen_ADD_table (widen_ADD_entries );
+widen_table_c widen_SUB_table (widen_SUB_entries );
+widen_table_c widen_MUL_table (widen_MUL_entries );
+widen_table_c widen_DIV_table (widen_DIV_entries );
+widen_table_c widen_MOD_table (widen_MOD_entries );
+widen_table_c widen_EXPT_table(widen_EXPT_entries);
+widen_table_c widen_AND_table (widen_AND_entries );
+widen_table_c widen_OR_table  (widen_OR_entries  );
+widen_table_c widen_XOR_table (widen_XOR_entries );
+widen_table_c widen_CMP_table (widen_CMP_entries );
+
+
+widen_table_c::widen_table_c(const struct widen_entry *entries_) {
+	entries  = entries_;
+	compiled = false;
+}
+
+
+/* Build the (left ordinal x right ordinal) lookup matrix.
+ * NOTE: This cannot be done in the constructor, as the widen_table_c objects are static objects, and the
+ *       elementary datatype objects referenced by the widen_entry tables (get_datatype_info_c::int_type_name, ...)
+ *       live in another compilation unit, and may therefore not yet have been constructed when our
+ *       constructor runs. We therefore compile the table the first time it is used.
+ */
+void widen_table_c::compile(void) {
+	for (int l = 0; l < get_datatype_info_c::elementary_type_count; l++)
+		for (int r = 0; r < get_datatype_info_c::elementary_type_count; r++)
+			first_entry[l][r] = -1;
+
+	for (int k = 0; NULL != entries[k].left; k++) {
+		int l = get_datatype_info_c::get_elementary_type_ordinal(entries[k].left);
+		int r = get_datatype_info_c::get_elementary_type_ordinal(entries[k].right);
+		/* The widening tables only contain elementary datatypes! */
+		if ((l < 0) || (r < 0)) ERROR;
+		/* keep the first matching entry, just like a linear search of the table would! */
+		if (first_entry[l][r] < 0)
+			first_entry[l][r] = k;
+	}
+	compiled = true;
+}
+
+
+/* Return the first entry in the widening table for the (left_type, right_type) pair, or NULL if none exists. */
+const struct widen_entry *widen_table_c::search(symbol_c *left_type, symbol_c *right_type) {
+	if (!compiled) compile();
+
+	int l = get_datatype_info_c::get_elementary_type_ordinal(left_type);
+	int r = get_datatype_info_c::get_elementary_type_ordinal(right_type);
+	if ((l < 0) || (r < 0))       return NULL;
+	if (first_entry[l][r] < 0)    return NULL;
+	return &entries[first_entry[l][r]];
+}
+
+
+/* Return the entry in the widening table for the (left_type, right_type) pair that produces result_type, or NULL if none exists. */
+const struct widen_entry *widen_table_c::search(symbol_c *left_type, symbol_c *right_type, symbol_c *result_type) {
+	if (NULL == result_type) return NULL;
+	
+	const struct widen_entry *entry = search(left_type, right_type);
+	if (NULL == entry) return NULL;
+	if (typeid(*result_type) == typeid(*entry->result)) return entry;
+	
+	/* The same (left_type, right_type) pair may in principle appear more than once in the table, each time
+	 * with a distinct result type. Handle this (unlikely) case by searching the remainder of the table.
+	 */
+	for (entry++; NULL != entry->left; entry++)
+		if (   (typeid(*left_type)   == typeid(*entry->left))
+		    && (typeid(*right_type)  == typeid(*entry->right))
+		    && (typeid(*result_type) == typeid(*entry->result)))
+			return entry;
+	return NULL;
+}
+
+
+/**************************************************************/
+/**************************************************************/
+/**************************************************************/
+/*******                                                *******/
+/*******  Overload resolution cache                     *******/
+/*******                                                *******/
+/**************************************************************/
+/**************************************************************/
+/**************************************************************/
+function_call_cache_c function_call_cache;
+
+
+/* Append to the signature the list of candidate datatypes of a value being passed in a function call.
+ * Elementary datatypes are identified by their ordinal (different objects of the same elementary datatype class are
+ * the same datatype), while derived datatypes are identified by the address of their declaration.
+ * Note that two equivalent derived datatypes with distinct declarations will get a distinct signature. This only means
+ * we will miss the cache, never that we will get a wrong result.
+ */
+static void append_candidate_datatypes(std::string &signature, symbol_c *param_value) {
+	char buf[32];
+	
+	if (NULL == param_value) {signature += "{-}"; return;}
+	signature += "{";
+	for (unsigned int i = 0; i < param_value->candidate_datatypes.size(); i++) {
+		symbol_c *datatype = param_value->candidate_datatypes[i];
+		int ordinal = get_datatype_info_c::get_elementary_type_ordinal(datatype);
+		if (ordinal >= 0) snprintf(buf, sizeof(buf), "#%d,", ordinal);
+		else              snprintf(buf, sizeof(buf), "@%p,", (void *)datatype);
+		signature += buf;
+	}
+	signature += "}";
+}
+
+
+/* Append an identifier to the signature. Identifiers are case insensitive! */
+static void append_identifier(std::string &signature, symbol_c *identifier) {
+	char buf[32];
+	token_c *token = dynamic_cast<token_c *>(identifier);
+	
+	if (NULL == token) {
+		/* should not occur, but in any case we can still identify the symbol by its address */
+		snprintf(buf, sizeof(buf), "@%p", (void *)identifier);
+		signature += buf;
+		return;
+	}
+	for (const char *c = token->value; *c != '\0'; c++)
+		signature += toupper(*c);
+}
+
+
+std::string function_call_cache_c::get_signature(symbol_c *fcall, generic_function_call_t &fcall_data) {
+	std::string signature;
+	symbol_c *param_name, *param_value;
+
+	append_identifier(signature, fcall_data.function_name);
+
+	if (NULL != fcall_data.nonformal_operand_list) {
+		function_call_param_iterator_c fcp_iterator(fcall);
+		signature += "(";
+		while ((param_value = fcp_iterator.next_nf()) != NULL)
+			append_candidate_datatypes(signature, param_value);
+		signature += ")";
+	}
+
+	if (NULL != fcall_data.formal_operand_list) {
+		function_call_param_iterator_c fcp_iterator(fcall);
+		signature += "(";
+		while ((param_name = fcp_iterator.next_f()) != NULL) {
+			append_identifier(signature, param_name);
+			if (function_call_param_iterator_c::assign_out == fcp_iterator.get_assign_direction())
+				signature += "=>";
+			else	signature += ":=";
+			append_candidate_datatypes(signature, fcp_iterator.get_current_value());
+		}
+		signature += ")";
+	}
+	return signature;
+}
+
+
+function_call_cache_c::function_list_t *function_call_cache_c::find(const std::string &signature) {
+	std::map <std::string, function_list_t>::iterator iter = cache.find(signature);
+	if (iter == cache.end())
+		return NULL;
+	return &(iter->second);
+}
+
+
+function_call_cache_c::function_list_t *function_call_cache_c::insert(const std::string &signature, const function_list_t &compatible_functions) {
+	function_list_t &entry = cache[signature];
+	entry = compatible_functions;
+	return &entry;
+}
+
+
+
+
 /* Search for a datatype inside a candidate_datatypes list.
  * Returns: position of datatype in the list, or -1 if not found.
  */
-int search_in_candidate_datatype_list(symbol_c *datatype, const std::vector <symbol_c *> &candidate_datatypes) {
+int search_in_candidate_datatype_list(symbol_c *datatype, const candidate_datatypes_c &candidate_datatypes) {
 	if (NULL == datatype) 
 		return -1;
 
+	/* Elementary datatypes can be looked up directly in the bitset of elementary datatypes, as long as the
+	 * list does not also contain other datatypes (e.g. ANY) that may be considered equal to this datatype.
+	 */
+	int ordinal = get_datatype_info_c::get_elementary_type_ordinal(datatype);
+	if ((ordinal >= 0) && !candidate_datatypes.has_non_elementary())
+		return candidate_datatypes.find_elementary(ordinal);
+
 	for(unsigned int i = 0; i < candidate_datatypes.size(); i++)
 		if (get_datatype_info_c::is_type_equal(datatype, candidate_datatypes[i]))
 			return i;
@@ -399,12 +590,12 @@ int search_in_candidate_datatype_list(symbol_c *datatype, const std::vector <sym
 /* Remove a datatype inside a candidate_datatypes list.
  * Returns: If successful it returns true, false otherwise.
  */
-bool remove_from_candidate_datatype_list(symbol_c *datatype, std::vector <symbol_c *> &candidate_datatypes) {
+bool remove_from_candidate_datatype_list(symbol_c *datatype, candidate_datatypes_c &candidate_datatypes) {
 	int pos = search_in_candidate_datatype_list(datatype, candidate_datatypes);
 	if (pos < 0)
 		return false;
 	
-	candidate_datatypes.erase(candidate_datatypes.begin() + pos);
+	candidate_datatypes.erase(pos);
 	return true;
 }
 
@@ -420,11 +611,11 @@ void intersect_candidate_datatype_list(symbol_c *list1 /*origin, dest.*/, symbol
 		/* In principle, we should never call it with NULL values. Best to abort the compiler just in case! */
 		return;
 
-	for(std::vector<symbol_c *>::iterator i = list1->candidate_datatypes.begin(); i < list1->candidate_datatypes.end(); ) {
+	for(unsigned int i = 0; i < list1->candidate_datatypes.size(); ) {
 		/* Note that we do _not_ increment i in the for() loop!
 		 * When we erase an element from position i, a new element will take it's place, that must also be tested! 
 		 */
-		if (search_in_candidate_datatype_list(*i, list2->candidate_datatypes) < 0)
+		if (search_in_candidate_datatype_list(list1->candidate_datatypes[i], list2->candidate_datatypes) < 0)
 			/* remove this element! This will change the value of candidate_datatypes.size() */
 			list1->candidate_datatypes.erase(i);
 		else i++;
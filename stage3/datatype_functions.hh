@@ -26,7 +26,11 @@
 #define _HELPER_FUNCTIONS_HH_
 
 #include "../absyntax/visitor.hh"
+#include "../absyntax_utils/absyntax_utils.hh"
 #include <typeinfo>
+#include <string>
+#include <map>
+#include <vector>
 
 
 
@@ -47,6 +51,38 @@ typedef struct {
 
 
 
+/* Memoise the overload resolution of function calls.
+ * Resolving a call to an overloaded function (e.g. ADD(a, b), or INT_TO_REAL(x)) requires checking every
+ * declaration of that function (stored in the function_symtable) against the candidate datatypes of the
+ * values being passed in the call.
+ * Calls with the same 'shape' (i.e. the same function name, the same parameter names and assignment directions,
+ * and the same candidate datatypes for each value being passed) will always resolve to the same list of compatible
+ * function declarations. We therefore only do this work once for each shape, and reuse the result for every other
+ * call site in the whole project.
+ *
+ * The cache lives for the whole of stage 3, so it is shared by all the datatype analysis passes.
+ */
+class function_call_cache_c {
+  public:
+    typedef std::vector <symbol_c *> function_list_t;
+
+    /* Build the key (signature) identifying the shape of a function call.
+     * Assumes the candidate_datatypes lists of all the values being passed in the call have already been filled in!
+     */
+    static std::string get_signature(symbol_c *fcall, generic_function_call_t &fcall_data);
+    /* Returns the list of compatible function declarations, or NULL if this signature has not yet been resolved. */
+    function_list_t *find(const std::string &signature);
+    /* Store the list of compatible function declarations. Returns a pointer to the stored list. */
+    function_list_t *insert(const std::string &signature, const function_list_t &compatible_functions);
+
+  private:
+    std::map <std::string, function_list_t> cache;
+};
+
+extern function_call_cache_c function_call_cache;
+
+
+
 
 
 
@@ -59,30 +95,52 @@ struct widen_entry {
 	symbol_c *result;
 	enum {ok, deprecated} status;
 };
+
+/* A widening table, compiled into a lookup matrix indexed by the ordinals of the
+ * elementary datatypes of the left and right operands (see get_datatype_info_c::get_elementary_type_ordinal()).
+ * Looking up the result of an operation on a pair of datatypes therefore no longer requires a linear search
+ * through the whole table, comparing the typeid()s of each entry.
+ */
+class widen_table_c {
+  private:
+    const struct widen_entry *entries; /* the widen_entry table, terminated by an entry with left == NULL */
+    bool compiled;
+    /* index into entries[] of the first entry for each (left, right) pair, or -1 if no such entry */
+    short first_entry[get_datatype_info_c::elementary_type_count][get_datatype_info_c::elementary_type_count];
+    void compile(void);
+
+  public:
+    widen_table_c(const struct widen_entry *entries_);
+    /* Returns the first entry compatible with the (left_type, right_type) pair, or NULL if none exists */
+    const struct widen_entry *search(symbol_c *left_type, symbol_c *right_type);
+    /* Returns the entry compatible with the (left_type, right_type) pair that produces result_type, or NULL if none exists */
+    const struct widen_entry *search(symbol_c *left_type, symbol_c *right_type, symbol_c *result_type);
+};
+
 /*
  * 2.5.1.5.6 Functions of time data types
  * Table 30 - page 64
  */
-extern const struct widen_entry widen_ADD_table[];
-extern const struct widen_entry widen_SUB_table[];
-extern const struct widen_entry widen_MUL_table[];
-extern const struct widen_entry widen_DIV_table[];
-extern const struct widen_entry widen_MOD_table[];
-extern const struct widen_entry widen_EXPT_table[];
-extern const struct widen_entry widen_AND_table[];
-extern const struct widen_entry widen_OR_table[];
-extern const struct widen_entry widen_XOR_table[];
-extern const struct widen_entry widen_CMP_table[];
+extern widen_table_c widen_ADD_table;
+extern widen_table_c widen_SUB_table;
+extern widen_table_c widen_MUL_table;
+extern widen_table_c widen_DIV_table;
+extern widen_table_c widen_MOD_table;
+extern widen_table_c widen_EXPT_table;
+extern widen_table_c widen_AND_table;
+extern widen_table_c widen_OR_table;
+extern widen_table_c widen_XOR_table;
+extern widen_table_c widen_CMP_table;
 
 /* Search for a datatype inside a candidate_datatypes list.
  * Returns: position of datatype in the list, or -1 if not found.
  */
-int search_in_candidate_datatype_list(symbol_c *datatype, const std::vector <symbol_c *> &candidate_datatypes);
+int search_in_candidate_datatype_list(symbol_c *datatype, const candidate_datatypes_c &candidate_datatypes);
 
 /* Remove a datatype inside a candidate_datatypes list.
  * Returns: If successful it returns true, false otherwise.
  */
-bool remove_from_candidate_datatype_list(symbol_c *datatype, std::vector <symbol_c *> &candidate_datatypes);
+bool remove_from_candidate_datatype_list(symbol_c *datatype, candidate_datatypes_c &candidate_datatypes);
 
 /* Intersect two candidate_datatype_lists.
  * Remove from list1 (origin, dest.) all elements that are not found in list2 (with).
@@ -0,0 +1,191 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  EN/ENO usage analysis.
+ *
+ *  Determine, for each Function and Function Block, whether its EN and ENO
+ *  parameters are ever used from outside the POU.
+ *
+ *  See en_eno_analysis.hh for details.
+ */
+
+#include "en_eno_analysis.hh"
+#include <strings.h>  /* required for strcasecmp() */
+
+
+
+en_eno_analysis_c::en_eno_analysis_c(symbol_c *ignore) {
+  unknown_fb_en_eno_access = false;
+}
+
+en_eno_analysis_c::~en_eno_analysis_c(void) {
+}
+
+
+/* Start off assuming the implicitly declared EN/ENO of the POU are not used. */
+void en_eno_analysis_c::reset_usage(symbol_c *pou_decl, en_eno_usage_c &en_eno_usage) {
+  function_param_iterator_c fp_iterator(pou_decl);
+  identifier_c *param_name;
+
+  en_eno_usage.en_used  = true;
+  en_eno_usage.eno_used = true;
+  while ((param_name = fp_iterator.next()) != NULL) {
+    if (!fp_iterator.is_en_eno_param_implicit()) continue;
+    if (strcasecmp(param_name->value, "EN" ) == 0)  en_eno_usage.en_used  = false;
+    if (strcasecmp(param_name->value, "ENO") == 0)  en_eno_usage.eno_used = false;
+  }
+}
+
+
+/* Mark the EN/ENO of the POU being called as used, if this invocation passes a value to EN, or reads ENO. */
+void en_eno_analysis_c::mark_call(symbol_c *f_call, symbol_c *pou_decl) {
+  /* NOTE: the called POU may not have been determined if the code contains errors. */
+  if (NULL == pou_decl) return;
+
+  en_eno_usage_c *en_eno_usage = NULL;
+  function_declaration_c       *f_decl  = dynamic_cast<function_declaration_c       *>(pou_decl);
+  function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(pou_decl);
+  if (NULL !=  f_decl)  en_eno_usage = & f_decl->en_eno_usage;
+  if (NULL != fb_decl)  en_eno_usage = &fb_decl->en_eno_usage;
+  if (NULL == en_eno_usage)  return;  /* programs do not have EN/ENO */
+
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(f_call, pou_decl);
+  for (unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    if (binding.extensible_count || (NULL == binding.param_value))  continue;
+    token_c *param_name = dynamic_cast<token_c *>(binding.decl_param_name);
+    if (NULL == param_name)  ERROR;
+    if (strcasecmp(param_name->value, "EN" ) == 0)  en_eno_usage->en_used  = true;
+    if (strcasecmp(param_name->value, "ENO") == 0)  en_eno_usage->eno_used = true;
+  }
+}
+
+
+
+/*********************/
+/* B 1.4 - Variables */
+/*********************/
+/*************************************/
+/* B.1.4.2   Multi-element Variables */
+/*************************************/
+// SYM_REF2(structured_variable_c, record_variable, field_selector)
+void *en_eno_analysis_c::visit(structured_variable_c *symbol) {
+  token_c *field_name = dynamic_cast<token_c *>(symbol->field_selector);
+  if (   (NULL != field_name)
+      && ((strcasecmp(field_name->value, "EN") == 0) || (strcasecmp(field_name->value, "ENO") == 0))) {
+    /* symbol->scope was set by fill_candidate_datatypes_c to the datatype of the record_variable */
+    function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(symbol->scope);
+    if      (NULL == symbol->scope)  unknown_fb_en_eno_access = true;
+    else if (NULL != fb_decl)        fb_decl->en_eno_usage.en_used = fb_decl->en_eno_usage.eno_used = true;
+    /* else: a field of a structure that happens to be called EN or ENO. Ignore it! */
+  }
+  symbol->record_variable->accept(*this);
+  return NULL;
+}
+
+
+
+/*****************************/
+/* B 0 - Programming Model */
+/*****************************/
+void *en_eno_analysis_c::visit(library_c *symbol) {
+  /* 1st pass: reset the EN/ENO usage of every Function and FB declared in the library... */
+  for (int i = 0; i < symbol->n; i++) {
+    function_declaration_c       *f_decl  = dynamic_cast<function_declaration_c       *>(symbol->get_element(i));
+    function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(symbol->get_element(i));
+    if (NULL !=  f_decl)  reset_usage( f_decl,  f_decl->en_eno_usage);
+    if (NULL != fb_decl)  reset_usage(fb_decl, fb_decl->en_eno_usage);
+  }
+
+  /* 2nd pass: ... and then look for all the places where they are used. */
+  unknown_fb_en_eno_access = false;
+  iterator_visitor_c::visit(symbol);
+
+  if (unknown_fb_en_eno_access) {
+    /* play it safe! */
+    for (int i = 0; i < symbol->n; i++) {
+      function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(symbol->get_element(i));
+      if (NULL != fb_decl)  fb_decl->en_eno_usage.en_used = fb_decl->en_eno_usage.eno_used = true;
+    }
+  }
+  return NULL;
+}
+
+
+
+/****************************************/
+/* B.2 - Language IL (Instruction List) */
+/****************************************/
+/***********************************/
+/* B 2.1 Instructions and Operands */
+/***********************************/
+// SYM_REF2(il_function_call_c, function_name, il_operand_list, symbol_c *called_function_declaration; ...)
+void *en_eno_analysis_c::visit(il_function_call_c *symbol) {
+  mark_call(symbol, symbol->called_function_declaration);
+  return iterator_visitor_c::visit(symbol);
+}
+
+// SYM_REF4(il_fb_call_c, il_call_operator, fb_name, il_operand_list, il_param_list, symbol_c *called_fb_declaration; ...)
+void *en_eno_analysis_c::visit(il_fb_call_c *symbol) {
+  mark_call(symbol, symbol->called_fb_declaration);
+  return iterator_visitor_c::visit(symbol);
+}
+
+// SYM_REF2(il_formal_funct_call_c, function_name, il_param_list, symbol_c *called_function_declaration; ...)
+void *en_eno_analysis_c::visit(il_formal_funct_call_c *symbol) {
+  mark_call(symbol, symbol->called_function_declaration);
+  return iterator_visitor_c::visit(symbol);
+}
+
+
+
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+/***********************/
+/* B 3.1 - Expressions */
+/***********************/
+// SYM_REF3(function_invocation_c, function_name, formal_param_list, nonformal_param_list, symbol_c *called_function_declaration; ...)
+void *en_eno_analysis_c::visit(function_invocation_c *symbol) {
+  mark_call(symbol, symbol->called_function_declaration);
+  return iterator_visitor_c::visit(symbol);
+}
+
+/*****************************************/
+/* B 3.2.2 Subprogram Control Statements */
+/*****************************************/
+// SYM_REF3(fb_invocation_c, fb_name, formal_param_list, nonformal_param_list, symbol_c *called_fb_declaration; ...)
+void *en_eno_analysis_c::visit(fb_invocation_c *symbol) {
+  mark_call(symbol, symbol->called_fb_declaration);
+  return iterator_visitor_c::visit(symbol);
+}
+
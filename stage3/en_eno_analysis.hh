@@ -0,0 +1,112 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  EN/ENO usage analysis.
+ *
+ *  Determine, for each Function and Function Block, whether its EN and ENO
+ *  parameters are ever used from outside the POU. This class will annotate
+ *  the abstract syntax tree, by filling in the en_eno_usage annotation of the 
+ *  function_declaration_c and function_block_declaration_c objects.
+ *
+ *  EN is considered used if any invocation of the POU passes a value to EN.
+ *  ENO is considered used if any invocation of the POU reads ENO (i.e. ENO => var).
+ *  For Function Blocks we also consider EN/ENO used if they are accessed directly
+ *  through an FB instance (e.g. fb_inst.EN := ...;  var := fb_inst.ENO;).
+ *  EN and ENO parameters explicitly declared by the user are always considered used.
+ *
+ *  This analysis relies on the parameter bindings (param_bindings) and the 
+ *  called POU annotations of each invocation, and on the scope annotation
+ *  of structured variables, so it must only be run after the datatype
+ *  analysis (fill/narrow candidate datatypes) has been completed.
+ */
+
+
+
+#include "../absyntax_utils/absyntax_utils.hh"
+
+
+class en_eno_analysis_c: public iterator_visitor_c {
+
+  private:
+    /* Set when some EN or ENO is accessed through a variable whose FB type we could not determine.
+     * In this case we must assume that the EN/ENO of every FB is used.
+     */
+    bool unknown_fb_en_eno_access;
+
+  private:
+    void reset_usage(symbol_c *pou_decl, en_eno_usage_c &en_eno_usage);
+    void mark_call  (symbol_c *f_call, symbol_c *pou_decl);
+
+  public:
+    en_eno_analysis_c(symbol_c *ignore);
+    virtual ~en_eno_analysis_c(void);
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    /*************************************/
+    /* B.1.4.2   Multi-element Variables */
+    /*************************************/
+    void *visit(structured_variable_c *symbol);
+
+    /********************************/
+    /* B 1.7 Configuration elements */
+    /********************************/
+    /*****************************/
+    /* B 0 - Programming Model */
+    /*****************************/
+    void *visit(library_c *symbol);
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    /***********************************/
+    /* B 2.1 Instructions and Operands */
+    /***********************************/
+    void *visit(il_function_call_c *symbol);
+    void *visit(il_fb_call_c *symbol);
+    void *visit(il_formal_funct_call_c *symbol);
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(function_invocation_c *symbol);
+
+    /*********************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*********************************/
+    void *visit(fb_invocation_c *symbol);
+}; // en_eno_analysis_c
+
@@ -283,13 +283,10 @@ fill_candidate_datatypes_c::~fill_candidate_datatypes_c(void) {
 
 
 
-symbol_c *fill_candidate_datatypes_c::widening_conversion(symbol_c *left_type, symbol_c *right_type, const struct widen_entry widen_table[]) {
-	int k;
+symbol_c *fill_candidate_datatypes_c::widening_conversion(symbol_c *left_type, symbol_c *right_type, widen_table_c &widen_table) {
 	/* find a widening table entry compatible */
-	for (k = 0; NULL != widen_table[k].left;  k++)
-		if ((typeid(*left_type) == typeid(*widen_table[k].left)) && (typeid(*right_type) == typeid(*widen_table[k].right)))
-                      return widen_table[k].result;
-	return NULL;
+	const struct widen_entry *entry = widen_table.search(left_type, right_type);
+	return (NULL == entry)? NULL : entry->result;
 }
 
 
@@ -307,7 +304,7 @@ bool fill_candidate_datatypes_c::add_datatype_to_candidate_list(symbol_c *symbol
     return false;
   
   /* not yet in the candidate data type list, so we insert it now! */
-  symbol->candidate_datatypes.push_back(datatype);
+  symbol->candidate_datatypes.push_back(datatype, get_datatype_info_c::get_elementary_type_ordinal(datatype));
   return true;
 }
     
@@ -431,7 +428,7 @@ bool fill_candidate_datatypes_c::match_formal_call(symbol_c *f_call, symbol_c *f
 			return false;
 
 		/* Obtaining the type of the value being passed in the function call */
-		std::vector <symbol_c *>&call_param_types = call_param_value->candidate_datatypes;
+		candidate_datatypes_c &call_param_types = call_param_value->candidate_datatypes;
 
 		/* Find the corresponding parameter in function declaration */
 		param_name = fp_iterator.search(call_param_name);
@@ -527,22 +524,37 @@ void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_f
 			fcall_data.candidate_functions.push_back(f_decl);
 		
 	}
-	for(; lower != upper; lower++) {
-		bool compatible = false;
-		
-		f_decl = function_symtable.get_value(lower);
-		/* Check if function declaration in symbol_table is compatible with parameters */
-		if (NULL != fcall_data.nonformal_operand_list) compatible=match_nonformal_call(fcall, f_decl);
-		if (NULL != fcall_data.   formal_operand_list) compatible=   match_formal_call(fcall, f_decl);
-		if (compatible) {
-			/* Add the data type returned by the called functions. 
-			 * However, only do this if this data type is not already present in the candidate_datatypes list_c
-			 */
-			returned_parameter_type = base_type(f_decl->type_name);		
-			if (add_datatype_to_candidate_list(fcall, returned_parameter_type))
-				/* we only add it to the function declaration list if this entry was not already present in the candidate datatype list! */
-				fcall_data.candidate_functions.push_back(f_decl);
+
+	/* Matching the call against every declaration of an overloaded function is expensive, so we first check whether
+	 * a call with the same shape (same function, parameters, and parameter candidate datatypes) has already been resolved.
+	 */
+	std::string signature = function_call_cache_c::get_signature(fcall, fcall_data);
+	function_call_cache_c::function_list_t *compatible_functions = function_call_cache.find(signature);
+	
+	if (NULL == compatible_functions) {
+		function_call_cache_c::function_list_t new_compatible_functions;
+		for(; lower != upper; lower++) {
+			bool compatible = false;
+			
+			f_decl = function_symtable.get_value(lower);
+			/* Check if function declaration in symbol_table is compatible with parameters */
+			if (NULL != fcall_data.nonformal_operand_list) compatible=match_nonformal_call(fcall, f_decl);
+			if (NULL != fcall_data.   formal_operand_list) compatible=   match_formal_call(fcall, f_decl);
+			if (compatible)
+				new_compatible_functions.push_back(f_decl);
 		}
+		compatible_functions = function_call_cache.insert(signature, new_compatible_functions);
+	}
+	
+	for(unsigned int i = 0; i < compatible_functions->size(); i++) {
+		f_decl = (function_declaration_c *)(*compatible_functions)[i];
+		/* Add the data type returned by the called functions. 
+		 * However, only do this if this data type is not already present in the candidate_datatypes list_c
+		 */
+		returned_parameter_type = base_type(f_decl->type_name);		
+		if (add_datatype_to_candidate_list(fcall, returned_parameter_type))
+			/* we only add it to the function declaration list if this entry was not already present in the candidate datatype list! */
+			fcall_data.candidate_functions.push_back(f_decl);
 	}
 	if (debug) std::cout << "end_function() [" << fcall->candidate_datatypes.size() << "] result.\n";
 	return;
@@ -635,7 +647,7 @@ void *fill_candidate_datatypes_c::handle_S_and_R_operator(symbol_c *symbol, cons
 
 
 /* handle a binary IL operator, like ADD, SUB, etc... */
-void *fill_candidate_datatypes_c::handle_binary_operator(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
+void *fill_candidate_datatypes_c::handle_binary_operator(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
 	if (NULL == l_expr) return NULL; /* if no prev_il_instruction */
 	if (NULL == r_expr) return NULL; /* if no IL operand!! */
 
@@ -651,7 +663,7 @@ void *fill_candidate_datatypes_c::handle_binary_operator(const struct widen_entr
 
 
 /* handle a binary ST expression, like '+', '-', etc... */
-void *fill_candidate_datatypes_c::handle_binary_expression(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
+void *fill_candidate_datatypes_c::handle_binary_expression(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
 	l_expr->accept(*this);
 	r_expr->accept(*this);
 	return handle_binary_operator(widen_table, symbol, l_expr, r_expr);
@@ -664,7 +676,7 @@ void *fill_candidate_datatypes_c::handle_binary_expression(const struct widen_en
  * It will also allow to REF_TO datatypes to be compared.
  * These possibilities are not expressed in the 'widening' tables, so we need to hard code it here
  */
-void *fill_candidate_datatypes_c::handle_equality_comparison(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
+void *fill_candidate_datatypes_c::handle_equality_comparison(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr) {
 	handle_binary_expression(widen_table, symbol, l_expr, r_expr);
 	for(unsigned int i = 0; i < l_expr->candidate_datatypes.size(); i++)
 		for(unsigned int j = 0; j < r_expr->candidate_datatypes.size(); j++) {
@@ -84,7 +84,7 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
     symbol_c *prev_il_instruction;
     /* the current IL operand being analyzed */
     symbol_c *il_operand;
-    symbol_c *widening_conversion(symbol_c *left_type, symbol_c *right_type, const struct widen_entry widen_table[]);
+    symbol_c *widening_conversion(symbol_c *left_type, symbol_c *right_type, widen_table_c &widen_table);
 
     /* Match a function declaration with a function call through their parameters.*/
     /* returns true if compatible function/FB invocation, otherwise returns false */
@@ -93,9 +93,9 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
     void  handle_function_call(symbol_c *fcall, generic_function_call_t fcall_data);
     void *handle_implicit_il_fb_call(symbol_c *il_instruction, const char *param_name,   symbol_c *&called_fb_declaration);
     void *handle_S_and_R_operator   (symbol_c *symbol,         const char *operator_str, symbol_c *&called_fb_declaration);
-    void *handle_equality_comparison(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
-    void *handle_binary_expression  (const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
-    void *handle_binary_operator    (const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
+    void *handle_equality_comparison(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
+    void *handle_binary_expression  (widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
+    void *handle_binary_operator    (widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr);
     void *handle_conditional_il_flow_control_operator   (symbol_c *symbol);
     void *fill_type_decl            (symbol_c *symbol,   symbol_c *type_name, symbol_c *spec_init);
     void *fill_spec_init            (symbol_c *symbol,   symbol_c *type_spec, symbol_c *init_value);
@@ -0,0 +1,723 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  Compile time evaluation of Function invocations.
+ *
+ *  Evaluate the invocations of user defined Functions whose parameters are all constant.
+ *
+ *  See function_evaluation.hh for details.
+ */
+
+#include "function_evaluation.hh"
+#include <map>
+#include <string>
+
+
+/* Maximum number of statements and expressions executed while evaluating a single invocation
+ * (including any Functions it invokes). This limits the compile time spent on long (or infinite) loops.
+ */
+#define MAX_EVALUATION_STEPS  100000
+/* Maximum nesting depth of the Function invocations being evaluated. */
+#define MAX_EVALUATION_DEPTH  16
+
+
+
+/* The datatypes the interpreter knows how to handle, and in which const_value_c field their values are stored. */
+typedef enum {
+  unsupported_vk,
+  signed_vk,     /* ANY_signed_INT   -> _int64  */
+  unsigned_vk,   /* ANY_unsigned_INT,
+                  * ANY_nBIT         -> _uint64 */
+  real_vk,       /* ANY_REAL         -> _real64 */
+  bool_vk        /* BOOL             -> _bool   */
+} value_kind_t;
+
+typedef struct {
+  value_kind_t kind;
+  int          bits;
+} value_type_t;
+
+
+/* NOTE: the SAFExxx datatypes have the same values (and C representation) as the corresponding xxx datatypes. */
+static value_type_t get_value_type(symbol_c *datatype) {
+  value_type_t res = {unsupported_vk, 0};
+  if (NULL == datatype)  return res;
+  symbol_c *type = search_base_type_c::get_basetype_decl(datatype);
+
+  if      (   (NULL != dynamic_cast<     sint_type_name_c *>(type))
+           || (NULL != dynamic_cast< safesint_type_name_c *>(type)))  {res.kind =   signed_vk; res.bits =  8;}
+  else if (   (NULL != dynamic_cast<      int_type_name_c *>(type))
+           || (NULL != dynamic_cast<  safeint_type_name_c *>(type)))  {res.kind =   signed_vk; res.bits = 16;}
+  else if (   (NULL != dynamic_cast<     dint_type_name_c *>(type))
+           || (NULL != dynamic_cast< safedint_type_name_c *>(type)))  {res.kind =   signed_vk; res.bits = 32;}
+  else if (   (NULL != dynamic_cast<     lint_type_name_c *>(type))
+           || (NULL != dynamic_cast< safelint_type_name_c *>(type)))  {res.kind =   signed_vk; res.bits = 64;}
+  else if (   (NULL != dynamic_cast<    usint_type_name_c *>(type))
+           || (NULL != dynamic_cast<safeusint_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits =  8;}
+  else if (   (NULL != dynamic_cast<     uint_type_name_c *>(type))
+           || (NULL != dynamic_cast< safeuint_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 16;}
+  else if (   (NULL != dynamic_cast<    udint_type_name_c *>(type))
+           || (NULL != dynamic_cast<safeudint_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 32;}
+  else if (   (NULL != dynamic_cast<    ulint_type_name_c *>(type))
+           || (NULL != dynamic_cast<safeulint_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 64;}
+  else if (   (NULL != dynamic_cast<     byte_type_name_c *>(type))
+           || (NULL != dynamic_cast< safebyte_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits =  8;}
+  else if (   (NULL != dynamic_cast<     word_type_name_c *>(type))
+           || (NULL != dynamic_cast< safeword_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 16;}
+  else if (   (NULL != dynamic_cast<    dword_type_name_c *>(type))
+           || (NULL != dynamic_cast<safedword_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 32;}
+  else if (   (NULL != dynamic_cast<    lword_type_name_c *>(type))
+           || (NULL != dynamic_cast<safelword_type_name_c *>(type)))  {res.kind = unsigned_vk; res.bits = 64;}
+  else if (   (NULL != dynamic_cast<     real_type_name_c *>(type))
+           || (NULL != dynamic_cast< safereal_type_name_c *>(type)))  {res.kind =     real_vk; res.bits = 32;}
+  else if (   (NULL != dynamic_cast<    lreal_type_name_c *>(type))
+           || (NULL != dynamic_cast<safelreal_type_name_c *>(type)))  {res.kind =     real_vk; res.bits = 64;}
+  else if (   (NULL != dynamic_cast<     bool_type_name_c *>(type))
+           || (NULL != dynamic_cast< safebool_type_name_c *>(type)))  {res.kind =     bool_vk; res.bits =  1;}
+  return res;
+}
+
+
+static bool is_same_type(value_type_t t1, value_type_t t2) {
+  return ((t1.kind == t2.kind) && (t1.bits == t2.bits));
+}
+
+
+/* Check that <value> is a valid value of datatype <type>, and round REAL values to single precision,
+ * as the generated C code would do.
+ */
+static bool normalize(value_type_t type, const_value_c &value) {
+  switch (type.kind) {
+    case signed_vk: {
+      if (!value._int64.is_valid())  return false;
+      if (type.bits == 64)  return true;
+      int64_t max = ((int64_t)1 << (type.bits - 1)) - 1;
+      int64_t min = -max - 1;
+      return ((value._int64.get() >= min) && (value._int64.get() <= max));
+    }
+    case unsigned_vk: {
+      if (!value._uint64.is_valid())  return false;
+      if (type.bits == 64)  return true;
+      return (value._uint64.get() <= ((uint64_t)1 << type.bits) - 1);
+    }
+    case real_vk: {
+      if (!value._real64.is_valid())  return false;
+      real64_t real_value = value._real64.get();
+      if (type.bits == 32)  real_value = (float)real_value;
+      if ((real_value != real_value) || (real_value - real_value != 0))  return false; /* NaN or infinity */
+      value._real64.set(real_value);
+      return true;
+    }
+    case bool_vk:
+      return value._bool.is_valid();
+    default:
+      return false;
+  }
+}
+
+
+/* Get the value determined by constant folding for <symbol>, as a value of datatype <type>. */
+static bool get_const_value(symbol_c *symbol, value_type_t type, const_value_c &value) {
+  value = const_value_c();
+  switch (type.kind) {
+    case   signed_vk: if (symbol->const_value._int64 .is_valid()) value._int64 .set(symbol->const_value._int64 .get()); break;
+    case unsigned_vk: if (symbol->const_value._uint64.is_valid()) value._uint64.set(symbol->const_value._uint64.get()); break;
+    case     real_vk: if (symbol->const_value._real64.is_valid()) value._real64.set(symbol->const_value._real64.get()); break;
+    case     bool_vk: if (symbol->const_value._bool  .is_valid()) value._bool  .set(symbol->const_value._bool  .get()); break;
+    default: break;
+  }
+  return normalize(type, value);
+}
+
+
+static void set_zero(value_type_t type, const_value_c &value) {
+  value = const_value_c();
+  switch (type.kind) {
+    case   signed_vk: value._int64 .set(0);     break;
+    case unsigned_vk: value._uint64.set(0);     break;
+    case     real_vk: value._real64.set(0.0);   break;
+    case     bool_vk: value._bool  .set(false); break;
+    default: break;
+  }
+}
+
+
+/* Get the initial value of a variable of datatype <datatype> declared without an explicit initial value,
+ * i.e. the default initial value of <datatype> (which need not be 0 for derived datatypes and subranges).
+ */
+static bool get_initial_value(symbol_c *datatype, value_type_t type, const_value_c &value) {
+  symbol_c *init_value = type_initial_value_c::get(datatype);
+  if (NULL == init_value)  return false;
+  /* the default initial values of the elementary datatypes are not in the AST, so they were never constant folded */
+  if (init_value == type_initial_value_c::get(search_base_type_c::get_basetype_decl(datatype))) {
+    set_zero(type, value);
+    return true;
+  }
+  return get_const_value(init_value, type, value);
+}
+
+
+
+typedef enum {
+  or_op, xor_op, and_op,
+  eq_op, ne_op, lt_op, gt_op, le_op, ge_op,
+  add_op, sub_op, mul_op, div_op, mod_op
+} operation_t;
+
+
+/* Compare two values of the same type, returning -1, 0, or 1 */
+static int compare(value_type_t type, const_value_c &l, const_value_c &r) {
+  switch (type.kind) {
+    case   signed_vk: return (l._int64 .get() < r._int64 .get())? -1 : (l._int64 .get() > r._int64 .get())? 1 : 0;
+    case unsigned_vk: return (l._uint64.get() < r._uint64.get())? -1 : (l._uint64.get() > r._uint64.get())? 1 : 0;
+    case     real_vk: return (l._real64.get() < r._real64.get())? -1 : (l._real64.get() > r._real64.get())? 1 : 0;
+    case     bool_vk: return (l._bool  .get() < r._bool  .get())? -1 : (l._bool  .get() > r._bool  .get())? 1 : 0;
+    default: ERROR; return 0;
+  }
+}
+
+
+/* Apply the binary operation <op> to the values <l> and <r>, of datatype <type>.
+ * Returns false if the operation is not supported for that datatype, or if it overflows.
+ * The range of the result (for datatypes smaller than 64 bits) is checked later, by normalize().
+ */
+static bool binary_operation(operation_t op, value_type_t type, const_value_c &l, const_value_c &r, const_value_c &res) {
+  res = const_value_c();
+  switch (op) {
+    case eq_op: res._bool.set(compare(type, l, r) == 0); return true;
+    case ne_op: res._bool.set(compare(type, l, r) != 0); return true;
+    case lt_op: res._bool.set(compare(type, l, r) <  0); return true;
+    case gt_op: res._bool.set(compare(type, l, r) >  0); return true;
+    case le_op: res._bool.set(compare(type, l, r) <= 0); return true;
+    case ge_op: res._bool.set(compare(type, l, r) >= 0); return true;
+    default: break;
+  }
+
+  switch (type.kind) {
+    case signed_vk: {
+      int64_t a = l._int64.get(), b = r._int64.get();
+      switch (op) {
+        case add_op: if ((b > 0)? (a > INT64_MAX - b) : (a < INT64_MIN - b))  return false;
+                     res._int64.set(a + b);  return true;
+        case sub_op: if ((b < 0)? (a > INT64_MAX + b) : (a < INT64_MIN + b))  return false;
+                     res._int64.set(a - b);  return true;
+        case mul_op: if ((a != 0) && (b != 0)) {
+                       if ((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN))  return false;
+                       if ((int64_t)((uint64_t)a * (uint64_t)b) / b != a)  return false;
+                     }
+                     res._int64.set(a * b);  return true;
+        case div_op: if ((b == 0) || (a == INT64_MIN && b == -1))  return false;
+                     res._int64.set(a / b);  return true;
+        /* the generated C code returns 0 for MOD 0 */
+        case mod_op: if (a == INT64_MIN && b == -1)  return false;
+                     res._int64.set((b == 0)? 0 : a % b);  return true;
+        default:     return false;
+      }
+    }
+    case unsigned_vk: {
+      uint64_t a = l._uint64.get(), b = r._uint64.get();
+      switch (op) {
+        case  or_op: res._uint64.set(a | b);  return true;
+        case xor_op: res._uint64.set(a ^ b);  return true;
+        case and_op: res._uint64.set(a & b);  return true;
+        case add_op: if (a + b < a)  return false;
+                     res._uint64.set(a + b);  return true;
+        case sub_op: if (a < b)  return false;
+                     res._uint64.set(a - b);  return true;
+        case mul_op: if ((a != 0) && ((a * b) / a != b))  return false;
+                     res._uint64.set(a * b);  return true;
+        case div_op: if (b == 0)  return false;
+                     res._uint64.set(a / b);  return true;
+        case mod_op: res._uint64.set((b == 0)? 0 : a % b);  return true;
+        default:     return false;
+      }
+    }
+    case real_vk: {
+      real64_t a = l._real64.get(), b = r._real64.get();
+      switch (op) {
+        case add_op: res._real64.set(a + b);  return true;
+        case sub_op: res._real64.set(a - b);  return true;
+        case mul_op: res._real64.set(a * b);  return true;
+        case div_op: if (b == 0)  return false;
+                     res._real64.set(a / b);  return true;
+        default:     return false;
+      }
+    }
+    case bool_vk: {
+      bool a = l._bool.get(), b = r._bool.get();
+      switch (op) {
+        case  or_op: res._bool.set(a || b);  return true;
+        case xor_op: res._bool.set(a != b);  return true;
+        case and_op: res._bool.set(a && b);  return true;
+        default:     return false;
+      }
+    }
+    default:
+      return false;
+  }
+}
+
+
+
+
+/* Interpret the body of a Function, with the values of its variables in <variables>. */
+class function_interpreter_c: public null_visitor_c {
+  private:
+    typedef struct {
+      value_type_t  type;
+      const_value_c value;
+    } variable_t;
+    typedef std::map<std::string, variable_t, nocasecmp_c> variable_map_t;
+
+    std::set<symbol_c *> &evaluable_functions;
+    variable_map_t variables;
+    int &steps_left;
+    int  depth;
+
+    bool failed;     /* evaluation is not possible */
+    bool exiting;    /* executing an EXIT statement */
+    bool returning;  /* executing a RETURN statement */
+    const_value_c result;  /* value of the expression just visited */
+
+  public:
+    function_interpreter_c(std::set<symbol_c *> &evaluable_functions_, int &steps_left_, int depth_)
+      : evaluable_functions(evaluable_functions_), steps_left(steps_left_), depth(depth_) {
+      failed = exiting = returning = false;
+    }
+    ~function_interpreter_c(void) {}
+
+    /* Evaluate the invocation <f_call>, whose values are all constants, of the Function <f_decl>. */
+    static bool evaluate_call(symbol_c *f_call, function_declaration_c *f_decl, std::set<symbol_c *> &evaluable_functions, const_value_c &value) {
+      int steps_left = MAX_EVALUATION_STEPS;
+      /* The values passed in the invocation are evaluated by an interpreter without any variables */
+      function_interpreter_c caller(evaluable_functions, steps_left, 0);
+      return caller.call(f_call, f_decl, value);
+    }
+
+  private:
+    bool step(void) {
+      if (--steps_left < 0)  failed = true;
+      return !failed;
+    }
+
+    variable_t *find_variable(symbol_c *name) {
+      token_c *var_name = dynamic_cast<token_c *>(name);
+      if (NULL == var_name)  return NULL;
+      variable_map_t::iterator it = variables.find(var_name->value);
+      if (it == variables.end())  return NULL;
+      return &(it->second);
+    }
+
+    /* declare the variables in <var_list>, all of them of the type and initial value in <spec_init> */
+    bool declare_variables(symbol_c *var_list, symbol_c *spec_init) {
+      list_c             *list = dynamic_cast<list_c             *>(var_list);
+      simple_spec_init_c *spec = dynamic_cast<simple_spec_init_c *>(spec_init);
+      if ((NULL == list) || (NULL == spec))  return false;
+
+      variable_t variable;
+      variable.type = get_value_type(spec->simple_specification);
+      if (variable.type.kind == unsupported_vk)  return false;
+      if (NULL == spec->constant) {if (!get_initial_value(spec->simple_specification, variable.type, variable.value))  return false;}
+      else if (!get_const_value(spec->constant, variable.type, variable.value))  return false;
+
+      for (int i = 0; i < list->n; i++) {
+        token_c *var_name = dynamic_cast<token_c *>(list->get_element(i));
+        if (NULL == var_name)  return false;
+        variables[var_name->value] = variable;
+      }
+      return true;
+    }
+
+    /* declare all the variables of the Function <f_decl>, including the variable holding the return value */
+    bool declare_variables(function_declaration_c *f_decl) {
+      list_c *decls_list = dynamic_cast<list_c *>(f_decl->var_declarations_list);
+      if (NULL == decls_list)  return false;
+      for (int i = 0; i < decls_list->n; i++) {
+        symbol_c *decls = decls_list->get_element(i);
+        list_c *list = NULL;
+        input_declarations_c  *input_decls  = dynamic_cast<input_declarations_c  *>(decls);
+        output_declarations_c *output_decls = dynamic_cast<output_declarations_c *>(decls);
+        function_var_decls_c  *var_decls    = dynamic_cast<function_var_decls_c  *>(decls);
+        if      (NULL != input_decls)  list = dynamic_cast<list_c *>(input_decls ->input_declaration_list);
+        else if (NULL != output_decls) list = dynamic_cast<list_c *>(output_decls->var_init_decl_list);
+        else if (NULL != var_decls)    list = dynamic_cast<list_c *>(var_decls   ->decl_list);
+        if (NULL == list)  return false;
+
+        for (int j = 0; j < list->n; j++) {
+          symbol_c *decl = list->get_element(j);
+          var1_init_decl_c *var1_init_decl = dynamic_cast<var1_init_decl_c *>(decl);
+          /* the implicit EN and ENO parameters. An invocation that uses them is not evaluated */
+          if ((NULL != input_decls ) && (NULL != dynamic_cast< en_param_declaration_c *>(decl)))  continue;
+          if ((NULL != output_decls) && (NULL != dynamic_cast<eno_param_declaration_c *>(decl)))  continue;
+          if ((NULL != output_decls) || (NULL == var1_init_decl))  return false;
+          if (!declare_variables(var1_init_decl->var1_list, var1_init_decl->spec_init))  return false;
+        }
+      }
+
+      token_c *f_name = dynamic_cast<token_c *>(f_decl->derived_function_name);
+      if (NULL == f_name)  return false;
+      variable_t variable;
+      variable.type = get_value_type(f_decl->type_name);
+      if (variable.type.kind == unsupported_vk)  return false;
+      if (!get_initial_value(f_decl->type_name, variable.type, variable.value))  return false;
+      variables[f_name->value] = variable;
+      return true;
+    }
+
+    /* Evaluate the invocation <f_call> of Function <f_decl>. The values passed in the invocation are evaluated
+     * in the context of this interpreter (i.e. using the current value of our variables).
+     */
+    bool call(symbol_c *f_call, function_declaration_c *f_decl, const_value_c &value) {
+      if (evaluable_functions.find(f_decl) == evaluable_functions.end())  return false;
+      if (depth >= MAX_EVALUATION_DEPTH)  return false;
+
+      function_interpreter_c callee(evaluable_functions, steps_left, depth + 1);
+      if (!callee.declare_variables(f_decl))  return false;
+
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(f_call, f_decl);
+      if (param_bindings.unbound_values)  return false;
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count || binding.extensible || binding.implicit_variable)  return false;
+        if (NULL == binding.param_value)  continue;  /* the parameter keeps its initial value */
+        if (binding.en_eno_implicit)  return false;
+        if (binding.param_direction != function_param_iterator_c::direction_in)  return false;
+        variable_t *variable = callee.find_variable(binding.decl_param_name);
+        if (NULL == variable)  return false;
+        if (!is_same_type(variable->type, get_value_type(binding.param_value->datatype)))  return false;
+        const_value_c value;
+        if (!evaluate(binding.param_value, value))  return false;
+        variable->value = value;
+      }
+
+      callee.execute(f_decl->function_body);
+      if (callee.failed)  return false;
+      variable_t *variable = callee.find_variable(f_decl->derived_function_name);
+      if (NULL == variable)  ERROR;
+      value = variable->value;
+      return true;
+    }
+
+    /* Execute a statement. */
+    void execute(symbol_c *statement) {
+      if (failed || exiting || returning)  return;
+      if (!step())  return;
+      if (NULL == statement->accept(*this))  failed = true;  /* statement not supported */
+    }
+
+    /* Evaluate an expression, storing its value in <value> */
+    bool evaluate(symbol_c *expression, const_value_c &value) {
+      if (failed || !step())  return false;
+      value_type_t type = get_value_type(expression->datatype);
+      if (type.kind == unsupported_vk)  {failed = true; return false;}
+
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(expression);
+      if (NULL != variable) {
+        variable_t *var = find_variable(variable->var_name);
+        if ((NULL == var) || !is_same_type(type, var->type))  {failed = true; return false;}
+        value = var->value;
+        return true;
+      }
+      /* literals, and any expression already evaluated by constant folding */
+      if (get_const_value(expression, type, value))  return true;
+
+      if (NULL == expression->accept(*this))  failed = true;  /* expression not supported */
+      if (failed)  return false;
+      value = result;
+      if (!normalize(type, value))  failed = true;
+      return !failed;
+    }
+
+    void *binary_expression(symbol_c *l_exp, symbol_c *r_exp, operation_t op) {
+      const_value_c l, r;
+      value_type_t type = get_value_type(l_exp->datatype);
+      if (!is_same_type(type, get_value_type(r_exp->datatype)))  return NULL;
+      if (!evaluate(l_exp, l) || !evaluate(r_exp, r))  return NULL;
+      if (!binary_operation(op, type, l, r, result))  return NULL;
+      return this;
+    }
+
+    /* Evaluate a BOOL expression */
+    bool evaluate_condition(symbol_c *expression, bool &condition) {
+      const_value_c value;
+      if (!evaluate(expression, value))  return false;
+      if (!value._bool.is_valid())  {failed = true; return false;}
+      condition = value._bool.get();
+      return true;
+    }
+
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(    or_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  or_op);}
+    void *visit(   xor_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, xor_op);}
+    void *visit(   and_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, and_op);}
+    void *visit(   equ_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  eq_op);}
+    void *visit(notequ_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  ne_op);}
+    void *visit(    lt_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  lt_op);}
+    void *visit(    gt_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  gt_op);}
+    void *visit(    le_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  le_op);}
+    void *visit(    ge_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp,  ge_op);}
+    void *visit(   add_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, add_op);}
+    void *visit(   sub_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, sub_op);}
+    void *visit(   mul_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, mul_op);}
+    void *visit(   div_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, div_op);}
+    void *visit(   mod_expression_c *symbol) {return binary_expression(symbol->l_exp, symbol->r_exp, mod_op);}
+
+    void *visit(neg_expression_c *symbol) {
+      const_value_c value;
+      value_type_t type = get_value_type(symbol->exp->datatype);
+      if (!evaluate(symbol->exp, value))  return NULL;
+      result = const_value_c();
+      if      ((type.kind == signed_vk) && (value._int64.get() != INT64_MIN))  result._int64 .set(-value._int64 .get());
+      else if  (type.kind ==   real_vk)                                        result._real64.set(-value._real64.get());
+      else return NULL;
+      return this;
+    }
+
+    void *visit(not_expression_c *symbol) {
+      const_value_c value;
+      value_type_t type = get_value_type(symbol->exp->datatype);
+      if (!evaluate(symbol->exp, value))  return NULL;
+      result = const_value_c();
+      if      (type.kind ==     bool_vk)  result._bool.set(!value._bool.get());
+      else if (type.kind == unsigned_vk)  result._uint64.set(~value._uint64.get() & ((type.bits == 64)? ~(uint64_t)0 : ((uint64_t)1 << type.bits) - 1));
+      else return NULL;
+      return this;
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      function_declaration_c *f_decl = dynamic_cast<function_declaration_c *>(symbol->called_function_declaration);
+      if ((NULL == f_decl) || !call(symbol, f_decl, result))  return NULL;
+      return this;
+    }
+
+    /********************/
+    /* B 3.2 Statements */
+    /********************/
+    void *visit(statement_list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++)
+        execute(symbol->get_element(i));
+      return this;
+    }
+
+    /*********************************/
+    /* B 3.2.1 Assignment Statements */
+    /*********************************/
+    void *visit(assignment_statement_c *symbol) {
+      symbolic_variable_c *l_var = dynamic_cast<symbolic_variable_c *>(symbol->l_exp);
+      if (NULL == l_var)  return NULL;
+      variable_t *variable = find_variable(l_var->var_name);
+      if (NULL == variable)  return NULL;
+      if (!is_same_type(variable->type, get_value_type(symbol->r_exp->datatype)))  return NULL;
+      const_value_c value;
+      if (evaluate(symbol->r_exp, value))
+        variable->value = value;
+      return this;
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(return_statement_c *symbol) {returning = true; return this;}
+
+    /********************************/
+    /* B 3.2.3 Selection Statements */
+    /********************************/
+    void *visit(if_statement_c *symbol) {
+      bool condition;
+      if (!evaluate_condition(symbol->expression, condition))  return this;
+      if (condition) {execute(symbol->statement_list); return this;}
+
+      list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+      for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+        elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->get_element(i));
+        if (NULL == elseif)  ERROR;
+        if (!evaluate_condition(elseif->expression, condition))  return this;
+        if (condition) {execute(elseif->statement_list); return this;}
+      }
+      if (NULL != symbol->else_statement_list)
+        execute(symbol->else_statement_list);
+      return this;
+    }
+
+    void *visit(case_statement_c *symbol) {
+      const_value_c selector;
+      value_type_t type = get_value_type(symbol->expression->datatype);
+      if ((type.kind != signed_vk) && (type.kind != unsigned_vk))  return NULL;
+      if (!evaluate(symbol->expression, selector))  return this;
+
+      list_c *element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+      if (NULL == element_list)  return NULL;
+      for (int i = 0; i < element_list->n; i++) {
+        case_element_c *element = dynamic_cast<case_element_c *>(element_list->get_element(i));
+        list_c *case_list = (NULL == element)? NULL : dynamic_cast<list_c *>(element->case_list);
+        if (NULL == case_list)  return NULL;
+        for (int j = 0; j < case_list->n; j++) {
+          const_value_c lower, upper;
+          subrange_c *subrange = dynamic_cast<subrange_c *>(case_list->get_element(j));
+          symbol_c *lower_limit = (NULL == subrange)? case_list->get_element(j) : subrange->lower_limit;
+          symbol_c *upper_limit = (NULL == subrange)? case_list->get_element(j) : subrange->upper_limit;
+          if (   !get_const_value(lower_limit, type, lower)
+              || !get_const_value(upper_limit, type, upper))  return NULL;
+          if ((compare(type, lower, selector) <= 0) && (compare(type, selector, upper) <= 0)) {
+            execute(element->statement_list);
+            return this;
+          }
+        }
+      }
+      if (NULL != symbol->statement_list)
+        execute(symbol->statement_list);
+      return this;
+    }
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    /* Same semantics as the C code generated for the FOR loop (see generate_c_st.cc) */
+    void *visit(for_statement_c *symbol) {
+      symbolic_variable_c *control_var = dynamic_cast<symbolic_variable_c *>(symbol->control_variable);
+      variable_t *variable = (NULL == control_var)? NULL : find_variable(control_var->var_name);
+      if (NULL == variable)  return NULL;
+      value_type_t type = variable->type;
+      if ((type.kind != signed_vk) && (type.kind != unsigned_vk))  return NULL;
+      if (   !is_same_type(type, get_value_type(symbol->beg_expression->datatype))
+          || !is_same_type(type, get_value_type(symbol->end_expression->datatype))
+          || ((NULL != symbol->by_expression) && !is_same_type(type, get_value_type(symbol->by_expression->datatype))))
+        return NULL;
+
+      const_value_c beg_value;
+      if (!evaluate(symbol->beg_expression, beg_value))  return this;
+      variable->value = beg_value;
+      while (!failed && !returning) {
+        const_value_c end_value, by_value, zero;
+        set_zero(type, zero);
+        if (NULL == symbol->by_expression) {
+          by_value = const_value_c();
+          if (type.kind == signed_vk) by_value._int64.set(1); else by_value._uint64.set(1);
+        }
+        else if (!evaluate(symbol->by_expression, by_value))  return this;
+        if (!evaluate(symbol->end_expression, end_value))  return this;
+
+        int cmp = compare(type, variable->value, end_value);
+        if ((compare(type, by_value, zero) > 0)? (cmp > 0) : (cmp < 0))  break;
+
+        execute(symbol->statement_list);
+        if (exiting) {exiting = false; break;}
+        if (failed || returning || !step())  break;
+        const_value_c next_value;
+        if (   !binary_operation(add_op, type, variable->value, by_value, next_value)
+            || !normalize(type, next_value))
+          failed = true;
+        variable->value = next_value;
+      }
+      return this;
+    }
+
+    void *visit(while_statement_c *symbol) {
+      bool condition;
+      while (evaluate_condition(symbol->expression, condition) && condition) {
+        execute(symbol->statement_list);
+        if (exiting) {exiting = false; break;}
+        if (failed || returning)  break;
+      }
+      return this;
+    }
+
+    void *visit(repeat_statement_c *symbol) {
+      bool condition;
+      do {
+        execute(symbol->statement_list);
+        if (exiting) {exiting = false; break;}
+        if (failed || returning)  break;
+      } while (evaluate_condition(symbol->expression, condition) && !condition);
+      return this;
+    }
+
+    void *visit(exit_statement_c *symbol) {exiting = true; return this;}
+}; // function_interpreter_c
+
+
+
+
+function_evaluation_c::function_evaluation_c(symbol_c *ignore) {
+}
+
+function_evaluation_c::~function_evaluation_c(void) {
+}
+
+
+/*****************************/
+/* B 0 - Programming Model */
+/*****************************/
+void *function_evaluation_c::visit(library_c *symbol) {
+  /* 1st pass: determine which Functions have their code generated in ST (see function_evaluation.hh)... */
+  bool code_generation = true;
+  evaluable_functions.clear();
+  for (int i = 0; i < symbol->n; i++) {
+    symbol_c *element = symbol->get_element(i);
+    if (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))  code_generation = true;
+    if (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element))  code_generation = false;
+    function_declaration_c *f_decl = dynamic_cast<function_declaration_c *>(element);
+    if ((NULL != f_decl) && code_generation && (NULL != dynamic_cast<statement_list_c *>(f_decl->function_body)))
+      evaluable_functions.insert(f_decl);
+  }
+
+  /* 2nd pass: ... and evaluate their invocations. */
+  return iterator_visitor_c::visit(symbol);
+}
+
+
+
+/***************************************/
+/* B.3 - Language ST (Structured Text) */
+/***************************************/
+/***********************/
+/* B 3.1 - Expressions */
+/***********************/
+// SYM_REF3(function_invocation_c, function_name, formal_param_list, nonformal_param_list, symbol_c *called_function_declaration; ...)
+void *function_evaluation_c::visit(function_invocation_c *symbol) {
+  /* first evaluate any invocations nested inside the values passed to this Function */
+  iterator_visitor_c::visit(symbol);
+
+  function_declaration_c *f_decl = dynamic_cast<function_declaration_c *>(symbol->called_function_declaration);
+  if (NULL == f_decl)  return NULL;  /* NOTE: the called function may not have been determined if the code contains errors. */
+  const_value_c value;
+  if (function_interpreter_c::evaluate_call(symbol, f_decl, evaluable_functions, value))
+    symbol->const_value = value;
+  return NULL;
+}
+
@@ -0,0 +1,97 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ *  Compile time evaluation of Function invocations.
+ *
+ *  Constant folding determines the value of expressions made up of literals
+ *  and operators, but does not look inside the user defined Functions that
+ *  are invoked in an expression. This class evaluates (i.e. interprets) the
+ *  invocations of user defined Functions, in ST code, whose parameters are
+ *  all constant values, and stores the result in the const_value annotation
+ *  of the function_invocation_c, so stage 4 may use it instead of calling
+ *  the Function at run time.
+ *
+ *  A Function invocation is only evaluated when:
+ *    - the Function's code is generated by the compiler (i.e. it is not inside a
+ *      {disable code generation} ... {enable code generation} block, like the
+ *      standard library functions that are implemented directly in C);
+ *    - the Function's body is written in ST;
+ *    - the Function only declares VAR_INPUT and VAR variables, and the return value,
+ *      all of them of an ANY_INT, ANY_BIT (other than STRING), ANY_REAL or BOOL
+ *      datatype (no VAR_OUTPUT, VAR_IN_OUT, VAR_EXTERNAL, located variables or
+ *      FB instances), so the Function has no side effects;
+ *    - every value passed to the Function is a constant, and nothing is passed
+ *      to EN, nor read from ENO;
+ *    - the body only uses assignments, IF, CASE, FOR, WHILE, REPEAT, EXIT and RETURN
+ *      statements, operators (other than **), and invocations of other Functions
+ *      that may also be evaluated.
+ *
+ *  The evaluation is abandoned (and the Function will be called at run time, as usual)
+ *  if any operation overflows the range of its datatype, or divides by zero,
+ *  or if it does not finish within a fixed number of steps (e.g. an infinite loop).
+ *
+ *  This relies on the called Function annotations (called_function_declaration),
+ *  the datatype of every expression, and the parameter bindings of each invocation,
+ *  so it must only be run after the datatype analysis (fill/narrow candidate datatypes)
+ *  has been completed.
+ */
+
+
+
+#include "../absyntax_utils/absyntax_utils.hh"
+#include <set>
+
+
+class function_evaluation_c: public iterator_visitor_c {
+
+  private:
+    /* The Functions whose invocations we may try to evaluate */
+    std::set<symbol_c *> evaluable_functions;
+
+  public:
+    function_evaluation_c(symbol_c *ignore);
+    virtual ~function_evaluation_c(void);
+
+    /*****************************/
+    /* B 0 - Programming Model */
+    /*****************************/
+    void *visit(library_c *symbol);
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(function_invocation_c *symbol);
+}; // function_evaluation_c
+
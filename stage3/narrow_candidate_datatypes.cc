@@ -116,23 +116,19 @@ void narrow_candidate_datatypes_c::set_datatype_in_prev_il_instructions(symbol_c
 
 
 
-bool narrow_candidate_datatypes_c::is_widening_compatible(const struct widen_entry widen_table[], symbol_c *left_type, symbol_c *right_type, symbol_c *result_type, bool *deprecated_status) {
+bool narrow_candidate_datatypes_c::is_widening_compatible(widen_table_c &widen_table, symbol_c *left_type, symbol_c *right_type, symbol_c *result_type, bool *deprecated_status) {
 	/* NOTE: According to our algorithm, left_type and right_type should never by NULL (if they are, we have an internal compiler error!
 	 *       However, result_type may be NULL if the code has a data type semantic error!
 	 */
 	if ((NULL == left_type) || (NULL == right_type) || (NULL == result_type))
 		return false;
 
-	for (int k = 0; NULL != widen_table[k].left;  k++) {
-		if        ((typeid(*left_type)   == typeid(*widen_table[k].left))
-		        && (typeid(*right_type)  == typeid(*widen_table[k].right))
-			&& (typeid(*result_type) == typeid(*widen_table[k].result))) {
-			if (NULL != deprecated_status)
-				*deprecated_status = (widen_table[k].status == widen_entry::deprecated);
-			return true;
-		}
-	}
-	return false;
+	const struct widen_entry *entry = widen_table.search(left_type, right_type, result_type);
+	if (NULL == entry)
+		return false;
+	if (NULL != deprecated_status)
+		*deprecated_status = (entry->status == widen_entry::deprecated);
+	return true;
 }
 
 /*
@@ -305,6 +301,10 @@ void narrow_candidate_datatypes_c::narrow_function_invocation(symbol_c *fcall, g
 	if (NULL != fcall_data.nonformal_operand_list)  narrow_nonformal_call(fcall, fcall_data.called_function_declaration, &(fcall_data.extensible_param_count));
 	if (NULL != fcall_data.   formal_operand_list)     narrow_formal_call(fcall, fcall_data.called_function_declaration, &(fcall_data.extensible_param_count));
 
+	/* Now that we know which function is being called, resolve the binding of each of its parameters
+	 * to the values being passed, so stage 4 need not do this again.
+	 */
+	call_param_bindings_c::get(fcall, fcall_data.called_function_declaration);
 	return;
 }
 
@@ -1194,6 +1194,7 @@ void *narrow_candidate_datatypes_c::visit(il_fb_call_c *symbol) {
 	if (NULL == fb_decl) ERROR;
 	if (NULL != symbol->il_operand_list)  narrow_nonformal_call(symbol, fb_decl);
 	if (NULL != symbol->  il_param_list)     narrow_formal_call(symbol, fb_decl);
+	call_param_bindings_c::get(symbol, fb_decl);
 
 	/* Let the il_call_operator (CAL, CALC, or CALCN) set the datatype of prev_il_instruction... */
 	symbol->il_call_operator->datatype = symbol->datatype;
@@ -1319,7 +1320,7 @@ void *narrow_candidate_datatypes_c::set_il_operand_datatype(symbol_c *il_operand
 
 
 
-void *narrow_candidate_datatypes_c::narrow_binary_operator(const struct widen_entry widen_table[], symbol_c *symbol, bool *deprecated_operation) {
+void *narrow_candidate_datatypes_c::narrow_binary_operator(widen_table_c &widen_table, symbol_c *symbol, bool *deprecated_operation) {
 	symbol_c *prev_instruction_type, *operand_type;
 	int count = 0;
 
@@ -1572,7 +1573,7 @@ void *narrow_candidate_datatypes_c::visit(  ref_expression_c  *symbol) {
  *            symbol := l_expr != r_expr
  *  In the above situation it is a legal operation when (l_expr.datatype == r_expr.datatype) && is_enumerated(r/l_expr.datatype) && is_bool(symbol.datatype)
  */
-void *narrow_candidate_datatypes_c::narrow_binary_expression(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation, bool allow_enums) {
+void *narrow_candidate_datatypes_c::narrow_binary_expression(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation, bool allow_enums) {
 	symbol_c *l_type, *r_type;
 	int count = 0;
 
@@ -1609,7 +1610,7 @@ void *narrow_candidate_datatypes_c::narrow_binary_expression(const struct widen_
 }
 
 
-void *narrow_candidate_datatypes_c::narrow_equality_comparison(const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation) {
+void *narrow_candidate_datatypes_c::narrow_equality_comparison(widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation) {
 	return narrow_binary_expression(widen_table, symbol, l_expr, r_expr, deprecated_operation, true);
 }
 
@@ -1707,6 +1708,7 @@ void *narrow_candidate_datatypes_c::visit(fb_invocation_c *symbol) {
 	if (NULL == fb_decl) ERROR;
 	if (NULL != symbol->nonformal_param_list)  narrow_nonformal_call(symbol, fb_decl);
 	if (NULL != symbol->   formal_param_list)     narrow_formal_call(symbol, fb_decl);
+	call_param_bindings_c::get(symbol, fb_decl);
 
 	return NULL;
 }
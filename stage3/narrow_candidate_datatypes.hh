@@ -73,7 +73,7 @@ class narrow_candidate_datatypes_c: public iterator_visitor_c {
     virtual void set_datatype_in_prev_il_instructions(symbol_c *datatype, il_instruction_c *symbol);
 
   private:
-    bool is_widening_compatible(const struct widen_entry widen_table[], symbol_c *left_type, symbol_c *right_type, symbol_c *result_type, bool *deprecated_status = NULL);
+    bool is_widening_compatible(widen_table_c &widen_table, symbol_c *left_type, symbol_c *right_type, symbol_c *result_type, bool *deprecated_status = NULL);
 
     void *narrow_spec_init           (symbol_c *symbol, symbol_c *type_decl, symbol_c *init_value);
     void *narrow_type_decl           (symbol_c *symbol, symbol_c *type_name, symbol_c *spec_init);
@@ -84,9 +84,9 @@ class narrow_candidate_datatypes_c: public iterator_visitor_c {
     void *narrow_S_and_R_operator    (symbol_c *symbol, const char *param_name, symbol_c * called_fb_declaration);
     void *narrow_store_operator      (symbol_c *symbol);
     void *narrow_conditional_operator(symbol_c *symbol);
-    void *narrow_binary_operator     (const struct widen_entry widen_table[], symbol_c *symbol,                                     bool *deprecated_operation = NULL);
-    void *narrow_binary_expression   (const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation = NULL, bool allow_enums = false);
-    void *narrow_equality_comparison (const struct widen_entry widen_table[], symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation = NULL);
+    void *narrow_binary_operator     (widen_table_c &widen_table, symbol_c *symbol,                                     bool *deprecated_operation = NULL);
+    void *narrow_binary_expression   (widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation = NULL, bool allow_enums = false);
+    void *narrow_equality_comparison (widen_table_c &widen_table, symbol_c *symbol, symbol_c *l_expr, symbol_c *r_expr, bool *deprecated_operation = NULL);
     void *narrow_var_declaration     (symbol_c *type);
 
     void *set_il_operand_datatype    (symbol_c *il_operand, symbol_c *datatype);
@@ -46,6 +46,8 @@
 #include "declaration_check.hh"
 #include "enum_declaration_check.hh"
 #include "remove_forward_dependencies.hh"
+#include "en_eno_analysis.hh"
+#include "function_evaluation.hh"
 
 
 
@@ -108,6 +110,16 @@ static int type_safety(symbol_c *tree_root){
 }
 
 
+/* Folding the REAL expressions in single precision assumes that data type analysis (and constant folding)
+ * has already been completed, so be sure to call type_safety() before calling this function
+ */
+static int real_constant_folding(symbol_c *tree_root){
+	real_constant_folding_c real_constant_folding(tree_root);
+	tree_root->accept(real_constant_folding);
+	return 0;
+}
+
+
 /* Left value checking assumes that data type analysis has already been completed,
  * so be sure to call type_safety() before calling this function
  */
@@ -137,6 +149,29 @@ static int case_elements_check(symbol_c *tree_root){
 }
 
 
+/* EN/ENO usage analysis assumes that data type analysis has already been completed,
+ * (it uses the called POU and parameter bindings of each invocation) so be sure to 
+ * call type_safety() before calling this function
+ */
+static int en_eno_analysis(symbol_c *tree_root){
+	en_eno_analysis_c en_eno_analysis(tree_root);
+	tree_root->accept(en_eno_analysis);
+	return 0;
+}
+
+
+/* Evaluating Function invocations at compile time assumes that data type analysis has already been
+ * completed (it uses the called Function, the datatype of each expression, and the parameter bindings
+ * of each invocation), as well as constant folding, so be sure to call type_safety() before calling
+ * this function.
+ */
+static int function_evaluation(symbol_c *tree_root){
+	function_evaluation_c function_evaluation(tree_root);
+	tree_root->accept(function_evaluation);
+	return 0;
+}
+
+
 /* Removing forward dependencies only makes sense when stage1_2 is run with the pre-parsing option.
  * This algorithm has no dependencies on other stage 3 algorithms.
  * Typically this is run last, just to show that the remaining algorithms also do not depend on the fact that 
@@ -162,9 +197,12 @@ int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root) {
 	error_count += constant_propagation(tree_root);
 	error_count += declaration_safety(tree_root);
 	error_count += type_safety(tree_root);
+	error_count += real_constant_folding(tree_root);
 	error_count += lvalue_check(tree_root);
 	error_count += array_range_check(tree_root);
 	error_count += case_elements_check(tree_root);
+	error_count += en_eno_analysis(tree_root);
+	error_count += function_evaluation(tree_root);
 	error_count += remove_forward_dependencies(tree_root, ordered_tree_root);
 	
 	if (error_count > 0) {
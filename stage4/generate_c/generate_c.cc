@@ -89,6 +89,17 @@
 /* Idem as body, but for run CONFIG and RESOURCE function */
 #define FB_RUN_SUFFIX "_run__"
 
+/* Idem as body, but for the layout descriptor and the state migration function of a FB or Program (see generate_c_layout.cc) */
+#define FB_LAYOUT_SUFFIX "_layout__"
+#define FB_LAYOUT_VARS_SUFFIX "_layout_vars__"
+#define FB_MIGRATE_SUFFIX "_migrate__"
+
+/* Idem as body, but for the function that copies the RETAIN variables of a FB or Program to/from the retain image (see generate_c_retain.cc) */
+#define FB_RETAIN_SUFFIX "_retain__"
+
+/* Idem as body, but for the profiling table entry of a POU or program instance (see generate_c_profile.cc) */
+#define FB_PROFILE_SUFFIX "_profile__"
+
 /* The FB body function is passed as the only parameter a pointer to the FB data
  * structure instance. The name of this parameter is given by the following constant.
  * In order not to clash with any variable in the IL and ST source codem the
@@ -117,6 +128,21 @@
 #define DECLARE_LOCATED "__DECLARE_LOCATED"
 #define DECLARE_GLOBAL_PROTOTYPE "__DECLARE_GLOBAL_PROTOTYPE"
 
+/* Layout descriptor entry symbol for layout macros (see generate_c_layout.cc) */
+#define LAYOUT_POU "__LAYOUT_POU"
+#define LAYOUT_VAR "__LAYOUT_VAR"
+#define LAYOUT_FB "__LAYOUT_FB"
+#define LAYOUT_STEP "__LAYOUT_STEP"
+#define LAYOUT_ACTION "__LAYOUT_ACTION"
+
+/* Retain image entry symbol for retain macros (see generate_c_retain.cc) */
+#define RETAIN_VAR "__RETAIN_VAR"
+
+/* Profiling symbols for profiling macros (see generate_c_profile.cc) */
+#define PROFILE_ENTRY "__PROFILE_ENTRY"
+#define PROFILE_BEGIN "__PROFILE_BEGIN"
+#define PROFILE_END "__PROFILE_END"
+
 /* Variable declaration symbol for accessor macros */
 #define INIT_VAR "__INIT_VAR"
 #define INIT_GLOBAL "__INIT_GLOBAL"
@@ -165,6 +191,12 @@
 #define VAR_LEADER "__"
 #define TEMP_VAR VAR_LEADER "TMP_"
 #define SOURCE_VAR VAR_LEADER "SRC_"
+/* Name of the C local variable holding a promoted FB/Program variable (see generate_c_promoted_vars.cc) */
+#define PROMOTED_VAR VAR_LEADER "REG_"
+/* Name of the C pointer to the table of an array accessed in a vectorised FOR loop (see generate_c_vector_loops.cc) */
+#define VECTOR_VAR VAR_LEADER "VEC_"
+/* Name of the static initial value image of a FB type (see generate_c_init_image.cc) */
+#define INIT_IMAGE VAR_LEADER "init_image"
 
 /* please see the comment before the RET_operator_c visitor for details... */
 #define END_LABEL VAR_LEADER "end"
@@ -179,6 +211,16 @@
 static int generate_line_directives__ = 0;
 static int generate_pou_filepairs__   = 0;
 static int generate_plc_state_backup_fuctions__ = 0;
+static int generate_register_promotion__ = 0;
+static int generate_fb_specialization__ = 0;
+static int generate_dead_pou_elimination__ = 0;
+static int generate_dead_var_elimination__ = 0;
+static int generate_sfc_active_steps__ = 0;
+static int generate_sfc_packed_state__ = 0;
+static int generate_vector_loops__ = 0;
+static int generate_online_change__ = 0;
+static int generate_profiling__ = 0;
+static int generate_function_profiling__ = 0;
 
 #ifdef __unix__
 /* Parse command line options passed from main.c !! */
@@ -186,12 +228,32 @@ static int generate_plc_state_backup_fuctions__ = 0;
 int  stage4_parse_options(char *options) {
   enum {LINE_OPT = 0,  
         SEPTFILE_OPT,
-        BACKUP_OPT    /* option to generate function to backup and restore internal PLC state */
+        BACKUP_OPT,   /* option to generate function to backup and restore internal PLC state */
+        REGPROMO_OPT, /* option to promote FB/Program variables to C local variables */
+        FBSPEC_OPT,   /* option to specialise FB bodies for instances with constant inputs */
+        DEADPOU_OPT,  /* option to only generate the POUs reachable from the configuration */
+        DEADVAR_OPT,  /* option to remove unreferenced variables from FB/Program data structures */
+        SFCACTIVE_OPT,/* option to execute SFCs by keeping track of the active steps */
+        SFCPACKED_OPT,/* option to pack the SFC step and transition state into bits */
+        VECTOR_OPT,   /* option to generate vectorisation hints for FOR loops over arrays */
+        ONLINE_OPT,   /* option to generate the layout descriptors and state migration functions of FBs and Programs */
+        PROFILE_OPT,  /* option to measure the execution time of each FB, Program and program instance */
+        FPROFILE_OPT  /* option to also measure the execution time of each Function */
         /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
   char *const token[] = {
         /*       LINE_OPT*/(char *)"l",
         /*   SEPTFILE_OPT*/(char *)"p",
         /*     BACKUP_OPT*/(char *)"b",
+        /*   REGPROMO_OPT*/(char *)"r",
+        /*     FBSPEC_OPT*/(char *)"s",
+        /*    DEADPOU_OPT*/(char *)"d",
+        /*    DEADVAR_OPT*/(char *)"v",
+        /*  SFCACTIVE_OPT*/(char *)"a",
+        /*  SFCPACKED_OPT*/(char *)"k",
+        /*     VECTOR_OPT*/(char *)"x",
+        /*     ONLINE_OPT*/(char *)"o",
+        /*    PROFILE_OPT*/(char *)"t",
+        /*   FPROFILE_OPT*/(char *)"f",
         /* SOME_OTHER_OPT, ...             */
         NULL };
   /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
@@ -205,9 +267,24 @@ int  stage4_parse_options(char *options) {
       case     LINE_OPT: generate_line_directives__            = 1; break;
       case SEPTFILE_OPT: generate_pou_filepairs__              = 1; break;
       case   BACKUP_OPT: generate_plc_state_backup_fuctions__  = 1; break;
+      case REGPROMO_OPT: generate_register_promotion__         = 1; break;
+      case   FBSPEC_OPT: generate_fb_specialization__          = 1; break;
+      case  DEADPOU_OPT: generate_dead_pou_elimination__       = 1; break;
+      case  DEADVAR_OPT: generate_dead_var_elimination__       = 1; break;
+      case SFCACTIVE_OPT: generate_sfc_active_steps__          = 1; break;
+      case SFCPACKED_OPT: generate_sfc_packed_state__          = 1; break;
+      case   VECTOR_OPT: generate_vector_loops__               = 1; break;
+      case   ONLINE_OPT: generate_online_change__              = 1; break;
+      case  PROFILE_OPT: generate_profiling__                  = 1; break;
+      case FPROFILE_OPT: generate_profiling__                  = 1;
+                         generate_function_profiling__         = 1; break;
       default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
      }
   }     
+  if (generate_sfc_active_steps__ && generate_sfc_packed_state__) {
+    fprintf(stderr, "Options -O a and -O k may not be used together.\n"); 
+    return -1;
+  }
   return 0;
 }
 
@@ -217,6 +294,22 @@ void stage4_print_options(void) {
   printf("      l : insert '#line' directives in generated C code.\n"); 
   printf("      p : place each POU in a separate pair of files (<pou_name>.c, <pou_name>.h).\n"); 
   printf("      b : generate functions to backup and restore internal PLC state.\n"); 
+  printf("      r : keep FB/program local variables in C local variables while the POU executes\n"); 
+  printf("          (a forced value is loaded at every invocation; writes to forced variables are discarded).\n"); 
+  printf("      s : generate specialised FB bodies for FB instances whose inputs are always passed the same constant.\n"); 
+  printf("      d : only generate code for the POUs used (directly or indirectly) by the configuration.\n"); 
+  printf("      v : remove unreferenced FB/program local variables (these will not be visible to the debugger).\n"); 
+  printf("      a : execute SFCs by keeping track of the active steps, instead of scanning every step, transition and action\n"); 
+  printf("          in each cycle (forcing steps, or transitions leaving inactive steps, with the debugger has no effect).\n"); 
+  printf("      k : pack the SFC step and transition state into bits, and only keep the elapsed time of the steps that use it\n"); 
+  printf("          (forcing steps with the debugger has no effect; may not be used together with 'a').\n"); 
+  printf("      x : access arrays through restrict pointers, and mark the loop as free of loop carried dependencies,\n"); 
+  printf("          in FOR loops over arrays that are generated as C for loops (see also 'r').\n"); 
+  printf("      o : generate a layout descriptor and a state migration function for each FB and program, so that a\n"); 
+  printf("          runtime may replace the code without losing the state of the FB and program instances.\n"); 
+  printf("      t : measure the execution time of each FB, program and program instance, and generate functions to\n"); 
+  printf("          read and reset the resulting profiling table.\n"); 
+  printf("      f : also measure the execution time of each function (implies 't').\n"); 
 }
 #else /* not __unix__ */
 /* getsubopt isn't supported with mingw, 
@@ -230,13 +323,23 @@ int  stage4_parse_options(char *options) {}
 /***********************************************************************/
 /***********************************************************************/
 
+#include "generate_c_promoted_vars.cc"
+#include "generate_c_byref_inputs.cc"
+#include "generate_c_init_image.cc"
+#include "generate_c_dead_code.cc"
+#include "generate_c_fb_specialization.cc"
+#include "generate_c_sfc_timed_steps.cc"
+#include "generate_c_vector_loops.cc"
 #include "generate_c_base.cc"
 #include "generate_c_typedecl.cc"
 #include "generate_c_sfcdecl.cc"
-#include "generate_c_vardecl.cc"
-#include "generate_c_configbody.cc"
 #include "generate_location_list.cc"
 #include "generate_var_list.cc"
+#include "generate_c_layout.cc"
+#include "generate_c_retain.cc"
+#include "generate_c_profile.cc"
+#include "generate_c_vardecl.cc"
+#include "generate_c_configbody.cc"
 
 /***********************************************************************/
 /***********************************************************************/
@@ -688,9 +791,12 @@ class generate_c_SFC_IL_ST_c: public null_visitor_c {
     symbol_c *scope;
     symbol_c *fbname;
     const char *variable_prefix;
+    const promoted_vars_t *promoted_vars;
+    const specialized_inputs_t *specialized_inputs;
 
   public:
-    generate_c_SFC_IL_ST_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL);
+    generate_c_SFC_IL_ST_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL,
+                           const promoted_vars_t *promoted_vars = NULL, const specialized_inputs_t *specialized_inputs = NULL);
     
     /********************/
     /* 2.1.6 - Pragmas  */
@@ -734,12 +840,15 @@ class generate_c_SFC_IL_ST_c: public null_visitor_c {
 
 #include "generate_c_sfc.cc"
 
-generate_c_SFC_IL_ST_c::generate_c_SFC_IL_ST_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix) {
+generate_c_SFC_IL_ST_c::generate_c_SFC_IL_ST_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix,
+                                               const promoted_vars_t *promoted_vars, const specialized_inputs_t *specialized_inputs) {
   if (NULL == scope) ERROR;
   this->s4o_ptr = s4o_ptr;
   this->scope = scope;
   this->fbname = name;
   this->variable_prefix = variable_prefix;
+  this->promoted_vars = promoted_vars;
+  this->specialized_inputs = specialized_inputs;
 }
 
 void *generate_c_SFC_IL_ST_c::visit(sequential_function_chart_c * symbol) {
@@ -750,12 +859,18 @@ void *generate_c_SFC_IL_ST_c::visit(sequential_function_chart_c * symbol) {
 
 void *generate_c_SFC_IL_ST_c::visit(instruction_list_c *symbol) {
   generate_c_il_c generate_c_il(s4o_ptr, fbname, scope, variable_prefix);
+  generate_c_il.set_promoted_vars(promoted_vars);
+  generate_c_il.set_byref_inputs(generate_c_byref_inputs_c::get(scope));
+  generate_c_il.set_specialized_inputs(specialized_inputs);
   generate_c_il.generate(symbol);
   return NULL;
 }
 
 void *generate_c_SFC_IL_ST_c::visit(statement_list_c *symbol) {
   generate_c_st_c generate_c_st(s4o_ptr, fbname, scope, variable_prefix);
+  generate_c_st.set_promoted_vars(promoted_vars);
+  generate_c_st.set_byref_inputs(generate_c_byref_inputs_c::get(scope));
+  generate_c_st.set_specialized_inputs(specialized_inputs);
   generate_c_st.generate(symbol);
   return NULL;
 }
@@ -803,6 +918,74 @@ class generate_c_pous_c {
       s4o.print(":\n");
       s4o.indent_right();
     }
+
+    /* Declare, load, or store back the FB/Program variables promoted to C local variables.
+     * Please see generate_c_promoted_vars.cc for details...
+     */
+    typedef enum {declare_pv, load_pv, store_pv} promoted_vars_action_t;
+
+    static void print_promoted_vars(stage4out_c &s4o, const promoted_vars_t &promoted_vars, promoted_vars_action_t action) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      promoted_vars_t::const_iterator it;
+
+      for (it = promoted_vars.begin(); it != promoted_vars.end(); it++) {
+        s4o.print(s4o.indent_spaces);
+        switch (action) {
+          case declare_pv:
+            it->second->accept(print_base);
+            s4o.print(" " PROMOTED_VAR);
+            s4o.printupper(it->first);
+            s4o.print(";\n");
+            break;
+          case load_pv:
+            s4o.print(PROMOTED_VAR);
+            s4o.printupper(it->first);
+            s4o.print(" = " GET_VAR "(" FB_FUNCTION_PARAM "->");
+            s4o.printupper(it->first);
+            s4o.print(",);\n");
+            break;
+          case store_pv:
+            s4o.print(SET_VAR "(" FB_FUNCTION_PARAM "->,");
+            s4o.printupper(it->first);
+            s4o.print(",," PROMOTED_VAR);
+            s4o.printupper(it->first);
+            s4o.print(");\n");
+            break;
+        }
+      }
+    }
+
+    /* Print the declaration (if print_declaration is true) or the definition of the profiling table
+     * entry of the POU <pou_name>, or the code that measures the execution time of its body.
+     * Please see generate_c_profile.cc for details...
+     */
+    static void print_profile_entry(symbol_c *pou_name, stage4out_c &s4o, bool print_declaration) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      if (!generate_c_profile_c::is_profiled(pou_name)) return;
+      if (print_declaration) s4o.print("extern ");
+      s4o.print("__profile_entry_t ");
+      pou_name->accept(print_base);
+      s4o.print(FB_PROFILE_SUFFIX);
+      if (!print_declaration) {
+        s4o.print(" = " PROFILE_ENTRY "(\"");
+        pou_name->accept(print_base);
+        s4o.print("\")");
+      }
+      s4o.print(";\n");
+    }
+
+    static void print_profile_begin(symbol_c *pou_name, stage4out_c &s4o) {
+      if (!generate_c_profile_c::is_profiled(pou_name)) return;
+      s4o.print(s4o.indent_spaces + PROFILE_BEGIN "\n");
+    }
+
+    static void print_profile_end(symbol_c *pou_name, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      if (!generate_c_profile_c::is_profiled(pou_name)) return;
+      s4o.print(s4o.indent_spaces + PROFILE_END "(");
+      pou_name->accept(print_base);
+      s4o.print(FB_PROFILE_SUFFIX ")\n");
+    }
   
 
     /*************/
@@ -824,6 +1007,8 @@ class generate_c_pous_c {
       TRACE("function_declaration_c");
     
       /* (A) Function declaration... */
+      /* (A.0) Profiling table entry */
+      print_profile_entry(symbol->derived_function_name, s4o, print_declaration);
       /* (A.1) Function return type */
       s4o.print("// FUNCTION\n");
       symbol->type_name->accept(print_base); /* return type */
@@ -841,7 +1026,7 @@ class generate_c_pous_c {
                                          generate_c_vardecl_c::inoutput_vt |
                                          generate_c_vardecl_c::en_vt       |
                                          generate_c_vardecl_c::eno_vt);
-      vardecl->print(symbol->var_declarations_list);
+      vardecl->print(symbol->var_declarations_list, symbol);
       delete vardecl;
       
       s4o.indent_left();
@@ -925,12 +1110,14 @@ class generate_c_pous_c {
       
       
       // Only generate the code that controls the execution of the function's body if the
-      // function contains a declaration of both the EN and ENO variables
+      // function contains a declaration of both the EN and ENO variables, and some invocation
+      // of this function actually passes a value to EN (otherwise EN is always TRUE)
       search_var_instance_decl_c search_var(symbol);
       identifier_c  en_var("EN");
       identifier_c eno_var("ENO");
       if (   (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
-          && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)) {
+          && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)
+          && (symbol->en_eno_usage.en_used)) {
         s4o.print(s4o.indent_spaces + "// Control execution\n");
         s4o.print(s4o.indent_spaces + "if (!EN) {\n");
         s4o.indent_right();
@@ -947,6 +1134,7 @@ class generate_c_pous_c {
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "}\n");
       }
+      print_profile_begin(symbol->derived_function_name, s4o);
     
       /* (C) Function body */
       generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->derived_function_name, symbol);
@@ -961,6 +1149,7 @@ class generate_c_pous_c {
                     generate_c_vardecl_c::eno_vt);
       vardecl->print(symbol->var_declarations_list);
       delete vardecl;
+      print_profile_end(symbol->derived_function_name, s4o);
       
       if (!get_datatype_info_c::is_VOID(symbol->type_name->datatype)) { // only print 'return <fname>' if return datatype is not VOID
         s4o.print(s4o.indent_spaces + "return ");
@@ -975,9 +1164,212 @@ class generate_c_pous_c {
     }
     
     
+    /* Print the declaration (if print_declaration is true) or the definition of the function that copies
+     * the RETAIN variables of the FB or Program <pou_name>, of types <vartypes>, to/from the retain image.
+     * Please see generate_c_retain.cc for details...
+     */
+    static void print_retain_function(symbol_c *pou_name, symbol_c *var_declarations, unsigned int vartypes,
+                                      stage4out_c &s4o, bool print_declaration) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+
+      if (!generate_c_retain_c::has_retain(pou_name)) return;
+
+      if (!print_declaration)
+        s4o.print("// Copy the RETAIN variables to/from the retain image\n");
+      s4o.print("void ");
+      pou_name->accept(print_base);
+      s4o.print(FB_RETAIN_SUFFIX "(");
+      pou_name->accept(print_base);
+      s4o.print(" *" FB_FUNCTION_PARAM ", __retain_image_t *image, BOOL backup, BOOL retain)");
+      if (print_declaration) {
+        s4o.print(";\n");
+        return;
+      }
+      s4o.print(" {\n");
+      s4o.indent_right();
+      generate_c_vardecl_c vardecl(&s4o, generate_c_vardecl_c::retain_vf, vartypes);
+      vardecl.print(var_declarations, NULL, FB_FUNCTION_PARAM"->");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+    }
+
+
+    /* Print the declaration (if print_declaration is true) or the definition of the layout descriptor
+     * and the state migration function of the FB or Program <symbol>, whose variables of types <vartypes>
+     * hold state between invocations.
+     * Please see generate_c_layout.cc for details...
+     */
+    static void print_layout(symbol_c *symbol, symbol_c *pou_name, symbol_c *var_declarations, symbol_c *body,
+                             unsigned int vartypes, stage4out_c &s4o, bool print_declaration) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+
+      if (!generate_c_layout_c::has_layout(pou_name)) return;
+
+      if (print_declaration) {
+        s4o.print("extern const __pou_layout_t ");
+        pou_name->accept(print_base);
+        s4o.print(FB_LAYOUT_SUFFIX ";\n");
+      } else {
+        /* (D.1) Layout descriptor entries */
+        s4o.print("// Layout of the data structure, for online change\n");
+        s4o.print("#define " LAYOUT_POU " ");
+        pou_name->accept(print_base);
+        s4o.print("\nstatic const __pou_layout_var_t ");
+        pou_name->accept(print_base);
+        s4o.print(FB_LAYOUT_VARS_SUFFIX "[] = {\n");
+        s4o.indent_right();
+        generate_c_vardecl_c vardecl(&s4o, generate_c_vardecl_c::layout_vf, vartypes);
+        vardecl.print(var_declarations);
+        generate_c_sfcdecl_c sfcdecl(&s4o, symbol);
+        sfcdecl.generate(body, generate_c_sfcdecl_c::layout_sd);
+        s4o.print(s4o.indent_spaces + "{NULL, NULL, 0, 0, NULL}\n");
+        s4o.indent_left();
+        s4o.print("};\n#undef " LAYOUT_POU "\n");
+
+        /* (D.2) Layout descriptor */
+        char hash[32];
+        sprintf(hash, "0x%08lXUL", generate_c_layout_c::get_hash(symbol));
+        s4o.print("const __pou_layout_t ");
+        pou_name->accept(print_base);
+        s4o.print(FB_LAYOUT_SUFFIX " = {\"");
+        pou_name->accept(print_base);
+        s4o.print("\", ");
+        s4o.print(hash);
+        s4o.print(", sizeof(");
+        pou_name->accept(print_base);
+        s4o.print("), sizeof(");
+        pou_name->accept(print_base);
+        s4o.print(FB_LAYOUT_VARS_SUFFIX ") / sizeof(__pou_layout_var_t) - 1, ");
+        pou_name->accept(print_base);
+        s4o.print(FB_LAYOUT_VARS_SUFFIX "};\n\n");
+      }
+
+      /* (D.3) State migration function */
+      s4o.print("unsigned long ");
+      pou_name->accept(print_base);
+      s4o.print(FB_MIGRATE_SUFFIX "(");
+      pou_name->accept(print_base);
+      s4o.print(" *" FB_FUNCTION_PARAM ", const void *old_data, const __pou_layout_t *old_layout, BOOL retain)");
+      if (print_declaration) {
+        s4o.print(";\n");
+        return;
+      }
+      s4o.print(" {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces);
+      pou_name->accept(print_base);
+      s4o.print(FB_INIT_SUFFIX "(" FB_FUNCTION_PARAM ", retain);\n");
+      s4o.print(s4o.indent_spaces + "return __pou_migrate(" FB_FUNCTION_PARAM ", &");
+      pou_name->accept(print_base);
+      s4o.print(FB_LAYOUT_SUFFIX ", old_data, old_layout);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+    }
+
+
     /*******************/
     /* Function Blocks */
     /*******************/
+  private:
+    /* Print the declaration (if print_declaration is true) or the definition of the function with the body of
+     * the FB <symbol>, or of its <specialization> for instances whose inputs are always constant.
+     */
+    static void print_function_block_body(function_block_declaration_c *symbol, stage4out_c &s4o, bool print_declaration,
+                                          const generate_c_fb_specialization_c::specialization_t *specialization = NULL) {
+      generate_c_vardecl_c          *vardecl;
+      generate_c_base_and_typeid_c   print_base(&s4o);
+      std::string suffix = (NULL != specialization)? specialization->suffix : std::string("");
+
+      promoted_vars_t promoted_vars;
+      generate_c_promoted_vars_c::get(symbol, symbol->fblock_body, promoted_vars);
+
+      /* function interface */
+      s4o.print("void ");
+      symbol->fblock_name->accept(print_base);
+      s4o.print(suffix);
+      s4o.print(FB_FUNCTION_SUFFIX);
+      s4o.print("(");
+      /* first and only parameter is a pointer to the data */
+      symbol->fblock_name->accept(print_base);
+      s4o.print(" *");
+      s4o.print(FB_FUNCTION_PARAM);
+      s4o.print(")");
+
+      if (print_declaration) {
+        s4o.print(";\n");
+        return;
+      }
+
+      s4o.print(" {\n");
+      s4o.indent_right();
+
+      print_promoted_vars(s4o, promoted_vars, declare_pv);
+
+      // Only generate the code that controls the execution of the function's body if the
+      // function contains a declaration of both the EN and ENO variables, and these are
+      // used somewhere (otherwise EN is always TRUE, and nobody cares about the value of ENO)
+      search_var_instance_decl_c search_var(symbol);
+      identifier_c  en_var("EN");
+      identifier_c eno_var("ENO");
+      if (   (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
+          && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)
+          && (symbol->en_eno_usage.en_used || symbol->en_eno_usage.eno_used)) {
+
+        s4o.print(s4o.indent_spaces + "// Control execution\n");
+        s4o.print(s4o.indent_spaces + "if (!");
+        s4o.print(GET_VAR);
+        s4o.print("(");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print("->EN)) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        s4o.print(SET_VAR);
+        s4o.print("(");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print("->,ENO,,__BOOL_LITERAL(FALSE));\n");
+        s4o.print(s4o.indent_spaces + "return;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.print(s4o.indent_spaces + "else {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        s4o.print(SET_VAR);
+        s4o.print("(");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print("->,ENO,,__BOOL_LITERAL(TRUE));\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+      print_profile_begin(symbol->fblock_name, s4o);
+    
+      /* (C.4) Initialize TEMP variables */
+      /* function body */
+      s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
+      vardecl = new generate_c_vardecl_c(&s4o,
+                                         generate_c_vardecl_c::init_vf,
+                                         generate_c_vardecl_c::temp_vt);
+      vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
+      delete vardecl;
+      print_promoted_vars(s4o, promoted_vars, load_pv);
+      s4o.print("\n");
+    
+      /* (C.5) Function code */
+      generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->", &promoted_vars,
+                                             (NULL != specialization)? &specialization->inputs : NULL);
+      symbol->fblock_body->accept(generate_c_code);
+      print_end_of_block_label(s4o);
+      print_promoted_vars(s4o, promoted_vars, store_pv);
+      print_profile_end(symbol->fblock_name, s4o);
+      s4o.print(s4o.indent_spaces + "return;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "} // ");
+      symbol->fblock_name->accept(print_base);
+      s4o.print(suffix);
+      s4o.print(FB_FUNCTION_SUFFIX);
+      s4o.print(s4o.indent_spaces + "() \n\n");
+    }
+
+
   public:
     /* NOTE: The following function will be called twice:
      *         1st time:  s4o will reference the .h file, and print_declaration=true
@@ -1064,6 +1456,21 @@ class generate_c_pous_c {
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
+
+        /* (B.1.1) Copy the initial value image, if already available (see generate_c_init_image.cc) */
+        bool init_image = generate_c_init_image_c::is_imageable(symbol);
+        if (init_image) {
+          s4o.print(s4o.indent_spaces + "static ");
+          symbol->fblock_name->accept(print_base);
+          s4o.print(" " INIT_IMAGE "[2];\n");
+          s4o.print(s4o.indent_spaces + "static BOOL " INIT_IMAGE "_valid[2] = {0, 0};\n");
+          s4o.print(s4o.indent_spaces + "if (" INIT_IMAGE "_valid[retain != 0]) {\n");
+          s4o.indent_right();
+          s4o.print(s4o.indent_spaces + "memcpy(" FB_FUNCTION_PARAM ", &" INIT_IMAGE "[retain != 0], sizeof(*" FB_FUNCTION_PARAM "));\n");
+          s4o.print(s4o.indent_spaces + "return;\n");
+          s4o.indent_left();
+          s4o.print(s4o.indent_spaces + "}\n");
+        }
       
         /* (B.2) Member initializations... */
         s4o.print(s4o.indent_spaces);
@@ -1084,6 +1491,12 @@ class generate_c_pous_c {
         /* (B.3) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::sfcinit_sd);
+
+        /* (B.4) Keep the initial value image, to initialise the following instances */
+        if (init_image) {
+          s4o.print(s4o.indent_spaces + "memcpy(&" INIT_IMAGE "[retain != 0], " FB_FUNCTION_PARAM ", sizeof(*" FB_FUNCTION_PARAM "));\n");
+          s4o.print(s4o.indent_spaces + INIT_IMAGE "_valid[retain != 0] = 1;\n");
+        }
       
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "}\n\n");
@@ -1099,78 +1512,29 @@ class generate_c_pous_c {
       
       /* (C.3) Function declaration */
       s4o.print("// Code part\n");
-      /* function interface */
-      s4o.print("void ");
-      symbol->fblock_name->accept(print_base);
-      s4o.print(FB_FUNCTION_SUFFIX);
-      s4o.print("(");
-      /* first and only parameter is a pointer to the data */
-      symbol->fblock_name->accept(print_base);
-      s4o.print(" *");
-      s4o.print(FB_FUNCTION_PARAM);
-      s4o.print(")");
+      print_profile_entry(symbol->fblock_name, s4o, print_declaration);
+      print_function_block_body(symbol, s4o, print_declaration);
+      /* (C.3.1) Specialised bodies, for FB instances whose inputs are always constant (see generate_c_fb_specialization.cc) */
+      for (unsigned int i = 0; i < generate_c_fb_specialization_c::get_count(symbol); i++)
+        print_function_block_body(symbol, s4o, print_declaration, generate_c_fb_specialization_c::get(symbol, i));
+
+      /* (D) Layout descriptor and state migration function, for online change */
+      print_layout(symbol, symbol->fblock_name, symbol->var_declarations, symbol->fblock_body,
+                   generate_c_vardecl_c::input_vt  |
+                   generate_c_vardecl_c::output_vt |
+                   generate_c_vardecl_c::private_vt|
+                   generate_c_vardecl_c::en_vt     |
+                   generate_c_vardecl_c::eno_vt,
+                   s4o, print_declaration);
+
+      /* (E) Copy of the RETAIN variables to/from the retain image */
+      print_retain_function(symbol->fblock_name, symbol->var_declarations,
+                            generate_c_vardecl_c::input_vt  |
+                            generate_c_vardecl_c::output_vt |
+                            generate_c_vardecl_c::private_vt,
+                            s4o, print_declaration);
 
-      if (print_declaration) {
-        s4o.print(";\n");
-      } else {
-        s4o.print(" {\n");
-        s4o.indent_right();
-
-        // Only generate the code that controls the execution of the function's body if the
-        // function contains a declaration of both the EN and ENO variables
-        search_var_instance_decl_c search_var(symbol);
-        identifier_c  en_var("EN");
-        identifier_c eno_var("ENO");
-        if (   (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
-            && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)) {
-
-          s4o.print(s4o.indent_spaces + "// Control execution\n");
-          s4o.print(s4o.indent_spaces + "if (!");
-          s4o.print(GET_VAR);
-          s4o.print("(");
-          s4o.print(FB_FUNCTION_PARAM);
-          s4o.print("->EN)) {\n");
-          s4o.indent_right();
-          s4o.print(s4o.indent_spaces);
-          s4o.print(SET_VAR);
-          s4o.print("(");
-          s4o.print(FB_FUNCTION_PARAM);
-          s4o.print("->,ENO,,__BOOL_LITERAL(FALSE));\n");
-          s4o.print(s4o.indent_spaces + "return;\n");
-          s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n");
-          s4o.print(s4o.indent_spaces + "else {\n");
-          s4o.indent_right();
-          s4o.print(s4o.indent_spaces);
-          s4o.print(SET_VAR);
-          s4o.print("(");
-          s4o.print(FB_FUNCTION_PARAM);
-          s4o.print("->,ENO,,__BOOL_LITERAL(TRUE));\n");
-          s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n");
-        }
-      
-        /* (C.4) Initialize TEMP variables */
-        /* function body */
-        s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::init_vf,
-                                           generate_c_vardecl_c::temp_vt);
-        vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
-        delete vardecl;
-        s4o.print("\n");
-      
-        /* (C.5) Function code */
-        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
-        symbol->fblock_body->accept(generate_c_code);
-        print_end_of_block_label(s4o);
-        s4o.print(s4o.indent_spaces + "return;\n");
-        s4o.indent_left();
-        s4o.print(s4o.indent_spaces + "} // ");
-        symbol->fblock_name->accept(print_base);
-        s4o.print(FB_FUNCTION_SUFFIX);
-        s4o.print(s4o.indent_spaces + "() \n\n");
-      
+      if (!print_declaration) {
         /* (C.6) Step undefinitions */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::stepundef_sd);
@@ -1189,6 +1553,65 @@ class generate_c_pous_c {
     /************/
     /* Programs */
     /************/
+  private:
+    /* Print the declaration (if print_declaration is true) or the definition of the function with the body of
+     * the Program <symbol>.
+     */
+    static void print_program_body(program_declaration_c *symbol, stage4out_c &s4o, bool print_declaration) {
+      generate_c_vardecl_c          *vardecl;
+      generate_c_base_and_typeid_c   print_base(&s4o);
+
+      promoted_vars_t promoted_vars;
+      generate_c_promoted_vars_c::get(symbol, symbol->function_block_body, promoted_vars);
+
+      /* function interface */
+      s4o.print("void ");
+      symbol->program_type_name->accept(print_base);
+      s4o.print(FB_FUNCTION_SUFFIX);
+      s4o.print("(");
+      /* first and only parameter is a pointer to the data */
+      symbol->program_type_name->accept(print_base);
+      s4o.print(" *");
+      s4o.print(FB_FUNCTION_PARAM);
+      s4o.print(")");
+
+      if (print_declaration) {
+        s4o.print(";\n");
+        return;
+      }
+
+      s4o.print(" {\n");
+      s4o.indent_right();
+
+      print_promoted_vars(s4o, promoted_vars, declare_pv);
+      print_profile_begin(symbol->program_type_name, s4o);
+
+      /* (C.4) Initialize TEMP variables */
+      /* function body */
+      s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
+      vardecl = new generate_c_vardecl_c(&s4o,
+                                         generate_c_vardecl_c::init_vf,
+                                         generate_c_vardecl_c::temp_vt);
+      vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
+      delete vardecl;
+      print_promoted_vars(s4o, promoted_vars, load_pv);
+      s4o.print("\n");
+
+      /* (C.5) Function code */
+      generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->", &promoted_vars);
+      symbol->function_block_body->accept(generate_c_code);
+      print_end_of_block_label(s4o);
+      print_promoted_vars(s4o, promoted_vars, store_pv);
+      print_profile_end(symbol->program_type_name, s4o);
+      s4o.print(s4o.indent_spaces + "return;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "} // ");
+      symbol->program_type_name->accept(print_base);
+      s4o.print(FB_FUNCTION_SUFFIX);
+      s4o.print(s4o.indent_spaces + "() \n\n");
+    }
+
+
   public:
     /* NOTE: The following function will be called twice:
      *         1st time:  s4o will reference the .h file, and print_declaration=true
@@ -1199,6 +1622,10 @@ class generate_c_pous_c {
     /*  PROGRAM program_type_name program_var_declarations_list function_block_body END_PROGRAM */
     //SYM_REF4(program_declaration_c, program_type_name, var_declarations, function_block_body, unused)
     static void handle_program(program_declaration_c *symbol, stage4out_c &s4o, bool print_declaration) {
+      /* the Program variables migrated by the state migration function */
+      const unsigned int program_layout_vartypes = generate_c_vardecl_c::input_vt  |
+                                                   generate_c_vardecl_c::output_vt |
+                                                   generate_c_vardecl_c::private_vt;
       generate_c_vardecl_c          *vardecl;
       generate_c_sfcdecl_c          *sfcdecl;
       generate_c_base_and_typeid_c   print_base(&s4o);
@@ -1310,44 +1737,17 @@ class generate_c_pous_c {
       
       /* (C.3) Function declaration */
       s4o.print("// Code part\n");
-      /* function interface */
-      s4o.print("void ");
-      symbol->program_type_name->accept(print_base);
-      s4o.print(FB_FUNCTION_SUFFIX);
-      s4o.print("(");
-      /* first and only parameter is a pointer to the data */
-      symbol->program_type_name->accept(print_base);
-      s4o.print(" *");
-      s4o.print(FB_FUNCTION_PARAM);
-      s4o.print(")");
+      print_profile_entry(symbol->program_type_name, s4o, print_declaration);
+      print_program_body(symbol, s4o, print_declaration);
 
-      if (print_declaration) {
-        s4o.print(";\n");
-      } else {
-        s4o.print(" {\n");
-        s4o.indent_right();
-          
-        /* (C.4) Initialize TEMP variables */
-        /* function body */
-        s4o.print(s4o.indent_spaces + "// Initialise TEMP variables\n");
-        vardecl = new generate_c_vardecl_c(&s4o,
-                                           generate_c_vardecl_c::init_vf,
-                                           generate_c_vardecl_c::temp_vt);
-        vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
-        delete vardecl;
-        s4o.print("\n");
-      
-        /* (C.5) Function code */
-        generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
-        symbol->function_block_body->accept(generate_c_code);
-        print_end_of_block_label(s4o);
-        s4o.print(s4o.indent_spaces + "return;\n");
-        s4o.indent_left();
-        s4o.print(s4o.indent_spaces + "} // ");
-        symbol->program_type_name->accept(print_base);
-        s4o.print(FB_FUNCTION_SUFFIX);
-        s4o.print(s4o.indent_spaces + "() \n\n");
-      
+      /* (D) Layout descriptor and state migration function, for online change */
+      print_layout(symbol, symbol->program_type_name, symbol->var_declarations, symbol->function_block_body,
+                   program_layout_vartypes, s4o, print_declaration);
+
+      /* (E) Copy of the RETAIN variables to/from the retain image */
+      print_retain_function(symbol->program_type_name, symbol->var_declarations, program_layout_vartypes, s4o, print_declaration);
+
+      if (!print_declaration) {
         /* (C.6) Step undefinitions */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
         sfcdecl->generate(symbol->function_block_body, generate_c_sfcdecl_c::stepundef_sd);
@@ -1876,6 +2276,20 @@ END_RESOURCE
           s4o.print("__");
           symbol->program_name->accept(*this);
           s4o.print("\n");
+          if (generate_profiling__) {
+            /* profiling table entry of the program instance (see generate_c_profile.cc) */
+            s4o.print(s4o.indent_spaces + "__profile_entry_t ");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(FB_PROFILE_SUFFIX " = " PROFILE_ENTRY "(\"");
+            current_configuration->accept(*this);
+            s4o.print(".");
+            current_resource_name->accept(*this);
+            s4o.print(".");
+            symbol->program_name->accept(*this);
+            s4o.print("\");\n");
+          }
           break;
         case init_dt:
           if (symbol->retain_option != NULL)
@@ -1905,12 +2319,26 @@ END_RESOURCE
           if (symbol->prog_conf_elements != NULL)
             symbol->prog_conf_elements->accept(*this);
           
+          if (generate_profiling__) {
+            s4o.print(s4o.indent_spaces + "{\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces + PROFILE_BEGIN "\n");
+          }
           s4o.print(s4o.indent_spaces);
           symbol->program_type_name->accept(*this);
           s4o.print(FB_FUNCTION_SUFFIX);
           s4o.print("(&");
           symbol->program_name->accept(*this);
           s4o.print(");\n");
+          if (generate_profiling__) {
+            s4o.print(s4o.indent_spaces + PROFILE_END "(");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(FB_PROFILE_SUFFIX ")\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
           
           wanted_assigntype = send_at;
           if (symbol->prog_conf_elements != NULL)
@@ -2146,6 +2574,20 @@ class generate_c_backup_resource_decl_c: public generate_c_base_and_typeid_c {
       s4o.print("void ");
       symbol->resource_name->accept(*this);
       s4o.print("_restore__" "(void **buffer, int *maxsize);\n");      
+      s4o.print(s4o.indent_spaces);
+      s4o.print("void ");
+      symbol->resource_name->accept(*this);
+      s4o.print("_retain_backup__" "(__retain_image_t *image);\n");      
+      s4o.print(s4o.indent_spaces);
+      s4o.print("void ");
+      symbol->resource_name->accept(*this);
+      s4o.print("_retain_restore__" "(__retain_image_t *image);\n");      
+      return NULL;
+    }
+
+    void *visit(single_resource_declaration_c *symbol) {
+      s4o.print(s4o.indent_spaces + "void RESOURCE" "_retain_backup__" "(__retain_image_t *image);\n");
+      s4o.print(s4o.indent_spaces + "void RESOURCE" "_retain_restore__" "(__retain_image_t *image);\n");
       return NULL;
     }
 };
@@ -2194,6 +2636,50 @@ void print_backup_restore_function_end(stage4out_c &s4o) {
 }
 
 
+/* print out the begining of the function that copies the RETAIN global variables
+ * to/from the retain image (see lib/C/iec_retain.h)
+ */
+void print_retain_function_beg(stage4out_c &s4o, const char *func_name, const char *operation) {
+  /* operation will be either "_retain_backup__" or "_retain_restore__" */
+  const char *lib_func = (strcmp(operation, "_retain_backup__") == 0)? "__retain_backup" : "__retain_restore";
+  s4o.print("\n");
+  s4o.print("void ");
+  s4o.print(func_name);
+  s4o.print(operation);
+  s4o.print("(__retain_image_t *image) {\n");
+  s4o.indent_right();
+  s4o.print(s4o.indent_spaces);
+  s4o.print("#define " DECLARE_GLOBAL          "(vartype, domain, varname) \\\n    ");
+  s4o.print(lib_func);
+  s4o.print("(image, #domain \"__\" #varname, &domain##__##varname, sizeof(domain##__##varname));\n");
+  s4o.print(s4o.indent_spaces);
+  s4o.print("#define " DECLARE_GLOBAL_FB       "(vartype, domain, varname) \\\n    ");
+  s4o.print(lib_func);
+  s4o.print("(image, #domain \"__\" #varname, &domain##__##varname, sizeof(domain##__##varname));\n");
+  s4o.print(s4o.indent_spaces);
+  s4o.print("#define " DECLARE_GLOBAL_LOCATION "(vartype, location) \\\n    ");
+  s4o.print(lib_func);
+  s4o.print("(image, #location, location, sizeof(*location));\n");
+  s4o.print(s4o.indent_spaces);
+  s4o.print("#define " DECLARE_GLOBAL_LOCATED  "(vartype, domain, varname) \\\n    ");
+  s4o.print(lib_func);
+  s4o.print("(image, #domain \"__\" #varname, &domain##__##varname, sizeof(domain##__##varname));\n");
+}
+
+/* print out the declarations (i.e. the DECLARE_GLOBAL...() macros) of the global
+ * variables declared as RETAIN in <global_var_declarations_list>
+ */
+void print_retain_vars(generate_c_vardecl_c &vardecl, symbol_c *global_var_declarations_list) {
+  list_c *list = dynamic_cast<list_c *>(global_var_declarations_list);
+  if (NULL == list) return;
+  for (int i = 0; i < list->n; i++) {
+    global_var_declarations_c *declarations = dynamic_cast<global_var_declarations_c *>(list->get_element(i));
+    if ((NULL != declarations) && (NULL != dynamic_cast<retain_option_c *>(declarations->option)))
+      vardecl.print(declarations);
+  }
+}
+
+
 /* generate the backup/restore function for a CONFIGURATION */
 /* the generated function will backup/restore the global variables declared in the
  * configuration, and call the backup/restore functions of each embedded resource to do
@@ -2201,7 +2687,8 @@ void print_backup_restore_function_end(stage4out_c &s4o) {
  */
 class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
   private:
-    const char *func_to_call = NULL; // will later be set to either "_backup__" or "_restore__"
+    const char *func_to_call = NULL; // will later be set to either "_backup__", "_restore__", "_retain_backup__" or "_retain_restore__"
+    const char *func_args    = NULL; // the arguments passed to func_to_call
 
   public:
     generate_c_backup_config_c(stage4out_c *s4o_ptr)
@@ -2228,6 +2715,7 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
     void *visit(configuration_declaration_c *symbol) {
       
       s4o.print("\n\n\n");
+      s4o.print("#include \"iec_retain.h\"\n\n");
       
       s4o.print("void ");
       s4o.print("_backup__");
@@ -2262,6 +2750,7 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
       vardecl.print(symbol);
       s4o.print("\n");
       func_to_call = "_backup__";
+      func_args    = "(buffer, maxsize);\n";
       symbol->resource_declarations->accept(*this);
       func_to_call = NULL;
       print_backup_restore_function_end(s4o);      
@@ -2273,22 +2762,45 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
       symbol->resource_declarations->accept(*this);
       func_to_call = NULL;
       print_backup_restore_function_end(s4o);      
+
+      /* Same as above, but only for the RETAIN variables, copied to/from a retain image
+       * which tracks the blocks that changed (see lib/C/iec_retain.h)
+       */
+      const char *retain_operations[] = {"_retain_backup__", "_retain_restore__"};
+      for (int i = 0; i < 2; i++) {
+        print_retain_function_beg(s4o, "config", retain_operations[i]);
+        s4o.print(s4o.indent_spaces + "__retain_begin(image);\n");
+        print_retain_vars(vardecl, symbol->global_var_declarations);
+        func_to_call = retain_operations[i];
+        func_args    = "(image);\n";
+        symbol->resource_declarations->accept(*this);
+        func_to_call = NULL;
+        print_backup_restore_function_end(s4o);
+      }
       
       return NULL;
     }
     
     void *visit(resource_declaration_c *symbol) {
-      if (symbol->global_var_declarations == NULL)
+      /* every resource has retain backup/restore functions, for the RETAIN variables of its program instances */
+      if ((symbol->global_var_declarations == NULL) && (strncmp(func_to_call, "_retain", 7) != 0))
         return NULL;
       s4o.print(s4o.indent_spaces);
       symbol->resource_name->accept(*this);
       s4o.print(func_to_call);
-      s4o.print("(buffer, maxsize);\n");      
+      s4o.print(func_args);
       return NULL;
     }
     
     void *visit(single_resource_declaration_c *symbol) {
-      /* A single resource never has global variables declared, so nothing to do! */
+      /* A single resource never has global variables declared, so only the RETAIN
+       * variables of its program instances need to be copied to/from the retain image
+       */
+      if (strncmp(func_to_call, "_retain", 7) != 0)
+        return NULL;
+      s4o.print(s4o.indent_spaces + "RESOURCE");
+      s4o.print(func_to_call);
+      s4o.print(func_args);
       return NULL;
     }
 
@@ -2301,13 +2813,49 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
  * function generated for the configuration in which the resource is embedded
  */
 class generate_c_backup_resource_c: public generate_c_base_and_typeid_c {
+  private:
+    symbol_c   *current_resource_name;
+    const char *retain_backup; // "1" while printing the retain backup function, "0" for the retain restore function
+
   public:
     generate_c_backup_resource_c(stage4out_c *s4o_ptr)
       : generate_c_base_and_typeid_c(s4o_ptr) {
+      current_resource_name = NULL;
+      retain_backup = NULL;
     };
 
     virtual ~generate_c_backup_resource_c(void) {}
 
+  private:
+    void print_undef_declare_macros(void) {
+      s4o.print("\n\n\n");
+      s4o.print("#undef " DECLARE_GLOBAL          "\n");
+      s4o.print("#undef " DECLARE_GLOBAL_FB       "\n");
+      s4o.print("#undef " DECLARE_GLOBAL_LOCATION "\n");
+      s4o.print("#undef " DECLARE_GLOBAL_LOCATED  "\n");
+    }
+
+    /* print out the functions that copy the RETAIN global variables of the resource, and
+     * the RETAIN variables of its program instances, to/from the retain image
+     */
+    void print_retain_functions(const char *resource_name, symbol_c *global_var_declarations, symbol_c *program_configuration_list) {
+      generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
+                                         generate_c_vardecl_c::local_vf,
+                                         generate_c_vardecl_c::global_vt,
+                                         current_resource_name);
+      const char *retain_operations[] = {"_retain_backup__", "_retain_restore__"};
+      const char *retain_backups[]    = {"1", "0"};
+      for (int i = 0; i < 2; i++) {
+        print_retain_function_beg(s4o, resource_name, retain_operations[i]);
+        if (global_var_declarations != NULL)
+          print_retain_vars(vardecl, global_var_declarations);
+        retain_backup = retain_backups[i];
+        program_configuration_list->accept(*this);
+        retain_backup = NULL;
+        print_backup_restore_function_end(s4o);
+      }
+    }
+
     
   public:
     /********************/
@@ -2321,45 +2869,75 @@ class generate_c_backup_resource_c: public generate_c_base_and_typeid_c {
     /* B 1.7 Configuration elements */
     /********************************/
     void *visit(resource_declaration_c *symbol) {
-      if (symbol->global_var_declarations == NULL)
-        return NULL;
+      single_resource_declaration_c *resource = dynamic_cast<single_resource_declaration_c *>(symbol->resource_declaration);
+      if (NULL == resource) ERROR;
 
       char *resource_name = strdup(symbol->resource_name->token->value);
       /* convert to upper case */
       for (char *c = resource_name; *c != '\0'; *c = toupper(*c), c++);
+      current_resource_name = symbol->resource_name;
       
-      generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
-                                         generate_c_vardecl_c::local_vf,
-                                         generate_c_vardecl_c::global_vt,
-                                         symbol->resource_name);
       s4o.print("\n\n\n");
+      s4o.print("#include \"iec_retain.h\"\n");
+      print_undef_declare_macros();
 
-      s4o.print("void ");
-      s4o.print("_backup__");
-      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
-      s4o.print("void ");
-      s4o.print("_restore__");
-      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
-
-      s4o.print("\n\n\n");
-      s4o.print("#undef " DECLARE_GLOBAL          "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_FB       "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATION "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATED  "\n");
+      if (symbol->global_var_declarations != NULL) {
+        generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
+                                           generate_c_vardecl_c::local_vf,
+                                           generate_c_vardecl_c::global_vt,
+                                           symbol->resource_name);
+
+        s4o.print("void ");
+        s4o.print("_backup__");
+        s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
+        s4o.print("void ");
+        s4o.print("_restore__");
+        s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
+        
+        print_backup_restore_function_beg(s4o, resource_name, "_backup__");
+        vardecl.print(symbol->global_var_declarations);
+        print_backup_restore_function_end(s4o);      
       
-      print_backup_restore_function_beg(s4o, resource_name, "_backup__");
-      vardecl.print(symbol->global_var_declarations);
-      print_backup_restore_function_end(s4o);      
-    
-      print_backup_restore_function_beg(s4o, resource_name, "_restore__");
-      vardecl.print(symbol->global_var_declarations);
-      print_backup_restore_function_end(s4o);      
+        print_backup_restore_function_beg(s4o, resource_name, "_restore__");
+        vardecl.print(symbol->global_var_declarations);
+        print_backup_restore_function_end(s4o);      
+      }
+
+      print_retain_functions(resource_name, symbol->global_var_declarations, resource->program_configuration_list);
     
+      current_resource_name = NULL;
+      free(resource_name);
       return NULL;
     }
     
     void *visit(single_resource_declaration_c *symbol) {
-      /* A single resource never has global variables declared, so nothing to do! */
+      /* A single resource never has global variables declared, so only the RETAIN variables
+       * of its program instances are copied to/from the retain image.
+       */
+      current_resource_name = new identifier_c("RESOURCE");
+      s4o.print("\n\n\n");
+      s4o.print("#include \"iec_retain.h\"\n");
+      print_undef_declare_macros();
+      print_retain_functions("RESOURCE", NULL, symbol->program_configuration_list);
+      delete current_resource_name;
+      current_resource_name = NULL;
+      return NULL;
+    }
+
+    /*  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] */
+    //SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
+    void *visit(program_configuration_c *symbol) {
+      /* the program instance is RETAIN as passed to its _init__() function by the resource's _init__() function */
+      if (!generate_c_retain_c::has_retain(symbol->program_type_name)) return NULL;
+      s4o.print(s4o.indent_spaces);
+      symbol->program_type_name->accept(*this);
+      s4o.print(FB_RETAIN_SUFFIX "(&");
+      current_resource_name->accept(*this);
+      s4o.print("__");
+      symbol->program_name->accept(*this);
+      s4o.print(", image, ");
+      s4o.print(retain_backup);
+      s4o.print((NULL != dynamic_cast<retain_option_c *>(symbol->retain_option))? ", 1);\n" : ", 0);\n");
       return NULL;
     }
 
@@ -2443,6 +3021,19 @@ class generate_c_c: public iterator_visitor_c {
 /* B 0 - Programming Model */
 /***************************/
     void *visit(library_c *symbol) {
+      /* decide for which POUs and variables no code is generated */
+      generate_c_dead_code_c::analyse(symbol);
+      /* decide which Function inputs are passed by pointer, before generating any call to those Functions */
+      generate_c_byref_inputs_c::analyse(symbol);
+      /* decide which FB instances are invoked through a specialised FB body, before generating any FB invocation */
+      generate_c_fb_specialization_c::analyse(symbol);
+      /* decide which FBs and Programs get a layout descriptor, before declaring any FB instance */
+      generate_c_layout_c::analyse(symbol);
+      /* decide which FBs and Programs get a retain function, before declaring any FB instance */
+      generate_c_retain_c::analyse(symbol);
+      /* decide which POUs get a profiling table entry, before generating any POU */
+      generate_c_profile_c::analyse(symbol);
+
       pous_incl_s4o.print("#ifndef __POUS_H\n#define __POUS_H\n\n");
       
       if (runtime_options.disable_implicit_en_eno) {
@@ -2453,7 +3044,14 @@ class generate_c_c: public iterator_visitor_c {
         pous_incl_s4o.print("#endif\n");
       }
       
-      pous_incl_s4o.print("#include \"accessor.h\"\n#include \"iec_std_lib.h\"\n\n");
+      pous_incl_s4o.print("#include \"accessor.h\"\n#include \"iec_std_lib.h\"\n");
+      if (generate_online_change__)
+        pous_incl_s4o.print("#include \"iec_online_change.h\"\n");
+      if (generate_plc_state_backup_fuctions__)
+        pous_incl_s4o.print("#include \"iec_retain.h\"\n");
+      if (generate_profiling__)
+        pous_incl_s4o.print("#include \"iec_profile.h\"\n");
+      pous_incl_s4o.print("\n");
 
       for(int i = 0; i < symbol->n; i++) {
         symbol->get_element(i)->accept(*this);
@@ -2508,6 +3106,7 @@ class generate_c_c: public iterator_visitor_c {
  */
 #define handle_pou(fname,pname) \
       if (!allow_output) return NULL;\
+      if (!generate_c_dead_code_c::is_reachable(symbol)) return NULL;\
       if (generate_pou_filepairs__) {\
         const char *pou_name = get_datatype_info_c::get_id_str(pname);\
         stage4out_c s4o_c(current_builddir, pou_name, "c");\
@@ -2601,6 +3200,11 @@ class generate_c_c: public iterator_visitor_c {
           generate_c_backup_config_c generate_backup = generate_c_backup_config_c(&config_s4o);
           symbol->accept(generate_backup);
         }
+
+        if (generate_profiling__) {
+          generate_c_profile_config_c generate_profile(&config_s4o);
+          symbol->accept(generate_profile);
+        }
       }
 
       symbol->resource_declarations->accept(*this);
@@ -2627,6 +3231,10 @@ class generate_c_c: public iterator_visitor_c {
       stage4out_c resources_s4o(current_builddir, "RESOURCE", "c");
       generate_c_resources_c generate_c_resources(&resources_s4o, current_configuration, symbol, common_ticktime);
       symbol->accept(generate_c_resources);
+      if (generate_plc_state_backup_fuctions__ > 0) {
+        generate_c_backup_resource_c generate_backup = generate_c_backup_resource_c(&resources_s4o);
+        symbol->accept(generate_backup);
+      }
       return NULL;
     }
     
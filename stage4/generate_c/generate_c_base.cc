@@ -105,10 +105,25 @@ class generate_c_base_c: public iterator_visitor_c {
      * This string is set with the set_variable_prefix() member function.
      */
     const char *variable_prefix_;
+    /* The variables of the FB/Program being generated that have been promoted to C local variables.
+     * NULL if no variables are being promoted (see generate_c_promoted_vars.cc)
+     */
+    const promoted_vars_t *promoted_vars_;
+    /* The inputs of the Function being generated that are passed by pointer.
+     * NULL if there are none (see generate_c_byref_inputs.cc)
+     */
+    const byref_inputs_t *byref_inputs_;
+    /* The inputs of the FB being generated that are replaced by a constant value.
+     * NULL if we are not generating a specialised FB body (see generate_c_fb_specialization.cc)
+     */
+    const specialized_inputs_t *specialized_inputs_;
 
   public:
     generate_c_base_c(stage4out_c *s4o_ptr): s4o(*s4o_ptr) {
       variable_prefix_ = NULL;
+      promoted_vars_   = NULL;
+      byref_inputs_    = NULL;
+      specialized_inputs_ = NULL;
     }
     ~generate_c_base_c(void) {}
 
@@ -120,6 +135,63 @@ class generate_c_base_c: public iterator_visitor_c {
         s4o.print(variable_prefix_);
     }
 
+    void set_promoted_vars(const promoted_vars_t *promoted_vars) {promoted_vars_ = promoted_vars;}
+    /* If <symbol> is a variable that has been promoted to a C local variable, print the name
+     * of that C local variable and return true. Otherwise print nothing, and return false.
+     */
+    bool print_promoted_var(symbol_c *symbol) {
+      token_c *var_name = get_promoted_var_name(symbol);
+      if (NULL == var_name) return false;
+      s4o.print(PROMOTED_VAR);
+      print_token(var_name);
+      return true;
+    }
+
+    /* Is <symbol> a variable that has been promoted to a C local variable? */
+    bool is_promoted_var(symbol_c *symbol) {return (NULL != get_promoted_var_name(symbol));}
+
+  private:
+    token_c *get_promoted_var_name(symbol_c *symbol) {
+      if (NULL == promoted_vars_) return NULL;
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      if (NULL == variable) return NULL;
+      token_c *var_name = dynamic_cast<token_c *>(variable->var_name);
+      if ((NULL == var_name) || (promoted_vars_->find(var_name->value) == promoted_vars_->end())) return NULL;
+      return var_name;
+    }
+
+  public:
+    void set_byref_inputs(const byref_inputs_t *byref_inputs) {byref_inputs_ = byref_inputs;}
+    /* If <symbol> is an input of the Function being generated that is passed by pointer,
+     * print the dereferenced pointer and return true. Otherwise print nothing, and return false.
+     */
+    bool print_byref_input(symbol_c *symbol) {
+      if (NULL == byref_inputs_) return false;
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      if (NULL == variable) return false;
+      token_c *var_name = dynamic_cast<token_c *>(variable->var_name);
+      if ((NULL == var_name) || (byref_inputs_->find(var_name->value) == byref_inputs_->end())) return false;
+      s4o.print("(*");
+      print_token(var_name);
+      s4o.print(")");
+      return true;
+    }
+
+    void set_specialized_inputs(const specialized_inputs_t *specialized_inputs) {specialized_inputs_ = specialized_inputs;}
+    /* If <symbol> is an input of the FB being generated that is bound to a constant value in this
+     * specialised FB body, print that constant and return true. Otherwise print nothing, and return false.
+     */
+    bool print_specialized_input(symbol_c *symbol) {
+      if (NULL == specialized_inputs_) return false;
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol);
+      if (NULL == variable) return false;
+      token_c *var_name = dynamic_cast<token_c *>(variable->var_name);
+      if (NULL == var_name) return false;
+      specialized_inputs_t::const_iterator it = specialized_inputs_->find(var_name->value);
+      if (it == specialized_inputs_->end()) return false;
+      return print_const_value(it->second);
+    }
+
     void print_line_directive(symbol_c *symbol) {
       if (!generate_line_directives__) return; /* global variable generate_line_directives__ is defined in generate_c.cc */
       s4o.print("#line ");
@@ -142,6 +214,49 @@ class generate_c_base_c: public iterator_visitor_c {
       return NULL;
     }
 
+    /* Print the value determined by constant folding (in stage 3) for this expression, as a literal of the
+     * datatype of the expression (e.g. __INT_LITERAL(42)).
+     * Returns false, without printing anything, if the value of the expression is not known at compile time,
+     * or if it is of a datatype we can not print as a literal.
+     */
+    bool print_const_value(symbol_c *symbol) {
+      symbol_c *datatype = symbol->datatype;
+      char buf[64];
+
+      if      (get_datatype_info_c::is_ANY_signed_INT(datatype)) {
+        if (!symbol->const_value._int64.is_valid())   return false;
+        int64_t value = symbol->const_value._int64.get();
+        if (value == INT64_MIN)                       return false; /* can not be written as a C literal! */
+        snprintf(buf, sizeof(buf), "%lld", (long long int)value);
+      }
+      else if (get_datatype_info_c::is_ANY_unsigned_INT(datatype) || get_datatype_info_c::is_ANY_nBIT(datatype)) {
+        if (!symbol->const_value._uint64.is_valid())  return false;
+        uint64_t value = symbol->const_value._uint64.get();
+        if (value > (uint64_t)INT64_MAX)              return false; /* would need a 'U' suffix */
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long int)value);
+      }
+      else if (get_datatype_info_c::is_ANY_REAL(datatype)) {
+        if (!symbol->const_value._real64.is_valid())  return false;
+        real64_t value = symbol->const_value._real64.get();
+        if ((value != value) || (value - value != 0)) return false; /* NaN or infinity */
+        snprintf(buf, sizeof(buf), "%.17g", (double)value);
+        if (NULL == strpbrk(buf, ".eE"))  strcat(buf, ".0");
+      }
+      else if (get_datatype_info_c::is_BOOL(datatype)) {
+        if (!symbol->const_value._bool.is_valid())    return false;
+        snprintf(buf, sizeof(buf), "%s", symbol->const_value._bool.get()? "TRUE" : "FALSE");
+      }
+      else
+        return false;
+
+      s4o.print("__");
+      datatype->accept(*this);
+      s4o.print("_LITERAL(");
+      s4o.print(buf);
+      s4o.print(")");
+      return true;
+    }
+
     void *print_striped_token(token_c *token, int offset = 0) {
       std::string str = "";
       bool leading_zero = true;
@@ -0,0 +1,249 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Passing ARRAY and STRUCT inputs of Functions by (const) pointer.
+ *
+ *  Functions are mapped onto C functions, whose VAR_INPUT parameters are
+ *  passed by value. For ARRAY and STRUCT inputs this means the whole
+ *  aggregate is copied on every call.
+ *
+ *  An ARRAY or STRUCT input of a Function is instead passed as a
+ *  'const <type> *' C parameter when:
+ *    - the Function's code is actually generated (i.e. it is not inside
+ *      a {disable code generation} ... {enable code generation} block,
+ *      like the standard library functions that are implemented in C);
+ *    - the input is never written to inside the Function's body, i.e. it
+ *      is never assigned to (not even one of its elements or fields), used
+ *      in a REF() operation, nor passed to an OUT or IN_OUT parameter;
+ *    - on every invocation of the Function, the value passed to that
+ *      input is a variable (or an element/field of a variable), so we
+ *      are able to take its address. An input that is not passed a value
+ *      (and therefore takes its default value), or that is passed the result
+ *      of another function call, or the IL accumulator, can not be passed
+ *      by pointer. Neither can a VAR_EXTERNAL or located variable (nor an
+ *      element/field of one), as it is accessed through an accessor macro
+ *      that returns its (possibly forced) value.
+ *
+ *  Inside the Function's body these inputs are accessed as (*<input_name>).
+ */
+
+
+/* The names of the inputs of a Function that are passed by pointer. */
+typedef std::set<std::string, nocasecmp_c> byref_inputs_t;
+
+
+
+/* Collect the names of the variables that are written to (or whose address is taken) in a POU body. */
+class generate_c_written_vars_c: public iterator_visitor_c {
+  private:
+    byref_inputs_t &written_vars;
+
+  public:
+    generate_c_written_vars_c(byref_inputs_t &written_vars_): written_vars(written_vars_) {}
+    ~generate_c_written_vars_c(void) {}
+
+  private:
+    void written(symbol_c *variable) {
+      if (NULL == variable) return;
+      token_c *var_name = get_var_name_c::get_name(variable);
+      if (NULL != var_name) written_vars.insert(var_name->value);
+    }
+
+    void written_params(symbol_c *f_call, symbol_c *pou_decl) {
+      /* NOTE: the called POU may not have been determined if the code contains errors. */
+      if (NULL == pou_decl) return;
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(f_call, pou_decl);
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count) continue;
+        if (   (binding.param_direction == function_param_iterator_c::direction_out)
+            || (binding.param_direction == function_param_iterator_c::direction_inout))
+          written(binding.param_value);
+      }
+    }
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(il_simple_operation_c *symbol) {
+      if (   (NULL != dynamic_cast<ST_operator_c  *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<STN_operator_c *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<S_operator_c   *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<R_operator_c   *>(symbol->il_simple_operator)))
+        written(symbol->il_operand);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(il_function_call_c     *symbol) {written_params(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_formal_funct_call_c *symbol) {written_params(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_fb_call_c           *symbol) {written_params(symbol, symbol->called_fb_declaration);       return iterator_visitor_c::visit(symbol);}
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(ref_expression_c       *symbol) {written(symbol->exp);                                         return iterator_visitor_c::visit(symbol);}
+    void *visit(function_invocation_c  *symbol) {written_params(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+    void *visit(fb_invocation_c        *symbol) {written_params(symbol, symbol->called_fb_declaration);       return iterator_visitor_c::visit(symbol);}
+    void *visit(assignment_statement_c *symbol) {written(symbol->l_exp);                                       return iterator_visitor_c::visit(symbol);}
+    void *visit(for_statement_c        *symbol) {written(symbol->control_variable);                            return iterator_visitor_c::visit(symbol);}
+}; /* generate_c_written_vars_c */
+
+
+
+
+class generate_c_byref_inputs_c: public iterator_visitor_c {
+  private:
+    typedef std::map<symbol_c *, byref_inputs_t> byref_inputs_map_t;
+    /* maps each function_declaration_c to the names of its inputs passed by pointer */
+    static byref_inputs_map_t byref_inputs_map;
+
+    /* the POU whose body is being searched for Function invocations */
+    symbol_c *current_scope;
+
+    generate_c_byref_inputs_c(void): current_scope(NULL) {}
+    ~generate_c_byref_inputs_c(void) {}
+
+  public:
+    /* Determine, for every Function in the library <tree_root>, which inputs are passed by pointer.
+     * Must be called before generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root) {
+      byref_inputs_map.clear();
+      library_c *library = dynamic_cast<library_c *>(tree_root);
+      if (NULL == library) return;
+
+      /* 1st pass: the inputs that are never written to inside each Function... */
+      bool code_generation = true;
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->get_element(i);
+        if (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))  code_generation = true;
+        if (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element))  code_generation = false;
+        function_declaration_c *f_decl = dynamic_cast<function_declaration_c *>(element);
+        if ((NULL != f_decl) && code_generation)
+          add_candidates(f_decl);
+      }
+
+      /* 2nd pass: ... that on every invocation are passed a variable. */
+      generate_c_byref_inputs_c search;
+      library->accept(search);
+    }
+
+    /* Returns the names of the inputs of Function <f_decl> that are passed by pointer, or NULL if none. */
+    static const byref_inputs_t *get(symbol_c *f_decl) {
+      byref_inputs_map_t::iterator it = byref_inputs_map.find(f_decl);
+      if ((it == byref_inputs_map.end()) || it->second.empty()) return NULL;
+      return &(it->second);
+    }
+
+    /* Is the input <param_name> of Function <f_decl> passed by pointer? */
+    static bool is_byref(symbol_c *f_decl, symbol_c *param_name) {
+      const byref_inputs_t *byref_inputs = get(f_decl);
+      token_c *name = dynamic_cast<token_c *>(param_name);
+      if ((NULL == byref_inputs) || (NULL == name)) return false;
+      return (byref_inputs->find(name->value) != byref_inputs->end());
+    }
+
+  private:
+    static void add_candidates(function_declaration_c *f_decl) {
+      byref_inputs_t &byref_inputs = byref_inputs_map[f_decl];
+      function_param_iterator_c fp_iterator(f_decl);
+      identifier_c *param_name;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (fp_iterator.param_direction() != function_param_iterator_c::direction_in) continue;
+        if (   get_datatype_info_c::is_array    (fp_iterator.param_type())
+            || get_datatype_info_c::is_structure(fp_iterator.param_type()))
+          byref_inputs.insert(param_name->value);
+      }
+      if (byref_inputs.empty()) return;
+
+      byref_inputs_t written_vars;
+      generate_c_written_vars_c search_written_vars(written_vars);
+      f_decl->function_body->accept(search_written_vars);
+      for (byref_inputs_t::iterator it = written_vars.begin(); it != written_vars.end(); it++)
+        byref_inputs.erase(*it);
+    }
+
+    void check_call(symbol_c *f_call, symbol_c *f_decl) {
+      /* NOTE: the called POU may not have been determined if the code contains errors. */
+      if (NULL == f_decl) return;
+      byref_inputs_map_t::iterator it = byref_inputs_map.find(f_decl);
+      if (it == byref_inputs_map.end()) return;
+      byref_inputs_t &byref_inputs = it->second;
+
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(f_call, f_decl);
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count) continue;
+        if (binding.param_direction != function_param_iterator_c::direction_in) continue;
+        symbol_c *value = binding.param_value;
+        if (   binding.implicit_variable
+            || (   (NULL == dynamic_cast<symbolic_variable_c   *>(value))
+                && (NULL == dynamic_cast<array_variable_c      *>(value))
+                && (NULL == dynamic_cast<structured_variable_c *>(value)))
+            || is_accessor_var(value)) {
+          token_c *param_name = dynamic_cast<token_c *>(binding.decl_param_name);
+          if (NULL == param_name) ERROR;
+          byref_inputs.erase(param_name->value);
+        }
+      }
+    }
+
+    /* Is the variable <value> (or the variable containing the element/field <value>) a VAR_EXTERNAL
+     * or located variable of the current POU?
+     */
+    bool is_accessor_var(symbol_c *value) {
+      symbol_c *variable = value;
+      while (true) {
+        structured_variable_c *field   = dynamic_cast<structured_variable_c *>(variable);
+        array_variable_c      *element = dynamic_cast<array_variable_c      *>(variable);
+        if      (NULL != field)    variable = field->record_variable;
+        else if (NULL != element)  variable = element->subscripted_variable;
+        else break;
+      }
+      if (NULL == current_scope) return false;
+      search_var_instance_decl_c search_var_instance_decl(current_scope);
+      search_var_instance_decl_c::vt_t vartype = search_var_instance_decl.get_vartype(variable);
+      return ((search_var_instance_decl_c::external_vt == vartype) || (search_var_instance_decl_c::located_vt == vartype));
+    }
+
+    /**************************************/
+    /* B.1.5 - Program organization units */
+    /**************************************/
+    void *visit(function_declaration_c       *symbol) {current_scope = symbol; iterator_visitor_c::visit(symbol); current_scope = NULL; return NULL;}
+    void *visit(function_block_declaration_c *symbol) {current_scope = symbol; iterator_visitor_c::visit(symbol); current_scope = NULL; return NULL;}
+    void *visit(program_declaration_c        *symbol) {current_scope = symbol; iterator_visitor_c::visit(symbol); current_scope = NULL; return NULL;}
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(il_function_call_c     *symbol) {check_call(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_formal_funct_call_c *symbol) {check_call(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(function_invocation_c  *symbol) {check_call(symbol, symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+}; /* generate_c_byref_inputs_c */
+
+
+generate_c_byref_inputs_c::byref_inputs_map_t generate_c_byref_inputs_c::byref_inputs_map;
@@ -0,0 +1,308 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Elimination of unused POUs and unused variables.
+ *
+ *  C code is generated for every Function, FB and Program in the library,
+ *  including the POUs of any (vendor) libraries that are {#include}'d, even
+ *  though the CONFIGURATION may use only a small number of them.
+ *
+ *  When the 'd' stage4 option is given (-O d), C code is only generated for
+ *  the POUs reachable from the CONFIGURATION, i.e.:
+ *    - the Programs instantiated in the resources of the configuration;
+ *    - the FBs instantiated by the configuration (VAR_GLOBAL) or by a reachable
+ *      POU (including FBs referenced from the datatype of a variable, e.g. an
+ *      ARRAY of FBs declared in a TYPE ... END_TYPE);
+ *    - the Functions invoked by a reachable POU.
+ *  Since the datatypes declared implicitly (e.g. 'VAR a: ARRAY [1..4] OF INT')
+ *  are generated together with the POU declaring them, these are only generated
+ *  for reachable POUs too. Datatypes declared in TYPE ... END_TYPE are always generated.
+ *  If the library does not contain a CONFIGURATION (i.e. we are compiling a library of
+ *  POUs), all POUs are generated.
+ *
+ *  When the 'v' stage4 option is given (-O v), the variables declared in a VAR section
+ *  of a FB or a Program that are never referenced are removed from the FB/Program data
+ *  structure (and are no longer initialised, nor listed in VARIABLES.csv, so they are
+ *  no longer visible to the debugger). A variable is considered referenced if:
+ *    - its name is used anywhere in the declaration or body of the POU that declares it; or
+ *    - its name is used as the field of a structured variable (e.g. 'prog.var'), in any POU; or
+ *    - its name is used anywhere in the CONFIGURATION (e.g. in a VAR_ACCESS path).
+ *  Only variables declared with an elementary or derived datatype (other than an ARRAY or
+ *  STRUCT declared directly in the VAR section), and FB instances are removed. FB instances
+ *  are never removed if the FB declares located variables (directly or in nested FB instances).
+ */
+
+
+#include <set>
+#include <list>
+
+
+class generate_c_dead_code_c: public iterator_visitor_c {
+  private:
+    /* the POUs for which C code is generated (only used with -O d) */
+    static std::set<symbol_c *> reachable_pous;
+    static bool eliminate_pous;
+    /* the (identifiers of the) variables removed from the FB/Program data structures (only used with -O v) */
+    static std::set<symbol_c *> dead_vars;
+
+    /* the reachable POUs whose references have not yet been followed */
+    std::list<symbol_c *> pending_pous;
+    /* the derived datatypes already followed */
+    std::set<symbol_c *> visited_types;
+
+    generate_c_dead_code_c(void) {}
+    ~generate_c_dead_code_c(void) {}
+
+  public:
+    /* Determine the POUs and variables of the library <tree_root> for which no code will be generated.
+     * Must be called before generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root) {
+      reachable_pous.clear();
+      dead_vars.clear();
+      eliminate_pous = false;
+
+      library_c *library = dynamic_cast<library_c *>(tree_root);
+      if (NULL == library) return;
+
+      if (generate_dead_pou_elimination__) { /* global variable generate_dead_pou_elimination__ is defined in generate_c.cc */
+        generate_c_dead_code_c search;
+        for (int i = 0; i < library->n; i++)
+          if (NULL != dynamic_cast<configuration_declaration_c *>(library->get_element(i))) {
+            library->get_element(i)->accept(search);
+            eliminate_pous = true;
+          }
+        while (!search.pending_pous.empty()) {
+          symbol_c *pou_decl = search.pending_pous.front();
+          search.pending_pous.pop_front();
+          pou_decl->accept(search);
+        }
+      }
+
+      if (generate_dead_var_elimination__) { /* global variable generate_dead_var_elimination__ is defined in generate_c.cc */
+        generate_c_referenced_names_c::names_t external_names;
+        generate_c_referenced_names_c::get_external(library, external_names);
+        for (int i = 0; i < library->n; i++) {
+          symbol_c *element = library->get_element(i);
+          function_block_declaration_c *fb_decl   = dynamic_cast<function_block_declaration_c *>(element);
+          program_declaration_c        *prog_decl = dynamic_cast<program_declaration_c        *>(element);
+          if (NULL != fb_decl)    find_dead_vars(fb_decl,   fb_decl  ->var_declarations, external_names);
+          if (NULL != prog_decl)  find_dead_vars(prog_decl, prog_decl->var_declarations, external_names);
+        }
+      }
+    }
+
+    /* Is C code generated for the POU <pou_decl>? */
+    static bool is_reachable(symbol_c *pou_decl) {
+      return !eliminate_pous || (reachable_pous.find(pou_decl) != reachable_pous.end());
+    }
+
+    /* Has the variable <var_name> (the identifier in its declaration) been removed? */
+    static bool is_dead_var(symbol_c *var_name) {
+      return !dead_vars.empty() && (dead_vars.find(var_name) != dead_vars.end());
+    }
+
+    /* The names of the POUs of the library <tree_root> for which C code is generated, i.e. the reachable
+     * POUs outside any {disable_code_generation} ... {enable_code_generation} block. Only FBs and Programs
+     * are listed, and also Functions if <with_functions> is true. Must be called after analyse().
+     */
+    typedef std::set<std::string, nocasecmp_c> pou_names_t;
+    static void get_generated_pous(symbol_c *tree_root, pou_names_t &pou_names, bool with_functions = false) {
+      pou_names.clear();
+      library_c *library = dynamic_cast<library_c *>(tree_root);
+      if (NULL == library) return;
+
+      bool code_generation = true;
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->get_element(i);
+        if (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))  code_generation = true;
+        if (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element))  code_generation = false;
+        if (!code_generation || !is_reachable(element)) continue;
+        function_declaration_c       *f_decl    = dynamic_cast<function_declaration_c       *>(element);
+        function_block_declaration_c *fb_decl   = dynamic_cast<function_block_declaration_c *>(element);
+        program_declaration_c        *prog_decl = dynamic_cast<program_declaration_c        *>(element);
+        if ((NULL != f_decl) && with_functions)
+                                pou_names.insert(get_datatype_info_c::get_id_str(f_decl->derived_function_name));
+        if (NULL != fb_decl)    pou_names.insert(get_datatype_info_c::get_id_str(fb_decl->fblock_name));
+        if (NULL != prog_decl)  pou_names.insert(get_datatype_info_c::get_id_str(prog_decl->program_type_name));
+      }
+    }
+
+  private:
+    /* Collect the names referenced inside a POU or CONFIGURATION. */
+    class generate_c_referenced_names_c: public iterator_visitor_c {
+      public:
+        typedef std::set<std::string, nocasecmp_c> names_t;
+
+      private:
+        names_t &names;
+        bool fields_only;
+
+        generate_c_referenced_names_c(names_t &names_, bool fields_only_): names(names_), fields_only(fields_only_) {}
+        ~generate_c_referenced_names_c(void) {}
+
+      public:
+        /* The names of the variables referenced inside the POU <pou_decl> */
+        static void get(symbol_c *pou_decl, names_t &names) {
+          generate_c_referenced_names_c search(names, false);
+          pou_decl->accept(search);
+        }
+
+        /* The names that may reference a variable from outside the POU declaring it: the fields of
+         * structured variables in any POU, and any name used in a CONFIGURATION.
+         */
+        static void get_external(library_c *library, names_t &names) {
+          generate_c_referenced_names_c search_fields(names, true);
+          generate_c_referenced_names_c search_all  (names, false);
+          for (int i = 0; i < library->n; i++) {
+            symbol_c *element = library->get_element(i);
+            if (NULL != dynamic_cast<configuration_declaration_c *>(element))
+              element->accept(search_all);
+            else
+              element->accept(search_fields);
+          }
+        }
+
+      private:
+        void add(symbol_c *symbol) {
+          token_c *name = dynamic_cast<token_c *>(symbol);
+          if (NULL != name) names.insert(name->value);
+        }
+
+        /* In a CONFIGURATION we collect every identifier */
+        void *visit(identifier_c *symbol) {if (!fields_only) add(symbol); return NULL;}
+
+        void *visit(symbolic_variable_c *symbol) {
+          if (!fields_only) add(symbol->var_name);
+          return NULL;
+        }
+
+        void *visit(structured_variable_c *symbol) {
+          add(symbol->field_selector);
+          symbol->record_variable->accept(*this);
+          return NULL;
+        }
+
+        /* the name of the invoked FB instance is an identifier_c, not a symbolic_variable_c */
+        void *visit(fb_invocation_c *symbol) {
+          if (!fields_only) add(symbol->fb_name);
+          return iterator_visitor_c::visit(symbol);
+        }
+
+        void *visit(il_fb_call_c *symbol) {
+          if (!fields_only) add(symbol->fb_name);
+          return iterator_visitor_c::visit(symbol);
+        }
+
+        /* the names in the variable declarations themselves are not references */
+        void *visit(var1_list_c    *symbol) {return NULL;}
+        void *visit(fb_name_list_c *symbol) {return NULL;}
+    }; /* generate_c_referenced_names_c */
+
+
+    /* Find the unreferenced variables declared in the VAR sections of the FB or Program <pou_decl>. */
+    static void find_dead_vars(symbol_c *pou_decl, symbol_c *var_declarations, generate_c_referenced_names_c::names_t &external_names) {
+      if (!is_reachable(pou_decl)) return;
+      list_c *var_decl_list = dynamic_cast<list_c *>(var_declarations);
+      if (NULL == var_decl_list) return;
+
+      generate_c_referenced_names_c::names_t names;
+      generate_c_referenced_names_c::get(pou_decl, names);
+
+      for (int i = 0; i < var_decl_list->n; i++) {
+        var_declarations_c *var_decls = dynamic_cast<var_declarations_c *>(var_decl_list->get_element(i));
+        if (NULL == var_decls) continue;
+        list_c *decl_list = dynamic_cast<list_c *>(var_decls->var_init_decl_list);
+        if (NULL == decl_list) continue;
+
+        for (int j = 0; j < decl_list->n; j++) {
+          list_c *var_list = NULL;
+          var1_init_decl_c *var1_init_decl = dynamic_cast<var1_init_decl_c *>(decl_list->get_element(j));
+          fb_name_decl_c   *fb_name_decl   = dynamic_cast<fb_name_decl_c   *>(decl_list->get_element(j));
+          if (NULL != var1_init_decl)
+            var_list = dynamic_cast<list_c *>(var1_init_decl->var1_list);
+          if (NULL != fb_name_decl) {
+            /* FB instances whose FB declares located variables must remain, as the located variables are bound when initialised */
+            fb_spec_init_c *fb_spec_init = dynamic_cast<fb_spec_init_c *>(fb_name_decl->fb_spec_init);
+            function_block_declaration_c *fb_decl = (NULL == fb_spec_init)? NULL :
+              dynamic_cast<function_block_declaration_c *>(search_base_type_c::get_basetype_decl(fb_spec_init->function_block_type_name));
+            if ((NULL != fb_decl) && generate_c_init_image_c::is_imageable(fb_decl))
+              var_list = dynamic_cast<list_c *>(fb_name_decl->fb_name_list);
+          }
+          if (NULL == var_list) continue;
+
+          for (int k = 0; k < var_list->n; k++) {
+            token_c *var_name = dynamic_cast<token_c *>(var_list->get_element(k));
+            if (NULL == var_name) continue;
+            if (   (names         .find(var_name->value) == names         .end())
+                && (external_names.find(var_name->value) == external_names.end()))
+              dead_vars.insert(var_list->get_element(k));
+          }
+        }
+      }
+    }
+
+
+    /* Mark the POU <pou_decl> as reachable, and follow its references later on */
+    void add_pou(symbol_c *pou_decl) {
+      if ((NULL == pou_decl) || (reachable_pous.find(pou_decl) != reachable_pous.end())) return;
+      reachable_pous.insert(pou_decl);
+      pending_pous.push_back(pou_decl);
+    }
+
+    /* A name that may reference a FB or Program type, or a derived datatype (which may contain FBs) */
+    void add_name(symbol_c *symbol) {
+      function_block_type_symtable_t::iterator fb = function_block_type_symtable.find(symbol);
+      if (fb != function_block_type_symtable.end())  add_pou(fb->second);
+      program_type_symtable_t::iterator prog = program_type_symtable.find(symbol);
+      if (prog != program_type_symtable.end())  add_pou(prog->second);
+      type_symtable_t::iterator type = type_symtable.find(symbol);
+      if ((type != type_symtable.end()) && (visited_types.find(type->second) == visited_types.end())) {
+        visited_types.insert(type->second);
+        type->second->accept(*this);
+      }
+    }
+
+    /*******************************************/
+    /* B 1.1 - Letters, digits and identifiers */
+    /*******************************************/
+    void *visit(                 identifier_c *symbol) {add_name(symbol); return NULL;}
+    void *visit(derived_datatype_identifier_c *symbol) {add_name(symbol); return NULL;}
+    void *visit(         poutype_identifier_c *symbol) {add_name(symbol); return NULL;}
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(il_function_call_c     *symbol) {add_pou(symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_formal_funct_call_c *symbol) {add_pou(symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(function_invocation_c  *symbol) {add_pou(symbol->called_function_declaration); return iterator_visitor_c::visit(symbol);}
+}; /* generate_c_dead_code_c */
+
+
+std::set<symbol_c *> generate_c_dead_code_c::reachable_pous;
+bool                 generate_c_dead_code_c::eliminate_pous = false;
+std::set<symbol_c *> generate_c_dead_code_c::dead_vars;
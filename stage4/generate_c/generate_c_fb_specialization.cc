@@ -0,0 +1,372 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Specialization of FB bodies for instances whose inputs are always constant.
+ *
+ *  FB instances are frequently invoked with the same constant value passed to
+ *  an input on every call (e.g. PID(..., CYCLE := T#100ms) or a scaling factor).
+ *  The generic FBNAME_body__() function must nevertheless read that input from
+ *  the instance data on every invocation.
+ *
+ *  When the 's' stage4 option is given (-O s), every FB instance whose inputs are
+ *  bound to the same constant value on all of its invocations is called through a
+ *  specialised copy of the FB body (FBNAME__SPECn_body__()), in which each read of
+ *  those inputs is replaced by the constant itself, so the C compiler may fold any
+ *  expression using them. Instances of the same FB type bound to the same constants
+ *  share the same specialised body. The call still stores the constant in the
+ *  instance's input, so the instance data remains identical to the generic case.
+ *
+ *  An instance is only specialised if:
+ *    - it is declared in a VAR section of the Program or FB that calls it, and is only
+ *      invoked from the body of that POU (an ST FB invocation, or an IL CAL/CALC/CALCN);
+ *    - it is never used other than in these invocations and to read its outputs,
+ *      i.e. it is never assigned to, used in a REF() operation, passed to another POU,
+ *      invoked with an IL implicit FB call (S1, R1, CLK, ...), nor is any of its
+ *      inputs written to directly;
+ *    - the FB type's code is generated by the compiler, and its body is in ST or IL.
+ *  An input is only bound to a constant if:
+ *    - on every invocation of the instance it is passed a value known at compile time,
+ *      of an ANY_INT, ANY_BIT (other than STRING), ANY_REAL or BOOL datatype (values
+ *      of other datatypes, e.g. TIME, do not get a const_value in stage 3);
+ *    - the FB body itself never writes to that input.
+ *
+ *  To limit the growth of the generated code, each FB type gets at most
+ *  MAX_SPECIALIZATIONS_PER_FB specialised bodies, and the specialised bodies may not
+ *  contain more than MAX_SPECIALIZED_STATEMENTS statements (IL instructions) in total.
+ *
+ *  NOTE: forcing an input of a specialised instance with the debugger has no effect on
+ *        the execution of the FB body.
+ */
+
+
+#include <vector>
+
+
+#define MAX_SPECIALIZATIONS_PER_FB     8
+#define MAX_SPECIALIZED_STATEMENTS  2000
+
+
+/* The inputs of a FB bound to a constant value: maps the input name to the (constant folded) value. */
+typedef std::map<std::string, symbol_c *, nocasecmp_c> specialized_inputs_t;
+
+
+
+/* Count the statements (and IL instructions) in a POU body, including the nested ones. */
+class generate_c_count_statements_c: public iterator_visitor_c {
+  public:
+    int count;
+
+    generate_c_count_statements_c(void) {count = 0;}
+    ~generate_c_count_statements_c(void) {}
+
+    void *visit(statement_list_c   *symbol) {count += symbol->n; return iterator_visitor_c::visit(symbol);}
+    void *visit(instruction_list_c *symbol) {count += symbol->n; return iterator_visitor_c::visit(symbol);}
+}; /* generate_c_count_statements_c */
+
+
+
+
+class generate_c_fb_specialization_c: public iterator_visitor_c {
+  public:
+    typedef struct {
+      function_block_declaration_c *fb_decl;
+      std::string suffix;              /* appended to the FB type name in the name of the specialised body */
+      specialized_inputs_t inputs;
+    } specialization_t;
+
+  private:
+    typedef std::vector<specialization_t *> specialization_list_t;
+    typedef std::map<std::string, specialization_t *, nocasecmp_c> instance_map_t;
+
+    /* all the specialised bodies, in the order they were created */
+    static specialization_list_t specializations;
+    /* maps each POU declaration to the specialization used by each FB instance it declares */
+    static std::map<symbol_c *, instance_map_t> instances;
+    /* the FB types that may be specialised, and the names of the inputs each one writes to */
+    static std::map<symbol_c *, byref_inputs_t> candidate_fbs;
+    static int specialized_statements;
+
+    /* The FB instances invoked in the POU being analysed, and the inputs bound to a constant
+     * on every invocation seen so far. An instance mapped to a NULL fb_decl may not be specialised.
+     */
+    typedef struct {
+      function_block_declaration_c *fb_decl;
+      specialized_inputs_t inputs;
+    } candidate_t;
+    typedef std::map<std::string, candidate_t, nocasecmp_c> candidate_map_t;
+
+    search_var_instance_decl_c search_var_instance_decl;
+    candidate_map_t candidates;
+
+    generate_c_fb_specialization_c(symbol_c *pou_decl): search_var_instance_decl(pou_decl) {}
+    ~generate_c_fb_specialization_c(void) {}
+
+  public:
+    /* Determine which FB instances of the library <tree_root> are invoked through a specialised body.
+     * Must be called before generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root) {
+      for (unsigned int i = 0; i < specializations.size(); i++)
+        delete specializations[i];
+      specializations.clear();
+      instances.clear();
+      candidate_fbs.clear();
+      specialized_statements = 0;
+
+      if (!generate_fb_specialization__) return; /* global variable generate_fb_specialization__ is defined in generate_c.cc */
+      library_c *library = dynamic_cast<library_c *>(tree_root);
+      if (NULL == library) return;
+
+      /* 1st pass: the FB types whose code is generated in ST or IL... */
+      bool code_generation = true;
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->get_element(i);
+        if (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))  code_generation = true;
+        if (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element))  code_generation = false;
+        function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(element);
+        if ((NULL == fb_decl) || !code_generation) continue;
+        if (   (NULL == dynamic_cast<statement_list_c   *>(fb_decl->fblock_body))
+            && (NULL == dynamic_cast<instruction_list_c *>(fb_decl->fblock_body)))  continue;
+        generate_c_written_vars_c search_written_vars(candidate_fbs[fb_decl]);
+        fb_decl->fblock_body->accept(search_written_vars);
+      }
+
+      /* 2nd pass: ... invoked with constant inputs from the Programs and FBs whose code is generated. */
+      code_generation = true;
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->get_element(i);
+        if (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))  code_generation = true;
+        if (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element))  code_generation = false;
+        if (!code_generation || !generate_c_dead_code_c::is_reachable(element)) continue;
+        function_block_declaration_c *fb_decl   = dynamic_cast<function_block_declaration_c *>(element);
+        program_declaration_c        *prog_decl = dynamic_cast<program_declaration_c        *>(element);
+        if (NULL != fb_decl)    analyse_pou(fb_decl,   fb_decl->fblock_body);
+        if (NULL != prog_decl)  analyse_pou(prog_decl, prog_decl->function_block_body);
+      }
+    }
+
+    /* Returns the suffix of the name of the specialised body through which the FB instance <fb_name>,
+     * declared in the POU <pou_decl>, is invoked, or an empty string if it uses the generic FB body.
+     */
+    static std::string get_suffix(symbol_c *pou_decl, symbol_c *fb_name) {
+      specialization_t *specialization = get_instance(pou_decl, fb_name);
+      return (NULL == specialization)? std::string("") : specialization->suffix;
+    }
+
+    /* Returns the number of specialised bodies of the FB type <fb_decl>. */
+    static unsigned int get_count(symbol_c *fb_decl) {
+      unsigned int count = 0;
+      for (unsigned int i = 0; i < specializations.size(); i++)
+        if (specializations[i]->fb_decl == fb_decl) count++;
+      return count;
+    }
+
+    /* Returns the n'th specialised body of the FB type <fb_decl> (0 <= n < get_count(fb_decl)). */
+    static const specialization_t *get(symbol_c *fb_decl, unsigned int n) {
+      for (unsigned int i = 0; i < specializations.size(); i++)
+        if ((specializations[i]->fb_decl == fb_decl) && (0 == n--)) return specializations[i];
+      ERROR;
+      return NULL;
+    }
+
+  private:
+    static token_c *get_instance_name(symbol_c *fb_name) {
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(fb_name);
+      if (NULL != variable) fb_name = variable->var_name;
+      return dynamic_cast<token_c *>(fb_name);
+    }
+
+    static specialization_t *get_instance(symbol_c *pou_decl, symbol_c *fb_name) {
+      std::map<symbol_c *, instance_map_t>::iterator pou = instances.find(pou_decl);
+      token_c *name = get_instance_name(fb_name);
+      if ((pou == instances.end()) || (NULL == name)) return NULL;
+      instance_map_t::iterator instance = pou->second.find(name->value);
+      return (instance == pou->second.end())? NULL : instance->second;
+    }
+
+    /* Is <value> a constant we are able to print as a literal of the datatype <type>?
+     * NOTE: must be kept in sync with generate_c_base_c::print_const_value()
+     */
+    static bool is_constant(symbol_c *value, symbol_c *type) {
+      if ((NULL == value) || !get_datatype_info_c::is_type_equal(value->datatype, type)) return false;
+      if (get_datatype_info_c::is_ANY_signed_INT(type))
+        return value->const_value._int64.is_valid()  && (value->const_value._int64.get() != INT64_MIN);
+      if (get_datatype_info_c::is_ANY_unsigned_INT(type) || get_datatype_info_c::is_ANY_nBIT(type))
+        return value->const_value._uint64.is_valid() && (value->const_value._uint64.get() <= (uint64_t)INT64_MAX);
+      if (get_datatype_info_c::is_ANY_REAL(type)) {
+        if (!value->const_value._real64.is_valid()) return false;
+        real64_t real = value->const_value._real64.get();
+        return (real == real) && (real - real == 0); /* not NaN nor infinity */
+      }
+      if (get_datatype_info_c::is_BOOL(type))
+        return value->const_value._bool.is_valid();
+      return false;
+    }
+
+    /* Do the two constants <value1> and <value2> (of the same datatype) have the same value? */
+    static bool is_same_value(symbol_c *value1, symbol_c *value2) {
+      symbol_c *type = value1->datatype;
+      if (get_datatype_info_c::is_ANY_signed_INT(type))
+        return value1->const_value._int64.get()  == value2->const_value._int64.get();
+      if (get_datatype_info_c::is_ANY_unsigned_INT(type) || get_datatype_info_c::is_ANY_nBIT(type))
+        return value1->const_value._uint64.get() == value2->const_value._uint64.get();
+      if (get_datatype_info_c::is_ANY_REAL(type))
+        return value1->const_value._real64.get() == value2->const_value._real64.get();
+      return value1->const_value._bool.get() == value2->const_value._bool.get();
+    }
+
+    static bool is_same_inputs(const specialized_inputs_t &inputs1, const specialized_inputs_t &inputs2) {
+      if (inputs1.size() != inputs2.size()) return false;
+      specialized_inputs_t::const_iterator it1, it2;
+      for (it1 = inputs1.begin(), it2 = inputs2.begin(); it1 != inputs1.end(); it1++, it2++)
+        if ((nocasecmp_c()(it1->first, it2->first)) || (nocasecmp_c()(it2->first, it1->first)) || !is_same_value(it1->second, it2->second))
+          return false;
+      return true;
+    }
+
+    /* Find (or create, if still within the code size budget) the specialization of <fb_decl> for the constant <inputs> */
+    static specialization_t *get_specialization(function_block_declaration_c *fb_decl, const specialized_inputs_t &inputs) {
+      for (unsigned int i = 0; i < specializations.size(); i++)
+        if ((specializations[i]->fb_decl == fb_decl) && is_same_inputs(specializations[i]->inputs, inputs))
+          return specializations[i];
+
+      unsigned int count = get_count(fb_decl);
+      if (count >= MAX_SPECIALIZATIONS_PER_FB) return NULL;
+      generate_c_count_statements_c count_statements;
+      fb_decl->fblock_body->accept(count_statements);
+      if (specialized_statements + count_statements.count > MAX_SPECIALIZED_STATEMENTS) return NULL;
+      specialized_statements += count_statements.count;
+
+      char suffix[32];
+      snprintf(suffix, sizeof(suffix), "__SPEC%u", count + 1);
+      specialization_t *specialization = new specialization_t;
+      specialization->fb_decl = fb_decl;
+      specialization->suffix  = suffix;
+      specialization->inputs  = inputs;
+      specializations.push_back(specialization);
+      return specialization;
+    }
+
+    static void analyse_pou(symbol_c *pou_decl, symbol_c *body) {
+      generate_c_fb_specialization_c search(pou_decl);
+      body->accept(search);
+
+      /* instances (or their inputs) written to directly may not be specialised */
+      byref_inputs_t written_vars;
+      generate_c_written_vars_c search_written_vars(written_vars);
+      body->accept(search_written_vars);
+
+      candidate_map_t::iterator it;
+      for (it = search.candidates.begin(); it != search.candidates.end(); it++) {
+        if ((NULL == it->second.fb_decl) || it->second.inputs.empty()) continue;
+        if (written_vars.find(it->first) != written_vars.end()) continue;
+        specialization_t *specialization = get_specialization(it->second.fb_decl, it->second.inputs);
+        if (NULL != specialization)
+          instances[pou_decl][it->first] = specialization;
+      }
+    }
+
+    /* Do not specialise the FB instance named <name> */
+    void exclude(const std::string &name) {
+      candidates[name].fb_decl = NULL;
+      candidates[name].inputs.clear();
+    }
+
+    /* An invocation of the FB instance <fb_name> */
+    void handle_call(symbol_c *fb_call, symbol_c *fb_name, symbol_c *called_fb_decl) {
+      token_c *name = get_instance_name(fb_name);
+      if (NULL == name) return;
+      function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(called_fb_decl);
+      std::map<symbol_c *, byref_inputs_t>::iterator fb = candidate_fbs.find(fb_decl);
+      if (   (NULL == fb_decl) || (fb == candidate_fbs.end())
+          || (search_var_instance_decl.get_vartype(name) != search_var_instance_decl_c::private_vt)) {
+        exclude(name->value);
+        return;
+      }
+
+      bool first_call = (candidates.find(name->value) == candidates.end());
+      candidate_t &candidate = candidates[name->value];
+      if (first_call) candidate.fb_decl = fb_decl;
+      if (NULL == candidate.fb_decl) return; /* already excluded */
+
+      specialized_inputs_t inputs;
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(fb_call, fb_decl);
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.param_direction != function_param_iterator_c::direction_in) continue;
+        token_c *param_name = dynamic_cast<token_c *>(binding.decl_param_name);
+        if ((NULL == param_name) || (0 == strcasecmp(param_name->value, "EN"))) continue;
+        if (fb->second.find(param_name->value) != fb->second.end()) continue; /* written to by the FB body */
+        if (!is_constant(binding.param_value, binding.param_type)) continue;
+        if (!first_call) {
+          specialized_inputs_t::iterator prev = candidate.inputs.find(param_name->value);
+          if ((prev == candidate.inputs.end()) || !is_same_value(prev->second, binding.param_value)) continue;
+        }
+        inputs[param_name->value] = binding.param_value;
+      }
+      candidate.inputs = inputs;
+    }
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    /* Any use of a FB instance other than invoking it, or reading one of its outputs. */
+    void *visit(symbolic_variable_c *symbol) {
+      token_c *name = get_instance_name(symbol);
+      if (NULL != name) exclude(name->value);
+      return NULL;
+    }
+
+    /* Reading (or writing, which is handled in analyse_pou()) a field of a FB instance. */
+    void *visit(structured_variable_c *symbol) {
+      if (NULL == dynamic_cast<symbolic_variable_c *>(symbol->record_variable))
+        symbol->record_variable->accept(*this);
+      return NULL;
+    }
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    void *visit(il_fb_call_c *symbol) {
+      handle_call(symbol, symbol->fb_name, symbol->called_fb_declaration);
+      if (NULL != symbol->il_operand_list) symbol->il_operand_list->accept(*this);
+      if (NULL != symbol->il_param_list)   symbol->il_param_list  ->accept(*this);
+      return NULL;
+    }
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    void *visit(fb_invocation_c *symbol) {
+      handle_call(symbol, symbol->fb_name, symbol->called_fb_declaration);
+      if (NULL != symbol->formal_param_list)    symbol->formal_param_list   ->accept(*this);
+      if (NULL != symbol->nonformal_param_list) symbol->nonformal_param_list->accept(*this);
+      return NULL;
+    }
+}; /* generate_c_fb_specialization_c */
+
+
+generate_c_fb_specialization_c::specialization_list_t                       generate_c_fb_specialization_c::specializations;
+std::map<symbol_c *, generate_c_fb_specialization_c::instance_map_t>        generate_c_fb_specialization_c::instances;
+std::map<symbol_c *, byref_inputs_t>                                        generate_c_fb_specialization_c::candidate_fbs;
+int                                                                         generate_c_fb_specialization_c::specialized_statements = 0;
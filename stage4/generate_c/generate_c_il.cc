@@ -81,9 +81,10 @@ class il_default_variable_visitor_c {
  *
  * It includes a reference to its name,
  * and the data type of the data currently stored
- * in this C++ variable... This is required because the
- * C++ variable is a union, and we must know which member
- * of the union top reference!!
+ * in this C++ variable... This is required because there
+ * is a distinct C++ variable for each data type (see
+ * il_implicit_variable_types_c), and we must know which
+ * one to reference!!
  *
  * Note that we also need to keep track of the data type of
  * the value currently being stored in the IL implicit variable.
@@ -123,10 +124,76 @@ class il_default_variable_c: public symbol_c {
 /***********************************************************************/
 
 
+/* The IL implicit variable is not stored in a single C variable (e.g. a
+ * union of all the elementary datatypes), but rather in one distinct C
+ * variable for each datatype it may hold, named after that datatype
+ * (e.g. __IL_DEFVAR_INT, __IL_DEFVAR_BOOL, ...). Since stage3 guarantees
+ * that all the IL instructions that may precede any given IL instruction
+ * leave a value of the same datatype in the implicit variable, every
+ * IL instruction always reads the value from the same C variable its
+ * predecessors have written to. The C compiler is then free to keep
+ * each of these variables in a register.
+ *
+ * This class determines which of these C variables must be declared
+ * in the C scope generated for an instruction list (or a parenthesised
+ * simple_instr_list), i.e. the datatypes left in the implicit variable
+ * by the IL instructions in that list (not including the instructions
+ * inside parenthesis, which get their own C scope), and the datatypes
+ * of the results of the parenthesised instruction lists (which are
+ * passed out of their scope in the IL_DEFVAR_BACK variables).
+ */
+class il_implicit_variable_types_c: public iterator_visitor_c {
+  public:
+    typedef std::map<std::string, symbol_c *> datatypes_t;
 
+    datatypes_t current_types; /* datatypes of the implicit variable of the list */
+    datatypes_t back_types;    /* datatypes of the results of the parenthesised lists */
 
+  private:
+    int depth;
 
-class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_visitor_c {
+    void add_datatype(datatypes_t &datatypes, symbol_c *datatype) {
+      if (NULL == datatype) return; /* e.g. an IL instruction that only contains a label */
+      const char *id_str = get_datatype_info_c::get_id_str(datatype);
+      if (NULL == id_str) ERROR;
+      datatypes[id_str] = datatype;
+    }
+
+  public:
+    /* If symbol is an instruction list (or simple_instr_list), the datatypes of the C
+     * scope generated for that list are determined. Any other symbol (e.g. a
+     * transition_condition_c) is handled as if it were inside the current C scope.
+     */
+    il_implicit_variable_types_c(symbol_c *symbol): depth(0) {
+      list_c *list = dynamic_cast<list_c *>(symbol);
+      if (NULL == list) {symbol->accept(*this); return;}
+      for(int i = 0; i < list->n; i++)
+        list->get_element(i)->accept(*this);
+    }
+
+    void *visit(il_instruction_c *symbol) {
+      if (0 == depth) add_datatype(current_types, symbol->datatype);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(il_simple_instruction_c *symbol) {
+      if (0 == depth) add_datatype(current_types, symbol->datatype);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(simple_instr_list_c *symbol) {
+      add_datatype(back_types, symbol->datatype);
+      depth++;
+      iterator_visitor_c::visit(symbol);
+      depth--;
+      return NULL;
+    }
+};
+
+
+
+
+class generate_c_il_c:public generate_c_base_and_typeid_c, il_default_variable_visitor_c {
 
   public:
     typedef enum {
@@ -147,9 +214,7 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
      */
     symbol_c *jump_label;
 
-    /* the data type of the IL implicit variable... */
-    #define IL_DEFVAR_T VAR_LEADER "IL_DEFVAR_T"
-    /* The name of the IL implicit variable... */
+    /* The name of the IL implicit variable (to which the name of its datatype is appended)... */
     #define IL_DEFVAR   VAR_LEADER "IL_DEFVAR"
     /* The name of the variable used to pass the result of a
      * parenthesised instruction list to the immediately preceding
@@ -190,6 +255,8 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
     symbol_c* current_array_type;
     symbol_c* current_param_type;
 
+    symbol_c *scope_;
+
     int fcall_number;
     symbol_c *fbname;
 
@@ -205,6 +272,7 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
       search_fb_instance_decl    = new search_fb_instance_decl_c   (scope);
       search_varfb_instance_type = new search_varfb_instance_type_c(scope);
       search_var_instance_decl   = new search_var_instance_decl_c  (scope);
+      scope_ = scope;
       
       current_operand = NULL;
       current_array_type = NULL;
@@ -226,30 +294,39 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
     }
 
   private:
-    /* Declare an implicit IL variable... */
-    void declare_implicit_variable(il_default_variable_c *implicit_var) {
-      s4o.print(s4o.indent_spaces);
-      s4o.print(IL_DEFVAR_T);
-      s4o.print(" ");
+    /* Declare an implicit IL variable, once for each of the datatypes it may hold... */
+    void declare_implicit_variable(il_default_variable_c *implicit_var, il_implicit_variable_types_c::datatypes_t &datatypes) {
+      il_implicit_variable_types_c::datatypes_t::iterator it;
+      for(it = datatypes.begin(); it != datatypes.end(); it++) {
+        s4o.print(s4o.indent_spaces);
+        s4o.print(it->first);
+        s4o.print(" ");
+        implicit_var->datatype = it->second;
+        implicit_var->accept(*this);
+        s4o.print(";\n");
+      }
       implicit_var->datatype = NULL;
-      implicit_var->accept(*this);
-      s4o.print(";\n");
     }
-    
-  public:  
-    /* Declare the default variable, that will store the result of the IL operations */
-    void declare_implicit_variable(void) {
-      declare_implicit_variable(&this->implicit_variable_result);
+
+  public:
+    /* Declare the default variable, that will store the result of the IL operations in il_list */
+    void declare_implicit_variable(list_c *il_list) {
+      il_implicit_variable_types_c il_types(il_list);
+      declare_implicit_variable(&this->implicit_variable_result, il_types.current_types);
     }
-    
+
     /* Declare the backup to the default variable, that will store the result of the IL operations executed inside a parenthesis... */
-    void declare_implicit_variable_back(void) {
-      declare_implicit_variable(&this->implicit_variable_result_back);
+    void declare_implicit_variable_back(symbol_c *symbol) {
+      il_implicit_variable_types_c il_types(symbol);
+      declare_implicit_variable(&this->implicit_variable_result_back, il_types.back_types);
     }
-    
-    void print_implicit_variable_back(void) {
+
+    /* Print the backup to the default variable, holding the result of the parenthesised il_list */
+    void print_implicit_variable_back(symbol_c *il_list) {
+      this->implicit_variable_result_back.datatype = il_list->datatype;
       this->implicit_variable_result_back.accept(*this);
-    }    
+      this->implicit_variable_result_back.datatype = NULL;
+    }
 
 
   private:
@@ -351,6 +428,10 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
 
 
     void *print_getter(symbol_c *symbol) {
+      /* variables promoted to C local variables are never passed by reference (i.e. with fparam_output_vg) */
+      if (print_promoted_var(symbol))
+        return NULL;
+
       unsigned int vartype = search_var_instance_decl->get_vartype(symbol);
       if (wanted_variablegeneration == fparam_output_vg) {
         if (vartype == search_var_instance_decl_c::external_vt) {
@@ -398,6 +479,19 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
             symbol_c* fb_value = NULL,
             bool negative = false) {
 
+      if ((fb_symbol == NULL) && print_promoted_var(symbol)) {
+        s4o.print(" = ");
+        if (negative) {
+          if (get_datatype_info_c::is_BOOL_compatible(this->current_operand->datatype))
+            s4o.print("!");
+          else
+            s4o.print("~");
+        }
+        wanted_variablegeneration = expression_vg;
+        print_check_function(type, value, fb_value);
+        return NULL;
+      }
+
       bool type_is_complex = false;
       if (fb_symbol == NULL) {
         unsigned int vartype = search_var_instance_decl->get_vartype(symbol);
@@ -473,12 +567,14 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
 
 public:
 void *visit(il_default_variable_c *symbol) {
+  /* the implicit variable must always hold a value of a known datatype when it is referenced */
+  if (NULL == symbol->datatype) ERROR;
+  const char *id_str = get_datatype_info_c::get_id_str(symbol->datatype);
+  if (NULL == id_str) ERROR;
   symbol->var_name->accept(*this);
-  if (NULL != symbol->datatype) {
-    s4o.print(".");
-    symbol->datatype->accept(*this);
-    s4o.print("var");
-  } return NULL;
+  s4o.print("_");
+  s4o.print(id_str);
+  return NULL;
 }
 
 
@@ -521,7 +617,13 @@ void *visit(symbolic_variable_c *symbol) {
     case complextype_suffix_vg:
       break;
     default:
+      if ((wanted_variablegeneration == expression_vg) && print_const_value(symbol))
+        break; /* a CONSTANT variable, whose value is known at compile time */
+      if ((wanted_variablegeneration == expression_vg) && print_specialized_input(symbol))
+        break; /* an input bound to a constant, in a specialised FB body */
       if (this->is_variable_prefix_null()) {
+        if (print_byref_input(symbol))
+          break; /* a Function input passed by pointer - never written to, so never passed with fparam_output_vg */
         vartype = search_var_instance_decl->get_vartype(symbol);
         if (wanted_variablegeneration == fparam_output_vg) {
           s4o.print("&(");
@@ -705,10 +807,10 @@ void *visit(array_initial_elements_list_c *symbol) {
 void *visit(instruction_list_c *symbol) {
   
   /* Declare the IL implicit variable, that will store the result of the IL operations... */
-  declare_implicit_variable();
+  declare_implicit_variable(symbol);
 
   /* Declare the backup to the IL implicit variable, that will store the result of the IL operations executed inside a parenthesis... */
-  declare_implicit_variable_back();
+  declare_implicit_variable_back(symbol);
   
   for(int i = 0; i < symbol->n; i++) {
     print_line_directive(symbol->get_element(i));
@@ -761,24 +863,18 @@ void *visit(il_function_call_c *symbol) {
   symbol_c* function_type_suffix = NULL;
   DECLARE_PARAM_LIST()
   
-  function_call_param_iterator_c function_call_param_iterator(symbol);
-
   function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
   if (f_decl == NULL) ERROR;
 
   function_name = symbol->function_name;
   
-  /* loop through each function parameter, find the value we should pass
-   * to it, and then output the c equivalent...
+  /* loop through each function parameter, get the value we should pass
+   * to it (already resolved by stage 3), and then output the c equivalent...
    */
-  function_param_iterator_c fp_iterator(f_decl);
-  identifier_c *param_name;
-    /* flag to remember whether we have already used the value stored in the implicit variable to pass to the first parameter */
-  bool used_defvar = false; 
-    /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-  bool found_first_extensible_parameter = false;  
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    if (binding.extensible_count) {
       /* We are calling an extensible function. Before passing the extensible
        * parameters, we must add a dummy paramater value to tell the called
        * function how many extensible parameters we will be passing.
@@ -800,72 +896,31 @@ void *visit(il_function_call_c *symbol) {
       uint_type_name_c *param_type  = new uint_type_name_c();
       identifier_c *param_name = new identifier_c("");
       ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-      found_first_extensible_parameter = true;
+      continue;
     }
-    
-    symbol_c *param_type = fp_iterator.param_type();
-    if (param_type == NULL) ERROR;
-    
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-    
-    symbol_c *param_value = NULL;
-
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    /* NOTE: Since the class il_function_call_c only references a non.formal function call,
-     * the following line of code is not required in this case. However, it doesn't
-     * harm to leave it in, as in the case of a non-formal syntax function call,
-     * it will always return NULL.
-     * We leave it in in case we later decide to merge this part of the code together
-     * with the function calling code in generate_c_st_c, which does require
-     * the following line...
-     */
-    if (param_value == NULL)
-      param_value = function_call_param_iterator.search_f(param_name);
+
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+    symbol_c *param_value = binding.param_value;
 
     /* if it is the first parameter in a non-formal function call (which is the
      * case being handled!), semantics specifies that we should
      * get the value off the IL implicit variable!
-     *
-     * However, if the parameter is an implicitly defined EN or ENO parameter, we should not
-     * use the IL implicit variable as a source of data to pass to those parameters!
      */
-    if ((param_value == NULL) &&  (!used_defvar) && !fp_iterator.is_en_eno_param_implicit()) {
+    if (binding.implicit_variable) {
       if (NULL == implicit_variable_current.datatype) ERROR;
       param_value = &this->implicit_variable_current;
-      used_defvar = true;
     }
 
-    /* Get the value from a foo(<param_value>) style call */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-      param_value = function_call_param_iterator.next_nf();
-    }
-    
-    /* if no more parameter values in function call, and the current parameter
-     * of the function declaration is an extensible parameter, we
-     * have reached the end, and should simply jump out of the for loop.
-     */
-    if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-      break;
-    }
-    
-    /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
-    /* Note that in IL function calls the syntax does not allow embeded IL lists, so this check is not necessary here! */
-    /*
-    {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
-     if (NULL != instruction_list) STAGE4_ERROR(param_value, param_value, "The compiler does not yet support formal invocations in IL that contain embedded IL lists. Aborting!");
-    }
-    */
-    
     if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
       /* No value given for parameter, so we must use the default... */
       /* First check whether default value specified in function declaration...*/
-      param_value = fp_iterator.default_value();
+      param_value = binding.default_value;
     }
-    
-    ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
+
+    ADD_PARAM_LIST(binding.decl_param_name, param_value, binding.param_type, param_direction)
   } /* for(...) */
 
-  if (function_call_param_iterator.next_nf() != NULL) ERROR;
+  if (param_bindings.unbound_values) ERROR;
 
   bool has_output_params = false;
 
@@ -943,6 +998,16 @@ void *visit(il_function_call_c *symbol) {
           param_value = type_initial_value_c::get(current_param_type);
         }
         if (param_value == NULL) ERROR;
+        if (generate_c_byref_inputs_c::is_byref(f_decl, PARAM_NAME)) {
+          /* an ARRAY or STRUCT input passed by pointer (see generate_c_byref_inputs.cc) */
+          s4o.print("(const ");
+          current_param_type->accept(*this);
+          s4o.print(" *)&(");
+          param_value->accept(*this);
+          s4o.print(")");
+          nb_param++;
+          break;
+        }
         s4o.print("(");
         if (get_datatype_info_c::is_ANY_INT_literal(current_param_type))
           get_datatype_info_c::lint_type_name.accept(*this);
@@ -1063,33 +1128,22 @@ void *visit(il_fb_call_c *symbol) {
   if (iter == function_block_type_symtable.end()) ERROR; // The function block type being called MUST be in the symtable.
   function_block_declaration_c *fb_decl = iter->second;
 
-  /* loop through each function block parameter, find the value we should pass
-   * to it, and then output the c equivalent...
+  /* loop through each function block parameter, get the value we should pass
+   * to it (already resolved by stage 3), and then output the c equivalent...
    */
-  function_param_iterator_c fp_iterator(fb_decl);
-  identifier_c *param_name;
-  function_call_param_iterator_c function_call_param_iterator(symbol);
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, fb_decl);
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    symbol_c *param_name  = binding.param_name;
+    symbol_c *param_value = binding.param_value;
+    symbol_c *param_type  = binding.param_type;
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
 
     /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
     {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
      if (NULL != instruction_list) STAGE4_ERROR(param_value, param_value, "The compiler does not yet support formal invocations in IL that contain embedded IL lists. Aborting!");
     }
     
-    symbol_c *param_type = fp_iterator.param_type();
-    if (param_type == NULL) ERROR;
-    
         /* now output the value assignment */
     if (param_value != NULL)
       if ((param_direction == function_param_iterator_c::direction_in) ||
@@ -1110,6 +1164,7 @@ void *visit(il_fb_call_c *symbol) {
 
   /* now call the function... */
   function_block_type_name->accept(*this);
+  s4o.print(generate_c_fb_specialization_c::get_suffix(scope_, symbol->fb_name));
   s4o.print(FB_FUNCTION_SUFFIX);
   s4o.print("(");
   if (search_var_instance_decl->get_vartype(symbol->fb_name) != search_var_instance_decl_c::external_vt)
@@ -1121,20 +1176,11 @@ void *visit(il_fb_call_c *symbol) {
   /* loop through each function parameter, find the variable to which
    * we should atribute the value of all output or inoutput parameters.
    */
-  fp_iterator.reset();
-  function_call_param_iterator.reset();
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    symbol_c *param_name  = binding.param_name;
+    symbol_c *param_value = binding.param_value;
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
 
     /* now output the value assignment */
     if (param_value != NULL)
@@ -1171,23 +1217,18 @@ void *visit(il_formal_funct_call_c *symbol) {
   symbol_c* function_type_suffix = NULL;
   DECLARE_PARAM_LIST()
 
-  function_call_param_iterator_c function_call_param_iterator(symbol);
-
   function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
   if (f_decl == NULL) ERROR;
         
   function_name = symbol->function_name;
 
-  /* loop through each function parameter, find the value we should pass
-   * to it, and then output the c equivalent...
+  /* loop through each function parameter, get the value we should pass
+   * to it (already resolved by stage 3), and then output the c equivalent...
    */
-  function_param_iterator_c fp_iterator(f_decl);
-  identifier_c *param_name;
-
-    /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-  bool found_first_extensible_parameter = false;
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    if (binding.extensible_count) {
       /* We are calling an extensible function. Before passing the extensible
        * parameters, we must add a dummy paramater value to tell the called
        * function how many extensible parameters we will be passing.
@@ -1209,67 +1250,27 @@ void *visit(il_formal_funct_call_c *symbol) {
       uint_type_name_c *param_type  = new uint_type_name_c();
       identifier_c *param_name = new identifier_c("");
       ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-      found_first_extensible_parameter = true;
+      continue;
     }
-    
-    if (fp_iterator.is_extensible_param()) {      
-      /* since we are handling an extensible parameter, we must add the index to the
-       * parameter name so we can go looking for the value passed to the correct
-       * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
-       */
-      char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
-      int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
-      if ((res >= 32) || (res < 0)) ERROR;
-      param_name = new identifier_c(strdup2(param_name->value, tmp));
-      if (param_name->value == NULL) ERROR;
-    }
-
-    symbol_c *param_type = fp_iterator.param_type();
-    if (param_type == NULL) ERROR;
-
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
 
-    symbol_c *param_value = NULL;
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+    symbol_c *param_value = binding.param_value;
 
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    if (param_value == NULL)
-      param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* NOTE: the following line of code is not required in this case, but it doesn't
-     * harm to leave it in, as in the case of a formal syntax function call,
-     * it will always return NULL.
-     * We leave it in in case we later decide to merge this part of the code together
-     * with the function calling code in generate_c_st_c, which does require
-     * the following line...
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-      param_value = function_call_param_iterator.next_nf();
-    }
-    
-    /* if no more parameter values in function call, and the current parameter
-     * of the function declaration is an extensible parameter, we
-     * have reached the end, and should simply jump out of the for loop.
-     */
-    if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-      break;
-    }
-    
     /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
     {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
      if (NULL != instruction_list) STAGE4_ERROR(param_value, param_value, "The compiler does not yet support formal invocations in IL that contain embedded IL lists. Aborting!");
     }
-    
+
     if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
       /* No value given for parameter, so we must use the default... */
       /* First check whether default value specified in function declaration...*/
-      param_value = fp_iterator.default_value();
+      param_value = binding.default_value;
     }
-    
-    ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
-  }
-  
-  if (function_call_param_iterator.next_nf() != NULL) ERROR;
+
+    ADD_PARAM_LIST(binding.param_name, param_value, binding.param_type, param_direction)
+  } /* for(...) */
+
+  if (param_bindings.unbound_values) ERROR;
 
   bool has_output_params = false;
 
@@ -1348,6 +1349,16 @@ void *visit(il_formal_funct_call_c *symbol) {
           param_value = type_initial_value_c::get(current_param_type);
         }
         if (param_value == NULL) ERROR;
+        if (generate_c_byref_inputs_c::is_byref(f_decl, PARAM_NAME)) {
+          /* an ARRAY or STRUCT input passed by pointer (see generate_c_byref_inputs.cc) */
+          s4o.print("(const ");
+          current_param_type->accept(*this);
+          s4o.print(" *)&(");
+          param_value->accept(*this);
+          s4o.print(")");
+          nb_param++;
+          break;
+        }
         s4o.print("(");
         if      (get_datatype_info_c::is_ANY_INT_literal(current_param_type))
                  get_datatype_info_c::lint_type_name.accept(*this);
@@ -1420,20 +1431,20 @@ void *visit(simple_instr_list_c *symbol) {
    * value to the outside scope...
    *
    * The above example will result in the following C++ code:
-   * {__IL_DEFVAR_T __IL_DEFVAR_BACK;
-   *  __IL_DEFVAR_T __IL_DEFVAR;
+   * {INT __IL_DEFVAR_INT;
+   *  INT __IL_DEFVAR_BACK_INT;
    *
-   *  __IL_DEFVAR.INTvar = var1;
+   *  __IL_DEFVAR_INT = var1;
    *  {
-   *    __IL_DEFVAR_T __IL_DEFVAR;
+   *    INT __IL_DEFVAR_INT;
    *
-   *    __IL_DEFVAR.INTvar = var2;
-   *    __IL_DEFVAR.INTvar |= var3;
-   *    __IL_DEFVAR.INTvar |= var4;
+   *    __IL_DEFVAR_INT = var2;
+   *    __IL_DEFVAR_INT |= var3;
+   *    __IL_DEFVAR_INT |= var4;
    *
-   *    __IL_DEFVAR_BACK = __IL_DEFVAR;
+   *    __IL_DEFVAR_BACK_INT = __IL_DEFVAR_INT;
    *  }
-   *  __IL_DEFVAR.INTvar &= __IL_DEFVAR_BACK.INTvar;
+   *  __IL_DEFVAR_INT &= __IL_DEFVAR_BACK_INT;
    *
    * }
    *
@@ -1447,7 +1458,7 @@ void *visit(simple_instr_list_c *symbol) {
   /* Declare the IL implicit variable, that will store the result of the IL operations... */
   s4o.print("{\n");
   s4o.indent_right();
-  declare_implicit_variable();
+  declare_implicit_variable(symbol);
     
   print_list(symbol, s4o.indent_spaces, ";\n" + s4o.indent_spaces, ";\n");
 
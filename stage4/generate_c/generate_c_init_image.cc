@@ -0,0 +1,107 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Initial value images of Function Block instances.
+ *
+ *  Each FB instance is initialised by calling FBNAME_init__(), which sets each
+ *  variable (and each element of each array) one by one, and recursively calls
+ *  the _init__() function of every FB instance declared inside the FB.
+ *  With thousands of FB instances this takes a significant time at start up.
+ *
+ *  All instances of the same FB type end up with exactly the same initial state
+ *  (apart from the retain flag, which is passed as a parameter), so the
+ *  FBNAME_init__() function keeps a copy (image) of the first instance it
+ *  initialises, and initialises all the following instances with a single
+ *  memcpy() of that image. One image is kept for each value of the retain flag.
+ *
+ *  This is only valid if the state of an initialised instance does not depend on
+ *  the instance itself, and initialising it has no side effects outside the instance.
+ *  We therefore do not use an image if the FB (or any FB instance declared inside it,
+ *  directly or in an ARRAY of FBs):
+ *    - declares located variables, whose initial value is stored at the location;
+ *    - uses REF() in an initial value, which may store the address of
+ *      a variable of the instance itself.
+ *  Note that VAR_EXTERNAL variables reference the same global variable in all instances
+ *  of a resource, and so may be safely copied (each resource includes its own copy
+ *  of POUS.c, and therefore has its own images).
+ */
+
+
+class generate_c_init_image_c: public iterator_visitor_c {
+  private:
+    typedef std::map<symbol_c *, bool> imageable_map_t;
+    /* caches the result for each function_block_declaration_c already analysed */
+    static imageable_map_t imageable_map;
+    bool imageable;
+
+    generate_c_init_image_c(void) {imageable = true;}
+    ~generate_c_init_image_c(void) {}
+
+  public:
+    /* May instances of the FB <fb_decl> be initialised by copying an initial value image? */
+    static bool is_imageable(function_block_declaration_c *fb_decl) {
+      imageable_map_t::iterator it = imageable_map.find(fb_decl);
+      if (it != imageable_map.end()) return it->second;
+
+      generate_c_init_image_c search;
+      fb_decl->var_declarations->accept(search);
+      imageable_map[fb_decl] = search.imageable;
+      return search.imageable;
+    }
+
+  private:
+    /* check the datatype of a variable declared inside the FB, looking for FB instances (or arrays of FB instances) */
+    void check_type(symbol_c *type_name) {
+      symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_name);
+      if (NULL == type_decl) return;
+      function_block_declaration_c *fb_decl = dynamic_cast<function_block_declaration_c *>(type_decl);
+      if (NULL != fb_decl) {
+        if (!is_imageable(fb_decl)) imageable = false;
+        return;
+      }
+      if (get_datatype_info_c::is_array(type_decl))
+        type_decl->accept(*this);
+    }
+
+    void *visit(located_var_declarations_c         *symbol) {imageable = false; return NULL;}
+    void *visit(incompl_located_var_declarations_c *symbol) {imageable = false; return NULL;}
+    void *visit(ref_expression_c                   *symbol) {imageable = false; return NULL;}
+
+    void *visit(simple_spec_init_c *symbol) {
+      check_type(symbol->simple_specification);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(fb_spec_init_c *symbol) {
+      check_type(symbol->function_block_type_name);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(array_specification_c *symbol) {
+      check_type(symbol->non_generic_type_name);
+      return iterator_visitor_c::visit(symbol);
+    }
+}; /* generate_c_init_image_c */
+
+
+generate_c_init_image_c::imageable_map_t generate_c_init_image_c::imageable_map;
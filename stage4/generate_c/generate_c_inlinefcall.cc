@@ -92,7 +92,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
             symbol_c *function_type_prefix,
             symbol_c *function_type_suffix,
             std::list<FUNCTION_PARAM*> param_list,
-            function_declaration_c *f_decl = NULL) {
+            function_declaration_c *f_decl = NULL,
+            symbol_c *called_function_declaration = NULL) {
 
       std::list<FUNCTION_PARAM*>::iterator pt;
       generating_inlinefunction = true;
@@ -125,8 +126,16 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
       PARAM_LIST_ITERATOR() {
         if (PARAM_DIRECTION == function_param_iterator_c::direction_in) {
-          default_literal_type(PARAM_TYPE)->accept(*this);
-          s4o.print(" ");
+          if (generate_c_byref_inputs_c::is_byref(called_function_declaration, PARAM_NAME)) {
+            /* an ARRAY or STRUCT input passed by pointer, which we simply pass on to the function */
+            s4o.print("const ");
+            PARAM_TYPE->accept(*this);
+            s4o.print(" *");
+          }
+          else {
+            default_literal_type(PARAM_TYPE)->accept(*this);
+            s4o.print(" ");
+          }
           PARAM_NAME->accept(*this);
           s4o.print(",\n" + s4o.indent_spaces);
         }
@@ -433,8 +442,6 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       symbol_c* function_type_suffix = NULL;
       DECLARE_PARAM_LIST()
 
-      function_call_param_iterator_c function_call_param_iterator(symbol);
-
       function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
       if (f_decl == NULL) ERROR;
       
@@ -443,18 +450,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       
       function_name = symbol->function_name;      
       
-      /* loop through each function parameter, find the value we should pass
-       * to it, and then output the c equivalent...
+      /* loop through each function parameter, get the value we should pass
+       * to it (already resolved by stage 3), and then output the c equivalent...
        */
-      
-      function_param_iterator_c fp_iterator(f_decl);
-      identifier_c *param_name;
-        /* flag to remember whether we have already used the value stored in the default variable to pass to the first parameter */
-      bool used_defvar = false;       
-        /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-      bool found_first_extensible_parameter = false;  
-      for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-        if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+      for(unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count) {
           /* We are calling an extensible function. Before passing the extensible
            * parameters, we must add a dummy paramater value to tell the called
            * function how many extensible parameters we will be passing.
@@ -476,71 +478,31 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
           uint_type_name_c *param_type  = new uint_type_name_c();
           identifier_c *param_name = new identifier_c(INLINE_PARAM_COUNT);
           ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-          found_first_extensible_parameter = true;
+          continue;
         }
-    
-        symbol_c *param_type = fp_iterator.param_type();
-        if (param_type == NULL) ERROR;
-      
-        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-      
-        symbol_c *param_value = NULL;
-      
-        /* Get the value from a foo(<param_name> = <param_value>) style call */
-        /* NOTE: the following line of code is not required in this case, but it doesn't
-         * harm to leave it in, as in the case of a non-formal syntax function call,
-         * it will always return NULL.
-         * We leave it in in case we later decide to merge this part of the code together
-         * with the function calling code in generate_c_st_c, which does require
-         * the following line...
-         */
-        if (param_value == NULL)
-          param_value = function_call_param_iterator.search_f(param_name);
+
+        function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+        symbol_c *param_value = binding.param_value;
 
         /* if it is the first parameter in a non-formal function call (which is the
          * case being handled!), semantics specifies that we should
-         * get the value off the IL default variable!
-         *
-         * However, if the parameter is an implicitly defined EN or ENO parameter, we should not
-         * use the default variable as a source of data to pass to those parameters!
+         * get the value off the IL implicit variable!
          */
-        if ((param_value == NULL) && (!used_defvar) && !fp_iterator.is_en_eno_param_implicit()) {
-	  if (NULL == implicit_variable_current.datatype) ERROR;
+        if (binding.implicit_variable) {
+          if (NULL == implicit_variable_current.datatype) ERROR;
           param_value = &this->implicit_variable_current;
-          used_defvar = true;
-        }
-
-        /* Get the value from a foo(<param_value>) style call */
-        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-          param_value = function_call_param_iterator.next_nf();
         }
-        
-        /* if no more parameter values in function call, and the current parameter
-         * of the function declaration is an extensible parameter, we
-         * have reached the end, and should simply jump out of the for loop.
-         */
-        if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-          break;
-        }
-      
-        /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
-        /* Note that in IL function calls the syntax does not allow embeded IL lists, so this check is not necessary here! */
-        /*
-        {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
-         if (NULL != instruction_list) STAGE4_ERROR(param_value, param_value, "The compiler does not yet support formal invocations in IL that contain embedded IL lists. Aborting!");
-        }
-        */
 
         if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
           /* No value given for parameter, so we must use the default... */
           /* First check whether default value specified in function declaration...*/
-          param_value = fp_iterator.default_value();
+          param_value = binding.default_value;
         }
-      
-        ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
+
+        ADD_PARAM_LIST(binding.decl_param_name, param_value, binding.param_type, param_direction)
       } /* for(...) */
 
-      if (function_call_param_iterator.next_nf() != NULL) ERROR;
+      if (param_bindings.unbound_values) ERROR;
       if (NULL == function_type_prefix) ERROR;
 
       bool has_output_params = false;
@@ -562,7 +524,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, symbol->called_function_declaration);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -601,8 +563,6 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       symbol_c* function_type_suffix = NULL;
       DECLARE_PARAM_LIST()
 
-      function_call_param_iterator_c function_call_param_iterator(symbol);
-
       function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
       if (f_decl == NULL) ERROR;
 
@@ -612,16 +572,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       
       function_name = symbol->function_name;
 
-      /* loop through each function parameter, find the value we should pass
-       * to it, and then output the c equivalent...
+      /* loop through each function parameter, get the value we should pass
+       * to it (already resolved by stage 3), and then output the c equivalent...
        */
-      function_param_iterator_c fp_iterator(f_decl);
-      identifier_c *param_name;
-
-        /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-      bool found_first_extensible_parameter = false;
-      for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-        if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+      for(unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count) {
           /* We are calling an extensible function. Before passing the extensible
            * parameters, we must add a dummy paramater value to tell the called
            * function how many extensible parameters we will be passing.
@@ -643,52 +600,12 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
           uint_type_name_c *param_type  = new uint_type_name_c();
           identifier_c *param_name = new identifier_c(INLINE_PARAM_COUNT);
           ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-          found_first_extensible_parameter = true;
-        }
-        
-        if (fp_iterator.is_extensible_param()) {      
-          /* since we are handling an extensible parameter, we must add the index to the
-           * parameter name so we can go looking for the value passed to the correct
-           * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
-           */
-          char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
-          int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
-          if ((res >= 32) || (res < 0)) ERROR;
-          param_name = new identifier_c(strdup2(param_name->value, tmp));
-          if (param_name->value == NULL) ERROR;
-        }
-    
-        symbol_c *param_type = fp_iterator.param_type();
-        if (param_type == NULL) ERROR;
-      
-        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-      
-        symbol_c *param_value = NULL;
-      
-        /* Get the value from a foo(<param_name> = <param_value>) style call */
-        if (param_value == NULL)
-          param_value = function_call_param_iterator.search_f(param_name);
-      
-        /* Get the value from a foo(<param_value>) style call */
-        /* NOTE: the following line of code is not required in this case, but it doesn't
-         * harm to leave it in, as in the case of a formal syntax function call,
-         * it will always return NULL.
-         * We leave it in in case we later decide to merge this part of the code together
-         * with the function calling code in generate_c_st_c, which does require
-         * the following line...
-         */
-        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-          param_value = function_call_param_iterator.next_nf();
+          continue;
         }
-        
-        /* if no more parameter values in function call, and the current parameter
-         * of the function declaration is an extensible parameter, we
-         * have reached the end, and should simply jump out of the for loop.
-         */
-        if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-          break;
-        }
-        
+
+        function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+        symbol_c *param_value = binding.param_value;
+
         /* We do not yet support embedded IL lists, so we abort the compiler if we find one */
         {simple_instr_list_c *instruction_list = dynamic_cast<simple_instr_list_c *>(param_value);
          if (NULL != instruction_list) STAGE4_ERROR(param_value, param_value, "The compiler does not yet support formal invocations in IL that contain embedded IL lists. Aborting!");
@@ -697,13 +614,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
           /* No value given for parameter, so we must use the default... */
           /* First check whether default value specified in function declaration...*/
-          param_value = fp_iterator.default_value();
+          param_value = binding.default_value;
         }
 
-        ADD_PARAM_LIST(param_name, param_value, param_type, fp_iterator.param_direction())
-      }
+        ADD_PARAM_LIST(binding.param_name, param_value, binding.param_type, param_direction)
+      } /* for(...) */
 
-      if (function_call_param_iterator.next_nf() != NULL) ERROR;
+      if (param_bindings.unbound_values) ERROR;
 
       bool has_output_params = false;
 
@@ -724,7 +641,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, symbol->called_function_declaration);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -776,8 +693,6 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       // NOTE-> We support the non-standard feature of POUS with no in, out and inout parameters, so this is no longer an internal error!
       // if (NULL == parameter_assignment_list) ERROR; 
 
-      function_call_param_iterator_c function_call_param_iterator(symbol);
-
       function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
       if (f_decl == NULL) ERROR;
 
@@ -787,15 +702,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       function_type_prefix = search_base_type_c::get_basetype_decl(f_decl->type_name);
       if (NULL == function_type_prefix) ERROR;
 
-      /* loop through each function parameter, find the value we should pass
-       * to it, and then output the c equivalent...
+      /* loop through each function parameter, get the value we should pass
+       * to it (already resolved by stage 3), and then output the c equivalent...
        */
-      function_param_iterator_c fp_iterator(f_decl);
-      identifier_c *param_name;
-        /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-      bool found_first_extensible_parameter = false;  
-      for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-        if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+      for(unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count) {
           /* We are calling an extensible function. Before passing the extensible
            * parameters, we must add a dummy paramater value to tell the called
            * function how many extensible parameters we will be passing.
@@ -817,56 +730,22 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
           uint_type_name_c *param_type  = new uint_type_name_c();
           identifier_c *param_name = new identifier_c(INLINE_PARAM_COUNT);
           ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-          found_first_extensible_parameter = true;
-        }
-    
-        if (fp_iterator.is_extensible_param()) {      
-          /* since we are handling an extensible parameter, we must add the index to the
-           * parameter name so we can go looking for the value passed to the correct
-           * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
-           */
-          char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
-          int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
-          if ((res >= 32) || (res < 0)) ERROR;
-          param_name = new identifier_c(strdup2(param_name->value, tmp));
-          if (param_name->value == NULL) ERROR;
+          continue;
         }
-        
-        symbol_c *param_type = fp_iterator.param_type();
-        if (param_type == NULL) ERROR;
-
-        function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
 
-        symbol_c *param_value = NULL;
-    
-        /* Get the value from a foo(<param_name> = <param_value>) style call */
-        if (param_value == NULL)
-          param_value = function_call_param_iterator.search_f(param_name);
+        function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+        symbol_c *param_value = binding.param_value;
 
-        /* Get the value from a foo(<param_value>) style call */
-        if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-          param_value = function_call_param_iterator.next_nf();
-        }
-        
-        /* if no more parameter values in function call, and the current parameter
-         * of the function declaration is an extensible parameter, we
-         * have reached the end, and should simply jump out of the for loop.
-         */
-        if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-          break;
-        }
-    
         if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
           /* No value given for parameter, so we must use the default... */
           /* First check whether default value specified in function declaration...*/
-          param_value = fp_iterator.default_value();
+          param_value = binding.default_value;
         }
 
-        ADD_PARAM_LIST(param_name, param_value, param_type, param_direction)
+        ADD_PARAM_LIST(binding.param_name, param_value, binding.param_type, param_direction)
       } /* for(...) */
-      // symbol->parameter_assignment->accept(*this);
 
-      if (function_call_param_iterator.next_nf() != NULL) ERROR;
+      if (param_bindings.unbound_values) ERROR;
 
       bool has_output_params = false;
 
@@ -887,7 +766,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, symbol->called_function_declaration);
 
       CLEAR_PARAM_LIST()
 
@@ -0,0 +1,119 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Layout descriptors of FB and Program data structures, for online change.
+ *
+ *  Replacing the generated code of a running PLC program with a new version
+ *  normally means calling config_init__() again, so every FB and Program
+ *  instance (and every SFC) loses its state.
+ *
+ *  When the 'o' stage4 option is given (-O o), each FB and Program (e.g. FB1)
+ *  whose code is generated also gets:
+ *    - a layout descriptor, const __pou_layout_t FB1_layout__, listing the name,
+ *      datatype, offset and size of each variable of the FB1 data structure
+ *      that holds state between invocations (i.e. the IN, OUT, VAR, EN and ENO
+ *      variables, and the steps and actions of its SFC), and a hash of the
+ *      FB's variables;
+ *    - a state migration function,
+ *        unsigned long FB1_migrate__(FB1 *data__, const void *old_data, const __pou_layout_t *old_layout, BOOL retain);
+ *      which initialises the instance data__ (as FB1_init__() does), and then copies
+ *      each variable from the instance old_data of the previous version of FB1
+ *      (whose layout was old_layout) if that version had a variable with the same
+ *      name and datatype. FB instances are migrated recursively.
+ *  See lib/C/iec_online_change.h for the layout descriptor and the migration itself.
+ *
+ *  VAR_TEMP, VAR_IN_OUT, VAR_EXTERNAL and located variables are not migrated, as they
+ *  are either re-initialised on every invocation, or re-bound by the _init__() function.
+ *  The SFC state is not migrated when the SFC state is packed or the active steps are
+ *  tracked (-O k or -O a), as it is then spread over several tables; the SFC restarts
+ *  from its initial step.
+ *
+ *  The hash is calculated from the list of variables of an instance of the POU, as
+ *  listed in VARIABLES.csv for the debugger (see generate_var_list.cc), so it also
+ *  changes when an FB instance declared in the POU changes. Two versions with the
+ *  same hash (and size) have the same layout, and their variables are copied without
+ *  looking them up by name. The whole data structure is never copied, as it also holds
+ *  the pointers of the VAR_EXTERNAL, VAR_IN_OUT and located variables, which must keep
+ *  pointing to the variables of the new version.
+ *
+ *  The entries of the descriptor are printed by generate_c_vardecl_c (layout_vf) and
+ *  generate_c_sfcdecl_c (layout_sd). generate_c_layout_c calculates the hash, and
+ *  remembers which POUs have a descriptor, as an FB instance of a POU without one
+ *  (e.g. a standard FB) is copied as a whole.
+ */
+
+
+/* A stage4out_c that prints to a string */
+class stage4out_string_c: public stage4out_c {
+  private:
+    std::ostringstream str;
+
+  public:
+    stage4out_string_c(void) {out = &str;}
+    ~stage4out_string_c(void) {}
+
+    std::string get(void) {return str.str();}
+};
+
+
+
+class generate_c_layout_c {
+  private:
+    /* the names of the FBs and Programs that have a layout descriptor */
+    static generate_c_dead_code_c::pou_names_t layout_pous;
+    static symbol_c *tree_root;
+
+  public:
+    /* Determine which FBs and Programs of the library <tree_root> have a layout descriptor,
+     * i.e. those whose code is generated. Must be called before generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root_) {
+      layout_pous.clear();
+      tree_root = tree_root_;
+
+      if (!generate_online_change__) return; /* global variable generate_online_change__ is defined in generate_c.cc */
+      generate_c_dead_code_c::get_generated_pous(tree_root, layout_pous);
+    }
+
+    /* Does the FB or Program named <pou_name> have a layout descriptor? */
+    static bool has_layout(symbol_c *pou_name) {
+      return (layout_pous.find(get_datatype_info_c::get_id_str(pou_name)) != layout_pous.end());
+    }
+
+    /* The hash of the variables of the FB or Program <pou_decl> (32 bit FNV-1a) */
+    static unsigned long get_hash(symbol_c *pou_decl) {
+      stage4out_string_c var_list;
+      generate_var_list_c generate_var_list(&var_list, tree_root);
+      generate_var_list.generate_pou_variables(pou_decl);
+
+      std::string str = var_list.get();
+      unsigned long hash = 2166136261UL;
+      for (unsigned int i = 0; i < str.size(); i++)
+        hash = ((hash ^ (unsigned char)str[i]) * 16777619UL) & 0xFFFFFFFFUL;
+      return hash;
+    }
+}; /* generate_c_layout_c */
+
+
+generate_c_dead_code_c::pou_names_t generate_c_layout_c::layout_pous;
+symbol_c *generate_c_layout_c::tree_root = NULL;
@@ -0,0 +1,184 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Execution time profiling of POUs and program instances.
+ *
+ *  When the 't' stage4 option is given (-O t), the body of each FB and Program
+ *  (e.g. FB1) whose code is generated reads the clock when it starts
+ *  (__PROFILE_BEGIN, after the EN input has been checked) and updates the
+ *  profiling table entry of the POU, __profile_entry_t FB1_profile__, when it
+ *  finishes (__PROFILE_END(FB1_profile__)). The specialised bodies of an FB
+ *  (see generate_c_fb_specialization.cc) update the same entry.
+ *
+ *  Functions are usually small and called very often, so that measuring them
+ *  could cost more than the Function itself, and would inflate the time measured
+ *  for the FBs and Programs calling them. They are therefore only measured (in
+ *  the same way) when the 'f' stage4 option is given (-O f, which implies -O t).
+ *
+ *  The invocations of each program instance (e.g. instance INST1 of resource RES1)
+ *  are measured in the same way by the resource's run function, which updates the
+ *  entry RES1__INST1_profile__, declared in the resource's C file.
+ *
+ *  The configuration's C file gets a table pointing to all these entries, and the
+ *  config_profile_snapshot__() and config_profile_reset__() functions to read
+ *  and clear it. See lib/C/iec_profile.h for the entries and the clock used.
+ *
+ *  The entries of the POUs are defined next to their bodies; generate_c_profile_config_c
+ *  lists them, together with the entries of the program instances, in the table of
+ *  the configuration.
+ */
+
+
+class generate_c_profile_c {
+  private:
+    /* the names of the POUs that have a profiling table entry */
+    static generate_c_dead_code_c::pou_names_t profiled_pous;
+
+  public:
+    /* Determine which POUs of the library <tree_root> have a profiling table entry, i.e. the FBs
+     * and Programs (and, with -O f, the Functions) whose code is generated. Must be called before
+     * generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root) {
+      profiled_pous.clear();
+
+      if (!generate_profiling__) return; /* global variable generate_profiling__ is defined in generate_c.cc */
+      /* Functions are only measured with -O f (global variable generate_function_profiling__ is defined in generate_c.cc) */
+      generate_c_dead_code_c::get_generated_pous(tree_root, profiled_pous, generate_function_profiling__);
+    }
+
+    /* Does the POU named <pou_name> have a profiling table entry? */
+    static bool is_profiled(symbol_c *pou_name) {
+      return (profiled_pous.find(get_datatype_info_c::get_id_str(pou_name)) != profiled_pous.end());
+    }
+
+    /* Print the profiling table entries of all POUs, as a list of pointers */
+    static void print_pou_entries(stage4out_c &s4o) {
+      generate_c_dead_code_c::pou_names_t::const_iterator it;
+      for (it = profiled_pous.begin(); it != profiled_pous.end(); it++) {
+        s4o.print(s4o.indent_spaces + "&");
+        s4o.printupper(*it);
+        s4o.print(FB_PROFILE_SUFFIX ",\n");
+      }
+    }
+}; /* generate_c_profile_c */
+
+
+generate_c_dead_code_c::pou_names_t generate_c_profile_c::profiled_pous;
+
+
+
+
+/* generate the profiling table of a CONFIGURATION, and the functions to read and reset it */
+class generate_c_profile_config_c: public generate_c_base_and_typeid_c {
+  private:
+    typedef enum {
+      declare_pt, /* declare the profiling table entries of the program instances */
+      table_pt    /* list them in the profiling table */
+    } printtype_t;
+
+    printtype_t wanted_printtype;
+    symbol_c   *current_resource_name;
+
+  public:
+    generate_c_profile_config_c(stage4out_c *s4o_ptr)
+      : generate_c_base_and_typeid_c(s4o_ptr) {
+      current_resource_name = NULL;
+    };
+
+    virtual ~generate_c_profile_config_c(void) {}
+
+
+  public:
+    /********************/
+    /* 2.1.6 - Pragmas  */
+    /********************/
+    void *visit(enable_code_generation_pragma_c * symbol)   {s4o.enable_output(); return NULL;}
+    void *visit(disable_code_generation_pragma_c * symbol)  {s4o.disable_output();return NULL;}
+
+
+    /********************************/
+    /* B 1.7 Configuration elements */
+    /********************************/
+    /*
+    SYM_REF6(configuration_declaration_c, configuration_name, global_var_declarations, resource_declarations, access_declarations, instance_specific_initializations, unused)
+    */
+    void *visit(configuration_declaration_c *symbol) {
+      s4o.print("\n\n\n");
+      s4o.print("// Profiling table\n");
+      wanted_printtype = declare_pt;
+      symbol->resource_declarations->accept(*this);
+
+      s4o.print("static __profile_entry_t *const __profile_table[] = {\n");
+      s4o.indent_right();
+      generate_c_profile_c::print_pou_entries(s4o);
+      wanted_printtype = table_pt;
+      symbol->resource_declarations->accept(*this);
+      s4o.print(s4o.indent_spaces + "NULL\n");
+      s4o.indent_left();
+      s4o.print("};\n");
+      s4o.print("#define __PROFILE_TABLE_SIZE (sizeof(__profile_table) / sizeof(__profile_table[0]) - 1)\n\n");
+
+      s4o.print("unsigned long config_profile_snapshot__(__profile_entry_t *snapshot, unsigned long size) {\n");
+      s4o.print("  return __profile_snapshot(__profile_table, __PROFILE_TABLE_SIZE, snapshot, size);\n");
+      s4o.print("}\n");
+      s4o.print("void config_profile_reset__(void) {\n");
+      s4o.print("  __profile_reset(__profile_table, __PROFILE_TABLE_SIZE);\n");
+      s4o.print("}\n");
+      return NULL;
+    }
+
+    void *visit(resource_declaration_c *symbol) {
+      current_resource_name = symbol->resource_name;
+      symbol->resource_declaration->accept(*this);
+      current_resource_name = NULL;
+      return NULL;
+    }
+
+    void *visit(single_resource_declaration_c *symbol) {
+      bool single_resource = (NULL == current_resource_name);
+      if (single_resource)
+        current_resource_name = new identifier_c("RESOURCE");
+      symbol->program_configuration_list->accept(*this);
+      if (single_resource) {
+        delete current_resource_name;
+        current_resource_name = NULL;
+      }
+      return NULL;
+    }
+
+    /*  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] */
+    //SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
+    void *visit(program_configuration_c *symbol) {
+      s4o.print(s4o.indent_spaces);
+      if (declare_pt == wanted_printtype) s4o.print("extern __profile_entry_t ");
+      else                                s4o.print("&");
+      current_resource_name->accept(*this);
+      s4o.print("__");
+      symbol->program_name->accept(*this);
+      s4o.print(FB_PROFILE_SUFFIX);
+      if (declare_pt == wanted_printtype) s4o.print(";\n");
+      else                                s4o.print(",\n");
+      return NULL;
+    }
+}; /* generate_c_profile_config_c */
@@ -0,0 +1,194 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Register promotion of FB and Program variables.
+ *
+ *  Inside the body of a FB or Program every variable access goes through the
+ *  __GET_VAR()/__SET_VAR() accessor macros, i.e. it reads and writes the
+ *  instance data structure (data__->XXX.value), and each write must also test
+ *  the __IEC_FORCE_FLAG. Since the C compiler must assume that any of these
+ *  accesses may alias with any other pointer access, it is not able to keep
+ *  these variables in CPU registers.
+ *
+ *  When the 'r' stage4 option is given (-O r), the VAR and VAR_TEMP variables
+ *  of the POU that may be safely promoted are copied into C local variables
+ *  at the start of the POU body, and copied back (with __SET_VAR(), so the
+ *  force flag is still honoured) at the end of the POU body (after the __end
+ *  label, so also on RETURN).
+ *
+ *  A variable is promoted only if:
+ *    - it is declared in a VAR or VAR_TEMP (i.e. not an input, output,
+ *      in_out, external, global or located variable);
+ *    - it is of an elementary datatype, other than a STRING/WSTRING;
+ *    - its address is never taken, i.e. it is never used in a REF()
+ *      operation, and is never passed to an OUT or IN_OUT parameter
+ *      of a Function, nor to an IN_OUT parameter of a FB;
+ *    - the body of the POU is written in ST or IL (SFC actions and
+ *      transitions are generated as separate code blocks, so promotion
+ *      would not be safe there).
+ *
+ *  NOTE: Forcing a promoted variable still works, although with a coarser
+ *        granularity. The debugger stores the forced value in the instance
+ *        data structure, so it is loaded into the C local variable at every
+ *        invocation of the POU, and since the copy back uses __SET_VAR(), any
+ *        value written to a forced variable is discarded when the POU returns.
+ *        However, within a single invocation the POU body sees the values it
+ *        writes to the forced variable, whereas without promotion it would
+ *        keep reading the forced value.
+ */
+
+
+#include <set>
+
+
+/* The variables promoted to C local variables: maps the variable name to its declared datatype. */
+typedef std::map<std::string, symbol_c *, nocasecmp_c> promoted_vars_t;
+
+
+
+class generate_c_promoted_vars_c: public iterator_visitor_c {
+  private:
+    search_var_instance_decl_c search_var_instance_decl;
+    promoted_vars_t &promoted_vars;
+    std::set<std::string, nocasecmp_c> excluded_vars;
+
+    generate_c_promoted_vars_c(symbol_c *scope, promoted_vars_t &promoted_vars_)
+      : search_var_instance_decl(scope), promoted_vars(promoted_vars_) {}
+    ~generate_c_promoted_vars_c(void) {}
+
+  public:
+    /* Determine which variables of the POU <scope>, whose body is <body>, may be promoted to C local variables. */
+    static void get(symbol_c *scope, symbol_c *body, promoted_vars_t &promoted_vars) {
+      promoted_vars.clear();
+      if (!generate_register_promotion__) return; /* global variable generate_register_promotion__ is defined in generate_c.cc */
+      if ((NULL == dynamic_cast<statement_list_c *>(body)) && (NULL == dynamic_cast<instruction_list_c *>(body))) return;
+
+      generate_c_promoted_vars_c search(scope, promoted_vars);
+      body->accept(search);
+      std::set<std::string, nocasecmp_c>::iterator it;
+      for (it = search.excluded_vars.begin(); it != search.excluded_vars.end(); it++)
+        promoted_vars.erase(*it);
+    }
+
+  private:
+    /* Do not promote <variable>, if it is a symbolic variable. */
+    void exclude(symbol_c *variable) {
+      symbolic_variable_c *symbolic_variable = dynamic_cast<symbolic_variable_c *>(variable);
+      if (NULL == symbolic_variable) return;
+      token_c *var_name = dynamic_cast<token_c *>(symbolic_variable->var_name);
+      if (NULL == var_name) ERROR;
+      excluded_vars.insert(var_name->value);
+    }
+
+    /* Do not promote the variables passed by reference in the invocation <f_call> of the POU <pou_decl>. */
+    void exclude_by_ref_params(symbol_c *f_call, symbol_c *pou_decl) {
+      /* NOTE: the called POU may not have been determined if the code contains errors. */
+      if (NULL == pou_decl) return;
+      bool is_function = (NULL != dynamic_cast<function_declaration_c *>(pou_decl));
+
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(f_call, pou_decl);
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (binding.extensible_count || (NULL == binding.param_value))  continue;
+        if (   (binding.param_direction == function_param_iterator_c::direction_inout)
+            || (is_function && (binding.param_direction == function_param_iterator_c::direction_out)))
+          exclude(binding.param_value);
+      }
+    }
+
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    void *visit(symbolic_variable_c *symbol) {
+      search_var_instance_decl_c::vt_t vartype = search_var_instance_decl.get_vartype(symbol);
+      if ((vartype != search_var_instance_decl_c::private_vt) && (vartype != search_var_instance_decl_c::temp_vt))
+        return NULL;
+
+      /* we need the name of the datatype to declare the C local variable */
+      symbol_c *type_decl = NULL;
+      simple_spec_init_c *spec_init = dynamic_cast<simple_spec_init_c *>(search_var_instance_decl.get_decl(symbol));
+      if (NULL != spec_init) type_decl = spec_init->simple_specification;
+
+      if (   !get_datatype_info_c::is_ANY_ELEMENTARY_compatible(symbol->datatype)
+          ||  get_datatype_info_c::is_ANY_STRING_compatible    (symbol->datatype)
+          || (NULL == type_decl)
+          || (   (NULL == dynamic_cast<identifier_c *>(type_decl))
+              && !get_datatype_info_c::is_ANY_ELEMENTARY_compatible(type_decl))) {
+        exclude(symbol);
+        return NULL;
+      }
+
+      token_c *var_name = dynamic_cast<token_c *>(symbol->var_name);
+      if (NULL == var_name) ERROR;
+      promoted_vars[var_name->value] = type_decl;
+      return NULL;
+    }
+
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(ref_expression_c *symbol) {
+      exclude(symbol->exp);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(function_invocation_c *symbol) {
+      exclude_by_ref_params(symbol, symbol->called_function_declaration);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(fb_invocation_c *symbol) {
+      exclude_by_ref_params(symbol, symbol->called_fb_declaration);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+
+    /****************************************/
+    /* B.2 - Language IL (Instruction List) */
+    /****************************************/
+    /***********************************/
+    /* B 2.1 Instructions and Operands */
+    /***********************************/
+    void *visit(il_function_call_c *symbol) {
+      exclude_by_ref_params(symbol, symbol->called_function_declaration);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(il_fb_call_c *symbol) {
+      exclude_by_ref_params(symbol, symbol->called_fb_declaration);
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    void *visit(il_formal_funct_call_c *symbol) {
+      exclude_by_ref_params(symbol, symbol->called_function_declaration);
+      return iterator_visitor_c::visit(symbol);
+    }
+}; /* generate_c_promoted_vars_c */
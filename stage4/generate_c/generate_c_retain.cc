@@ -0,0 +1,73 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Persistence of the RETAIN variables of program instances.
+ *
+ *  When the 'b' stage4 option is given (-O b), each FB and Program (e.g. FB1)
+ *  whose code is generated also gets a function
+ *    void FB1_retain__(FB1 *data__, __retain_image_t *image, BOOL backup, BOOL retain);
+ *  which copies the RETAIN variables of the instance data__ to (if backup is TRUE) or
+ *  from the retain image (see lib/C/iec_retain.h).
+ *
+ *  Which variables are RETAIN is decided in the same way as by FB1_init__(), which
+ *  sets their __IEC_RETAIN_FLAG: a variable declared in a RETAIN (or NON_RETAIN) block
+ *  always is (or is not), and any other variable is RETAIN if the instance itself is,
+ *  i.e. if the retain parameter is TRUE. FB instances are copied recursively, passing
+ *  on the same retain parameter as FB1_init__() does; instances of a FB without a
+ *  retain function (e.g. a standard FB) are copied as a whole.
+ *  The resource's retain backup/restore functions call the retain function of each
+ *  program instance, with retain TRUE for a PROGRAM RETAIN instance.
+ *
+ *  Only the IN, OUT and VAR variables are copied, as VAR_TEMP variables are
+ *  re-initialised on every invocation, and VAR_IN_OUT, VAR_EXTERNAL and located
+ *  variables are only pointers to variables declared elsewhere.
+ *
+ *  The copying itself is printed by generate_c_vardecl_c (retain_vf), while
+ *  generate_c_retain_c only remembers which POUs have a retain function.
+ */
+
+
+class generate_c_retain_c {
+  private:
+    /* the names of the FBs and Programs that have a retain function */
+    static generate_c_dead_code_c::pou_names_t retain_pous;
+
+  public:
+    /* Determine which FBs and Programs of the library <tree_root> have a retain function,
+     * i.e. those whose code is generated. Must be called before generating any code for the library.
+     */
+    static void analyse(symbol_c *tree_root) {
+      retain_pous.clear();
+
+      if (!generate_plc_state_backup_fuctions__) return; /* global variable generate_plc_state_backup_fuctions__ is defined in generate_c.cc */
+      generate_c_dead_code_c::get_generated_pous(tree_root, retain_pous);
+    }
+
+    /* Does the FB or Program named <pou_name> have a retain function? */
+    static bool has_retain(symbol_c *pou_name) {
+      return (retain_pous.find(get_datatype_info_c::get_id_str(pou_name)) != retain_pous.end());
+    }
+}; /* generate_c_retain_c */
+
+
+generate_c_dead_code_c::pou_names_t generate_c_retain_c::retain_pous;
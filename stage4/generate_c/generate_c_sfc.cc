@@ -55,6 +55,13 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     
     int transition_number;
     std::list<TRANSITION> transition_list;
+    std::list<symbol_c *> step_list;
+    /* when not NULL, transitiontest_sg only generates the transitions leaving this step */
+    symbol_c *transition_step;
+    /* the SFC being generated */
+    sequential_function_chart_c *sfc;
+    /* the word of __step_bits whose action associations are being generated (packed SFC state) */
+    int association_word;
     
     symbol_c *current_step;
     symbol_c *current_action;
@@ -69,10 +76,14 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       generate_c_code = new generate_c_SFC_IL_ST_c(s4o_ptr, name, scope, variable_prefix);
       search_var_instance_decl = new search_var_instance_decl_c(scope);
       this->set_variable_prefix(variable_prefix);
+      transition_step = NULL;
+      sfc = NULL;
+      association_word = -1;
     }
     
     ~generate_c_sfc_elements_c(void) {
       transition_list.clear();
+      step_list.clear();
       delete generate_c_il;
       delete generate_c_st;
       delete generate_c_code;
@@ -89,11 +100,54 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
 
     void reset_transition_number(void) {transition_number = 0;}
 
+    void set_sfc(sequential_function_chart_c *symbol) {sfc = symbol;}
+
     void generate(symbol_c *symbol, sfcgeneration_t generation_type) {
       wanted_sfcgeneration = generation_type;
       switch (wanted_sfcgeneration) {
         case transitiontest_sg:
-          {
+          if (generate_sfc_active_steps__ && transitions_grouped_by_step()) {
+            /* only test the transitions leaving the active steps, grouped by the first step they leave */
+            s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+            print_variable_prefix();
+            s4o.print("__nb_active_steps; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces + "switch (");
+            print_variable_prefix();
+            s4o.print("__active_steps[i]) {\n");
+            s4o.indent_right();
+            std::list<symbol_c *>::iterator st;
+            for(st = step_list.begin(); st != step_list.end(); st++) {
+              bool found = false;
+              std::list<TRANSITION>::iterator pt;
+              for(pt = transition_list.begin(); pt != transition_list.end(); pt++) {
+                if (compare_identifiers(first_from_step(pt->symbol), *st) != 0) continue;
+                if (!found) {
+                  s4o.print(s4o.indent_spaces + "case ");
+                  s4o.print(SFC_STEP_ACTION_PREFIX);
+                  (*st)->accept(*this);
+                  s4o.print(":\n");
+                  s4o.indent_right();
+                  found = true;
+                }
+                transition_number = pt->index;
+                transition_step = *st;
+                pt->symbol->accept(*this);
+                transition_step = NULL;
+              }
+              if (found) {
+                s4o.print(s4o.indent_spaces + "break;\n");
+                s4o.indent_left();
+              }
+            }
+            s4o.print(s4o.indent_spaces + "default:\n");
+            s4o.print(s4o.indent_spaces + "  break;\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
+          else {
             std::list<TRANSITION>::iterator pt;
             for(pt = transition_list.begin(); pt != transition_list.end(); pt++) {
               transition_number = pt->index;
@@ -129,12 +183,176 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       s4o.print(transition_number);
     }
 
+    /* the value of the current transition */
+    void print_get_transition(void) {
+      if (generate_sfc_packed_state__) { /* global variable generate_sfc_packed_state__ is defined in generate_c.cc */
+        s4o.print("__GET_SFC_BIT(");
+        print_variable_prefix();
+        s4o.print("__transition_bits, ");
+        print_transition_number();
+        s4o.print(")");
+        return;
+      }
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__transition_list[");
+      print_transition_number();
+      s4o.print("])");
+    }
+
+    /* set the value of the current transition (or its debug value) to the expression printed next */
+    void print_set_transition(void) {
+      if (generate_sfc_packed_state__ && (wanted_sfcgeneration != transitiontestdebug_sg)) {
+        s4o.print("__SET_SFC_BIT(");
+        print_variable_prefix();
+        s4o.print("__transition_bits, ");
+        print_transition_number();
+        s4o.print(", ");
+        return;
+      }
+      s4o.print(SET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print(",");
+      if (wanted_sfcgeneration == transitiontestdebug_sg)
+        s4o.print("__debug_");
+      else
+        s4o.print("__");
+      s4o.print("transition_list[");
+      print_transition_number();
+      s4o.print("],,");
+    }
+
+    /* the state of step <step_name> */
+    void print_get_step(symbol_c *step_name) {
+      if (generate_sfc_packed_state__) {
+        s4o.print("__GET_SFC_BIT(");
+        print_variable_prefix();
+        s4o.print("__step_bits, ");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        step_name->accept(*this);
+        s4o.print(")");
+        return;
+      }
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_step_argument(step_name, "X");
+      s4o.print(")");
+    }
+
+    /* The step a transition is tested for, when only testing the transitions leaving active steps. */
+    symbol_c *first_from_step(transition_c *transition) {
+      steps_c *steps = dynamic_cast<steps_c *>(transition->from_steps);
+      if (NULL == steps) ERROR;
+      if (NULL != steps->step_name) return steps->step_name;
+      return ((list_c *)steps->step_name_list)->get_element(0);
+    }
+
+    bool leaves_step(transition_c *transition, symbol_c *step_name) {
+      steps_c *steps = dynamic_cast<steps_c *>(transition->from_steps);
+      if (NULL == steps) ERROR;
+      if (NULL != steps->step_name) return compare_identifiers(steps->step_name, step_name) == 0;
+      list_c *step_name_list = (list_c *)steps->step_name_list;
+      for(int i = 0; i < step_name_list->n; i++)
+        if (compare_identifiers(step_name_list->get_element(i), step_name) == 0) return true;
+      return false;
+    }
+
+    /* Testing the transitions grouped by the first step they leave changes the order in which they
+     * are tested. This only matters for a transition with an explicit priority, which immediately
+     * resets the steps it leaves, and thus disables the transitions tested after it that leave
+     * any of the same steps. We therefore only group the transitions when no transition with an
+     * explicit priority shares a step with a transition placed in another group.
+     */
+    bool transitions_grouped_by_step(void) {
+      std::list<TRANSITION>::iterator pt1, pt2;
+      for(pt1 = transition_list.begin(); pt1 != transition_list.end(); pt1++) {
+        if (pt1->symbol->integer == NULL) continue;
+        symbol_c *group = first_from_step(pt1->symbol);
+        steps_c *steps = (steps_c *)pt1->symbol->from_steps;
+        for(pt2 = transition_list.begin(); pt2 != transition_list.end(); pt2++) {
+          if (compare_identifiers(first_from_step(pt2->symbol), group) == 0) continue;
+          if (NULL != steps->step_name) {
+            if (leaves_step(pt2->symbol, steps->step_name)) return false;
+          } else {
+            list_c *step_name_list = (list_c *)steps->step_name_list;
+            for(int i = 0; i < step_name_list->n; i++)
+              if (leaves_step(pt2->symbol, step_name_list->get_element(i))) return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    /* remember the step changed state in this cycle, so its prev_state is updated in the next one */
+    void print_step_changed(symbol_c *step_name) {
+      s4o.print(s4o.indent_spaces + "if (!");
+      print_variable_prefix();
+      s4o.print("__step_changed[");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print("]) {");
+      print_variable_prefix();
+      s4o.print("__step_changed[");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print("] = 1; ");
+      print_variable_prefix();
+      s4o.print("__changed_steps[");
+      print_variable_prefix();
+      s4o.print("__nb_changed_steps++] = ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print(";}\n");
+    }
+
+    /* add the action to the list of actions to evaluate in this cycle */
+    void print_action_pending(symbol_c *action_name) {
+      s4o.print(s4o.indent_spaces + "if (!");
+      print_variable_prefix();
+      s4o.print("__action_pending[");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      action_name->accept(*this);
+      s4o.print("]) {");
+      print_variable_prefix();
+      s4o.print("__action_pending[");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      action_name->accept(*this);
+      s4o.print("] = 1; ");
+      print_variable_prefix();
+      s4o.print("__pending_actions[");
+      print_variable_prefix();
+      s4o.print("__nb_pending_actions++] = ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      action_name->accept(*this);
+      s4o.print(";}\n");
+    }
+
     void print_reset_step(symbol_c *step_name) {
       s4o.print(s4o.indent_spaces);
       s4o.print(SET_VAR);
       s4o.print("(");
       print_step_argument(step_name, "X", true);
       s4o.print(",,0);\n");
+      if (generate_sfc_active_steps__)
+        print_step_changed(step_name);
+      if (generate_sfc_packed_state__)
+        print_set_step_bit(step_name);
+    }
+
+    /* copy the state of step <step_name> into its bit (packed SFC state) */
+    void print_set_step_bit(symbol_c *step_name) {
+      s4o.print(s4o.indent_spaces + "__SET_SFC_BIT(");
+      print_variable_prefix();
+      s4o.print("__step_bits, ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print(", ");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_step_argument(step_name, "X");
+      s4o.print("));\n");
     }
     
     void print_set_step(symbol_c *step_name) {
@@ -142,9 +360,114 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       s4o.print(SET_VAR);
       s4o.print("(");
       print_step_argument(step_name, "X", true);
-      s4o.print(",,1);\n" + s4o.indent_spaces);
-      print_step_argument(step_name, "T.value");
-      s4o.print(" = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print(",,1);\n");
+      if (!generate_sfc_packed_state__ || generate_c_sfc_timed_steps_c::is_timed(sfc, step_name)) {
+        s4o.print(s4o.indent_spaces);
+        print_step_argument(step_name, "T.value");
+        s4o.print(" = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      }
+      if (generate_sfc_active_steps__)
+        print_step_changed(step_name);
+      if (generate_sfc_packed_state__)
+        print_set_step_bit(step_name);
+    }
+
+    /* close the block opened for the last word of __step_bits by print_action_associations() */
+    void end_action_associations(void) {
+      if (association_word < 0)
+        return;
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      association_word = -1;
+    }
+
+    /* With the packed SFC state, the steps are handled 32 at a time, skipping all the
+     * steps in a word of __step_bits that are neither active nor were active in the
+     * previous cycle.
+     */
+    void print_packed_action_associations(symbol_c *step_name, symbol_c *action_association_list) {
+      int index = 0;
+      std::list<symbol_c *>::iterator st;
+      for(st = step_list.begin(); st != step_list.end(); st++, index++)
+        if (compare_identifiers(*st, step_name) == 0) break;
+      if (st == step_list.end()) ERROR;
+
+      if (index / 32 != association_word) {
+        end_action_associations();
+        association_word = index / 32;
+        s4o.print(s4o.indent_spaces + "active_steps = ");
+        print_variable_prefix();
+        s4o.print("__step_bits[");
+        s4o.print(association_word);
+        s4o.print("];\n");
+        s4o.print(s4o.indent_spaces + "prev_steps = ");
+        print_variable_prefix();
+        s4o.print("__prev_step_bits[");
+        s4o.print(association_word);
+        s4o.print("];\n");
+        s4o.print(s4o.indent_spaces + "if (active_steps | prev_steps) {\n");
+        s4o.indent_right();
+      }
+      s4o.print(s4o.indent_spaces + "// ");
+      step_name->accept(*this);
+      s4o.print(" action associations\n");
+      current_step = step_name;
+      s4o.print(s4o.indent_spaces + "if (((active_steps | prev_steps) >> ");
+      s4o.print(index % 32);
+      s4o.print(") & 1) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "char active = (active_steps >> ");
+      s4o.print(index % 32);
+      s4o.print(") & 1;\n");
+      s4o.print(s4o.indent_spaces + "char activated = active && !((prev_steps >> ");
+      s4o.print(index % 32);
+      s4o.print(") & 1);\n");
+      s4o.print(s4o.indent_spaces + "char desactivated = !active && ((prev_steps >> ");
+      s4o.print(index % 32);
+      s4o.print(") & 1);\n\n");
+      action_association_list->accept(*this);
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+    }
+
+    void print_action_associations(symbol_c *step_name, symbol_c *action_association_list) {
+      if (((list_c*)action_association_list)->n == 0)
+        return;
+      if (generate_sfc_packed_state__) {
+        print_packed_action_associations(step_name, action_association_list);
+        return;
+      }
+      s4o.print(s4o.indent_spaces + "// ");
+      step_name->accept(*this);
+      s4o.print(" action associations\n");
+      current_step = step_name;
+      s4o.print(s4o.indent_spaces);
+      if (generate_sfc_active_steps__) {
+        /* generate_c_sfc_c only evaluates the associations of the active and changed steps */
+        s4o.print("case ");
+        s4o.print(SFC_STEP_ACTION_PREFIX);
+        step_name->accept(*this);
+        s4o.print(": ");
+      }
+      s4o.print("{\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "char active = ");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_step_argument(current_step, "X");
+      s4o.print(");\n");
+      s4o.print(s4o.indent_spaces + "char activated = active && !");
+      print_step_argument(current_step, "prev_state");
+      s4o.print(";\n");
+      s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
+      print_step_argument(current_step, "prev_state");
+      s4o.print(";\n\n");
+      action_association_list->accept(*this);
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      if (generate_sfc_active_steps__)
+        s4o.print(s4o.indent_spaces + "break;\n");
+      s4o.print("\n");
     }
     
 /*********************************************/
@@ -153,29 +476,11 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     
     void *visit(initial_step_c *symbol) {
       switch (wanted_sfcgeneration) {
+        case transitionlist_sg:
+          step_list.push_back(symbol->step_name);
+          break;
         case actionassociation_sg:
-          if (((list_c*)symbol->action_association_list)->n > 0) {
-            s4o.print(s4o.indent_spaces + "// ");
-            symbol->step_name->accept(*this);
-            s4o.print(" action associations\n");
-            current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
-            s4o.indent_right();
-            s4o.print(s4o.indent_spaces + "char active = ");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(current_step, "X");
-            s4o.print(");\n");
-            s4o.print(s4o.indent_spaces + "char activated = active && !");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n");
-            s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n\n");
-            symbol->action_association_list->accept(*this);
-            s4o.indent_left();
-            s4o.print(s4o.indent_spaces + "}\n\n");
-          }
+          print_action_associations(symbol->step_name, symbol->action_association_list);
           break;
         default:
           break;
@@ -185,29 +490,11 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     
     void *visit(step_c *symbol) {
       switch (wanted_sfcgeneration) {
+        case transitionlist_sg:
+          step_list.push_back(symbol->step_name);
+          break;
         case actionassociation_sg:
-          if (((list_c*)symbol->action_association_list)->n > 0) {
-            s4o.print(s4o.indent_spaces + "// ");
-            symbol->step_name->accept(*this);
-            s4o.print(" action associations\n");
-            current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
-            s4o.indent_right();
-            s4o.print(s4o.indent_spaces + "char active = ");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(current_step, "X");
-            s4o.print(");\n");
-            s4o.print(s4o.indent_spaces + "char activated = active && !");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n");
-            s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n\n");
-            symbol->action_association_list->accept(*this);
-            s4o.indent_left();
-            s4o.print(s4o.indent_spaces + "}\n\n");
-          }
+          print_action_associations(symbol->step_name, symbol->action_association_list);
           break;
         default:
           break;
@@ -247,23 +534,35 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
           // Calculate transition value
           symbol->transition_condition->accept(*this);
           
-          if (symbol->integer != NULL) {
+          if ((symbol->integer != NULL) || generate_sfc_active_steps__) {
             s4o.print(s4o.indent_spaces + "if (");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_variable_prefix();
-            s4o.print("__transition_list[");
-            print_transition_number();
-            s4o.print("])) {\n");
+            print_get_transition();
+            s4o.print(") {\n");
             s4o.indent_right();
-            wanted_sfcgeneration = stepreset_sg;
-            symbol->from_steps->accept(*this);
-            wanted_sfcgeneration = transitiontest_sg;
+            if (generate_sfc_active_steps__) {
+              s4o.print(s4o.indent_spaces);
+              print_variable_prefix();
+              s4o.print("__fired_transitions[");
+              print_variable_prefix();
+              s4o.print("__nb_fired_transitions++] = ");
+              print_transition_number();
+              s4o.print(";\n");
+            }
+            if (symbol->integer != NULL) {
+              wanted_sfcgeneration = stepreset_sg;
+              symbol->from_steps->accept(*this);
+              wanted_sfcgeneration = transitiontest_sg;
+            }
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n");
           }
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
+          /* transitions leaving inactive steps are not tested at all when grouped by step,
+           * and are reset when they are no longer in the __fired_transitions list.
+           */
+          if (transition_step != NULL)
+            break;
           s4o.print(s4o.indent_spaces + "else {\n");
           s4o.indent_right();
           // Calculate transition value for debug
@@ -274,24 +573,35 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
           wanted_sfcgeneration = transitiontest_sg;
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
-          s4o.print(s4o.indent_spaces);
-          s4o.print(SET_VAR);
-          s4o.print("(");
-          print_variable_prefix();
-          s4o.print(",__transition_list[");
-          print_transition_number();
-          s4o.print("],,0);\n");
+          /* packed transition bits are cleared at the start of each cycle */
+          if (!generate_sfc_packed_state__) {
+            s4o.print(s4o.indent_spaces);
+            s4o.print(SET_VAR);
+            s4o.print("(");
+            print_variable_prefix();
+            s4o.print(",__transition_list[");
+            print_transition_number();
+            s4o.print("],,0);\n");
+          }
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
           break;
         case stepset_sg:
+          if (generate_sfc_active_steps__) {
+            /* generate_c_sfc_c only sets the steps of the fired transitions */
+            s4o.print(s4o.indent_spaces + "case ");
+            print_transition_number();
+            s4o.print(":\n");
+            s4o.indent_right();
+            symbol->to_steps->accept(*this);
+            s4o.print(s4o.indent_spaces + "break;\n");
+            s4o.indent_left();
+            transition_number++;
+            break;
+          }
           s4o.print(s4o.indent_spaces + "if (");
-          s4o.print(GET_VAR);
-          s4o.print("(");
-          print_variable_prefix();
-          s4o.print("__transition_list[");
-          print_transition_number();
-          s4o.print("])) {\n");
+          print_get_transition();
+          s4o.print(") {\n");
           s4o.indent_right();
           symbol->to_steps->accept(*this);
           s4o.indent_left();
@@ -299,14 +609,20 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
           transition_number++;
           break;
         case stepreset_sg:
-          if (symbol->integer == NULL) {
-            s4o.print(s4o.indent_spaces + "if (");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_variable_prefix();
-            s4o.print("__transition_list[");
+          if ((symbol->integer == NULL) && generate_sfc_active_steps__) {
+            /* generate_c_sfc_c only resets the steps of the fired transitions */
+            s4o.print(s4o.indent_spaces + "case ");
             print_transition_number();
-            s4o.print("])) {\n");
+            s4o.print(":\n");
+            s4o.indent_right();
+            symbol->from_steps->accept(*this);
+            s4o.print(s4o.indent_spaces + "break;\n");
+            s4o.indent_left();
+          }
+          else if (symbol->integer == NULL) {
+            s4o.print(s4o.indent_spaces + "if (");
+            print_get_transition();
+            s4o.print(") {\n");
             s4o.indent_right();
             symbol->from_steps->accept(*this);
             s4o.indent_left();
@@ -326,38 +642,18 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
         case transitiontestdebug_sg:
           // Transition condition is in IL
           if (symbol->transition_condition_il != NULL) {
-            generate_c_il->declare_implicit_variable_back();
+            generate_c_il->declare_implicit_variable_back(symbol);
             s4o.print(s4o.indent_spaces);
             symbol->transition_condition_il->accept(*generate_c_il);
-            s4o.print(SET_VAR);
-            s4o.print("(");
-            print_variable_prefix();
-            s4o.print(",");
-            if (wanted_sfcgeneration == transitiontestdebug_sg)
-              s4o.print("__debug_");
-            else
-              s4o.print("__");
-            s4o.print("transition_list[");
-            print_transition_number();
-            s4o.print("],,");
-            generate_c_il->print_implicit_variable_back();
+            print_set_transition();
+            generate_c_il->print_implicit_variable_back(symbol->transition_condition_il);
             // generate_c_il->reset_default_variable_name(); // generate_c_il does not require his anymore
             s4o.print(");\n");
           }
           // Transition condition is in ST
           if (symbol->transition_condition_st != NULL) {
             s4o.print(s4o.indent_spaces);
-            s4o.print(SET_VAR);
-            s4o.print("(");
-            print_variable_prefix();
-            s4o.print(",");
-            if (wanted_sfcgeneration == transitiontestdebug_sg)
-              s4o.print("__debug_");
-            else
-              s4o.print("__");
-            s4o.print("transition_list[");
-            print_transition_number();
-            s4o.print("],,");
+            print_set_transition();
             symbol->transition_condition_st->accept(*generate_c_st);
             s4o.print(");\n");
           }
@@ -371,12 +667,22 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             s4o.print(",__debug_transition_list[");
             print_transition_number();
             s4o.print("],,");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_variable_prefix();
-            s4o.print("__transition_list[");
-            print_transition_number();
-            s4o.print("]));\n");
+            print_get_transition();
+            s4o.print(");\n");
+            if (generate_sfc_packed_state__) {
+              /* a transition forced with the debugger keeps its forced value */
+              s4o.print(s4o.indent_spaces + "__SET_SFC_BIT(");
+              print_variable_prefix();
+              s4o.print("__transition_bits, ");
+              print_transition_number();
+              s4o.print(", ");
+              s4o.print(GET_VAR);
+              s4o.print("(");
+              print_variable_prefix();
+              s4o.print("__debug_transition_list[");
+              print_transition_number();
+              s4o.print("]));\n");
+            }
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n");
           }
@@ -416,10 +722,7 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       if (symbol->step_name != NULL) {
         switch (wanted_sfcgeneration) {
           case transitiontest_sg:
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(symbol->step_name, "X");
-            s4o.print(")");
+            print_get_step(symbol->step_name);
             break;
           case stepset_sg:
             print_set_step(symbol->step_name);
@@ -441,10 +744,7 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       switch (wanted_sfcgeneration) {
         case transitiontest_sg:
           for(int i = 0; i < symbol->n; i++) {
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(symbol->get_element(i), "X");
-            s4o.print(")");
+            print_get_step(symbol->get_element(i));
             if (i < symbol->n - 1) {
               s4o.print(" && ");
             }
@@ -480,6 +780,8 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     void *visit(action_association_c *symbol) {
       switch (wanted_sfcgeneration) {
         case actionassociation_sg:
+          if (generate_sfc_active_steps__)
+            print_action_pending(symbol->action_name);
           if (symbol->action_qualifier != NULL) {
             current_action = symbol->action_name;
             symbol->action_qualifier->accept(*this);
@@ -676,6 +978,8 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
   
   private:
     std::list<VARIABLE> variable_list;
+    /* the SFC being generated */
+    sequential_function_chart_c *sfc;
 
     generate_c_sfc_elements_c *generate_c_sfc_elements;
     search_var_instance_decl_c *search_var_instance_decl;
@@ -701,148 +1005,481 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       return var_decl != NULL;
     }
 
-/*********************************************/
-/* B.1.6  Sequential function chart elements */
-/*********************************************/
-    
-    void *visit(sequential_function_chart_c *symbol) {
-      int i;
-      
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        symbol->get_element(i)->accept(*this);
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionlist_sg);
-      }
-      
-      s4o.print(s4o.indent_spaces +"INT i;\n");
-      s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
-      
-      /* generate elapsed_time initializations */
-      s4o.print(s4o.indent_spaces + "// Calculate elapsed_time\n");
-      s4o.print(s4o.indent_spaces +"current_time = __CURRENT_TIME;\n");
-      s4o.print(s4o.indent_spaces +"elapsed_time = __time_sub(current_time, ");
+    /* Reset the action state, and update its set and reset timers.
+     * <index> is the C expression of the index of the action in __action_list.
+     */
+    void print_action_initialization(const char *index) {
+      s4o.print(s4o.indent_spaces);
+      s4o.print(SET_VAR);
+      s4o.print("(");
       print_variable_prefix();
-      s4o.print("__lasttick_time);\n");
+      s4o.print(",__action_list[");
+      s4o.print(index);
+      s4o.print("].state,,0);\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__lasttick_time = current_time;\n");
-      
-      /* generate transition initializations */
-      s4o.print(s4o.indent_spaces + "// Transitions initialization\n");
-      s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].set = 0;\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].reset = 0;\n");
+      print_action_timer_update(index, "set");
+      print_action_timer_update(index, "reset");
+    }
+
+    void print_action_timer_update(const char *index, const char *request) {
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print("__time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print("_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
       s4o.indent_right();
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__nb_transitions; i++) {\n");
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print("_remaining_time = __time_sub(");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print("_remaining_time, elapsed_time);\n");
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print("__time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print("_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__transition_list[i] = ");
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print("_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__debug_transition_list[i];\n");
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].");
+      s4o.print(request);
+      s4o.print(" = 1;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+    }
 
-      /* generate step initializations */
+    /* Evaluate the action state from its set and reset requests.
+     * <index> is the C expression of the index of the action in __action_list.
+     */
+    void print_action_evaluation(const char *index) {
+      s4o.print(s4o.indent_spaces + "if (");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].set) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].stored = 1;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces + "if (");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].reset) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].stored = 0;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces);
+      s4o.print(SET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print(",__action_list[");
+      s4o.print(index);
+      s4o.print("].state,,");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].state) | ");
+      print_variable_prefix();
+      s4o.print("__action_list[");
+      s4o.print(index);
+      s4o.print("].stored);\n");
+    }
+
+    /* Active step driven execution (stage4 option 'a').
+     *
+     * Instead of scanning every step, action and transition in each cycle, we keep:
+     *   - __active_steps:      the steps active at the start of the cycle;
+     *   - __changed_steps:     the steps set or reset during the cycle (whose prev_state
+     *                          must be updated at the start of the next cycle);
+     *   - __fired_transitions: the transitions fired during the cycle;
+     *   - __pending_actions:   the actions associated with an active or changed step, plus the
+     *                          actions still stored or waiting on a timer.
+     * so the time taken by each cycle depends on the number of active steps, and not on
+     * the size of the chart.
+     */
+    void print_active_steps_initialization(void) {
       s4o.print(s4o.indent_spaces + "// Steps initialization\n");
+      /* steps that changed state in the previous cycle */
       s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__nb_steps; i++) {\n");
+      s4o.print("__nb_changed_steps; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "k = ");
+      print_variable_prefix();
+      s4o.print("__changed_steps[i];\n");
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__step_list[k].X) && !");
+      print_variable_prefix();
+      s4o.print("__step_list[k].prev_state) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__step_list[i].prev_state = ");
+      s4o.print("__active_steps[");
+      print_variable_prefix();
+      s4o.print("__nb_active_steps++] = k;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__step_list[k].prev_state = ");
       s4o.print(GET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print("__step_list[i].X);\n");
+      s4o.print("__step_list[k].X);\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__step_changed[k] = 0;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__nb_changed_steps = 0;\n");
+      /* drop the steps that are no longer active, and update the time of the others */
+      s4o.print(s4o.indent_spaces + "for (i = 0, j = 0; i < ");
+      print_variable_prefix();
+      s4o.print("__nb_active_steps; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "k = ");
+      print_variable_prefix();
+      s4o.print("__active_steps[i];\n");
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print(GET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print("__step_list[i].X)) {\n");
+      s4o.print("__step_list[k].X)) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__step_list[i].T.value = __time_add(");
+      s4o.print("__step_list[k].T.value = __time_add(");
       print_variable_prefix();
-      s4o.print("__step_list[i].T.value, elapsed_time);\n");
+      s4o.print("__step_list[k].T.value, elapsed_time);\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__active_steps[j++] = k;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__nb_active_steps = j;\n\n");
 
-      /* generate action initializations */
       s4o.print(s4o.indent_spaces + "// Actions initialization\n");
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      s4o.print(s4o.indent_spaces + "for (i = 0, j = 0; i < ");
       print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
+      s4o.print("__nb_pending_actions; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "k = ");
+      print_variable_prefix();
+      s4o.print("__pending_actions[i];\n");
+      print_action_initialization("k");
+      /* keep the actions that are stored, or waiting on a timer, in the list */
+      s4o.print(s4o.indent_spaces + "if (");
+      print_variable_prefix();
+      s4o.print("__action_list[k].stored || ");
+      print_variable_prefix();
+      s4o.print("__action_list[k].set || ");
+      print_variable_prefix();
+      s4o.print("__action_list[k].reset ||\n" + s4o.indent_spaces + "    __time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[k].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0 ||\n" + s4o.indent_spaces + "    __time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[k].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
-      s4o.print(SET_VAR);
-      s4o.print("(");
       print_variable_prefix();
-      s4o.print(",__action_list[i].state,,0);\n");
+      s4o.print("__pending_actions[j++] = k;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces + "else {\n");
+      s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set = 0;\n");
+      s4o.print("__action_pending[k] = 0;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset = 0;\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
+      s4o.print("__nb_pending_actions = j;\n\n");
+    }
+
+    void print_transitions_initialization(void) {
+      s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+      s4o.print("__nb_transitions; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_sub(");
+      s4o.print("__transition_list[i] = ");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, elapsed_time);\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
+      s4o.print("__debug_transition_list[i];\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      if (generate_sfc_active_steps__) {
+        s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+        print_variable_prefix();
+        s4o.print("__nb_fired_transitions; i++) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        s4o.print(SET_VAR);
+        s4o.print("(");
+        print_variable_prefix();
+        s4o.print(",__transition_list[");
+        print_variable_prefix();
+        s4o.print("__fired_transitions[i]],,0);\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.print(s4o.indent_spaces);
+        print_variable_prefix();
+        s4o.print("__nb_fired_transitions = 0;\n");
+      }
+    }
+
+    void print_steps_initialization(void) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+      s4o.print("__nb_steps; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print("__step_list[i].prev_state = ");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__step_list[i].X);\n");
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__step_list[i].X)) {\n");
+      s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set = 1;\n");
+      s4o.print("__step_list[i].T.value = __time_add(");
+      print_variable_prefix();
+      s4o.print("__step_list[i].T.value, elapsed_time);\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
-      s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
+    }
+
+    /* Packed SFC state (stage4 option 'k', see generate_c_sfc_timed_steps.cc).
+     *
+     * The state of the steps, their state in the previous cycle, and the value of the transitions
+     * are stored in bits of the __step_bits, __prev_step_bits and __transition_bits DWORD arrays.
+     * The step .X elements are still updated whenever a step is set or reset, as they may be read
+     * from IEC 61131-3 code and from the debugger.
+     */
+    void print_packed_transitions_initialization(void) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < (");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+      s4o.print("__nb_transitions + 31) / 32; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_sub(");
+      s4o.print("__transition_bits[i] = 0;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      /* transitions forced with the debugger */
+      s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, elapsed_time);\n");
+      s4o.print("__nb_transitions; i++) {\n");
+      s4o.indent_right();
       s4o.print(s4o.indent_spaces + "if (");
-      s4o.print("__time_cmp(");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+      s4o.print("__debug_transition_list[i].flags & __IEC_FORCE_FLAG) __SET_SFC_BIT(");
+      print_variable_prefix();
+      s4o.print("__transition_bits, i, ");
+      print_variable_prefix();
+      s4o.print("__debug_transition_list[i].value);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+    }
+
+    void print_packed_steps_initialization(void) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < (");
+      print_variable_prefix();
+      s4o.print("__nb_steps + 31) / 32; i++) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print("__prev_step_bits[i] = ");
+      print_variable_prefix();
+      s4o.print("__step_bits[i];\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      /* only the steps in __step_list have an elapsed time */
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      s4o.print(generate_c_sfc_timed_steps_c::get_nb_timed_steps(sfc));
+      s4o.print("; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__step_list[i].X)) {\n");
+      s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset = 1;\n");
+      s4o.print("__step_list[i].T.value = __time_add(");
+      print_variable_prefix();
+      s4o.print("__step_list[i].T.value, elapsed_time);\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+    }
+
+    /* Generate a loop over the transitions fired in this cycle, with a switch
+     * on the transition number (the cases are generated by generate_c_sfc_elements_c).
+     */
+    void print_fired_transitions_switch(sequential_function_chart_c *symbol, generate_c_sfc_elements_c::sfcgeneration_t generation_type) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      print_variable_prefix();
+      s4o.print("__nb_fired_transitions; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "switch (");
+      print_variable_prefix();
+      s4o.print("__fired_transitions[i]) {\n");
+      s4o.indent_right();
+      generate_c_sfc_elements->reset_transition_number();
+      for(int i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generation_type);
+      }
+      s4o.print(s4o.indent_spaces + "default:\n");
+      s4o.print(s4o.indent_spaces + "  break;\n");
       s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n\n");
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+    }
+
+/*********************************************/
+/* B.1.6  Sequential function chart elements */
+/*********************************************/
+    
+    void *visit(sequential_function_chart_c *symbol) {
+      int i;
+      
+      sfc = symbol;
+      generate_c_sfc_elements->set_sfc(symbol);
+      generate_c_sfc_elements->reset_transition_number();
+      for(i = 0; i < symbol->n; i++) {
+        symbol->get_element(i)->accept(*this);
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionlist_sg);
+      }
+      
+      s4o.print(s4o.indent_spaces +"INT i;\n");
+      if (generate_sfc_active_steps__) /* global variable generate_sfc_active_steps__ is defined in generate_c.cc */
+        s4o.print(s4o.indent_spaces +"UINT j, k;\n");
+      if (generate_sfc_packed_state__) /* global variable generate_sfc_packed_state__ is defined in generate_c.cc */
+        s4o.print(s4o.indent_spaces +"DWORD active_steps, prev_steps;\n");
+      s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
+      
+      /* generate elapsed_time initializations */
+      s4o.print(s4o.indent_spaces + "// Calculate elapsed_time\n");
+      s4o.print(s4o.indent_spaces +"current_time = __CURRENT_TIME;\n");
+      s4o.print(s4o.indent_spaces +"elapsed_time = __time_sub(current_time, ");
+      print_variable_prefix();
+      s4o.print("__lasttick_time);\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__lasttick_time = current_time;\n");
+      
+      /* generate transition initializations */
+      s4o.print(s4o.indent_spaces + "// Transitions initialization\n");
+      if (generate_sfc_packed_state__)
+        print_packed_transitions_initialization();
+      else
+        print_transitions_initialization();
+
+      if (generate_sfc_active_steps__) {
+        print_active_steps_initialization();
+      }
+      else {
+        /* generate step initializations */
+        s4o.print(s4o.indent_spaces + "// Steps initialization\n");
+        if (generate_sfc_packed_state__)
+          print_packed_steps_initialization();
+        else
+          print_steps_initialization();
+
+        /* generate action initializations */
+        s4o.print(s4o.indent_spaces + "// Actions initialization\n");
+        s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+        print_variable_prefix();
+        s4o.print("__nb_actions; i++) {\n");
+        s4o.indent_right();
+        print_action_initialization("i");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n\n");
+      }
       
       /* generate transition tests */
       s4o.print(s4o.indent_spaces + "// Transitions fire test\n");
@@ -851,24 +1488,74 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       
       /* generate transition reset steps */
       s4o.print(s4o.indent_spaces + "// Transitions reset steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepreset_sg);
+      if (generate_sfc_active_steps__) {
+        print_fired_transitions_switch(symbol, generate_c_sfc_elements_c::stepreset_sg);
+      }
+      else {
+        generate_c_sfc_elements->reset_transition_number();
+        for(i = 0; i < symbol->n; i++) {
+          generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepreset_sg);
+        }
       }
       s4o.print("\n");
       
       /* generate transition set steps */
       s4o.print(s4o.indent_spaces + "// Transitions set steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepset_sg);
+      if (generate_sfc_active_steps__) {
+        print_fired_transitions_switch(symbol, generate_c_sfc_elements_c::stepset_sg);
+      }
+      else {
+        generate_c_sfc_elements->reset_transition_number();
+        for(i = 0; i < symbol->n; i++) {
+          generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepset_sg);
+        }
       }
       s4o.print("\n");
       
       /* generate step association */
       s4o.print(s4o.indent_spaces + "// Steps association\n");
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
+      if (generate_sfc_active_steps__) {
+        /* steps active at the start of the cycle, followed by the steps activated during the cycle */
+        s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+        print_variable_prefix();
+        s4o.print("__nb_active_steps + ");
+        print_variable_prefix();
+        s4o.print("__nb_changed_steps; i++) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces + "if (i < ");
+        print_variable_prefix();
+        s4o.print("__nb_active_steps) k = ");
+        print_variable_prefix();
+        s4o.print("__active_steps[i];\n");
+        s4o.print(s4o.indent_spaces + "else if (!");
+        print_variable_prefix();
+        s4o.print("__step_list[");
+        print_variable_prefix();
+        s4o.print("__changed_steps[i - ");
+        print_variable_prefix();
+        s4o.print("__nb_active_steps]].prev_state) k = ");
+        print_variable_prefix();
+        s4o.print("__changed_steps[i - ");
+        print_variable_prefix();
+        s4o.print("__nb_active_steps];\n");
+        s4o.print(s4o.indent_spaces + "else continue;\n");
+        s4o.print(s4o.indent_spaces + "switch (k) {\n");
+        s4o.indent_right();
+        for(i = 0; i < symbol->n; i++) {
+          generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
+        }
+        s4o.print(s4o.indent_spaces + "default:\n");
+        s4o.print(s4o.indent_spaces + "  break;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+      else {
+        for(i = 0; i < symbol->n; i++) {
+          generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
+        }
+        generate_c_sfc_elements->end_action_associations();
       }
       s4o.print("\n");
       
@@ -876,42 +1563,23 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       s4o.print(s4o.indent_spaces + "// Actions state evaluation\n");
       s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces + "if (");
-      print_variable_prefix();
-      s4o.print("__action_list[i].set) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].stored = 1;\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces + "if (");
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset) {\n");
-      s4o.indent_right();
-      s4o.print(s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
-      print_variable_prefix();
-      s4o.print("__action_list[i].stored = 0;\n");
-      s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces);
-      s4o.print(SET_VAR);
-      s4o.print("(");
-      print_variable_prefix();
-      s4o.print(",__action_list[i].state,,");
-      s4o.print(GET_VAR);
-      s4o.print("(");
-      print_variable_prefix();
-      s4o.print("__action_list[i].state) | ");
-      print_variable_prefix();
-      s4o.print("__action_list[i].stored);\n");
+      if (generate_sfc_active_steps__) {
+        s4o.print("__nb_pending_actions; i++) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces + "k = ");
+        print_variable_prefix();
+        s4o.print("__pending_actions[i];\n");
+        print_action_evaluation("k");
+      }
+      else {
+        s4o.print("__nb_actions; i++) {\n");
+        s4o.indent_right();
+        print_action_evaluation("i");
+      }
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n\n");
       
+
       /* generate action execution */
       s4o.print(s4o.indent_spaces + "// Actions execution\n");
       {
@@ -0,0 +1,153 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Packed SFC state layout.
+ *
+ *  Each step of an SFC is usually stored in a STEP structure, which includes the
+ *  time elapsed since the step became active (.T), even though very few steps ever
+ *  have their elapsed time read. When the 'k' stage4 option is given (-O k), the
+ *  active and previous state of the steps, and the state of the transitions, are
+ *  packed into arrays of DWORD bits (see generate_c_sfc.cc), and only the steps whose
+ *  elapsed time is used are stored in a STEP structure (in __step_list). The remaining
+ *  steps are stored in an UNTIMED_STEP structure (in __untimed_step_list), that only
+ *  contains the step state (.X).
+ *
+ *  The elapsed time of a step is used if:
+ *    - the step is associated with an action using a L or D qualifier; or
+ *    - 'stepname.T' is referenced in any action or transition condition of the SFC.
+ *
+ *  This class determines which steps are timed, and the C structure in which each
+ *  step is stored.
+ */
+
+
+class generate_c_sfc_timed_steps_c: public iterator_visitor_c {
+  private:
+    typedef std::set<std::string, nocasecmp_c> step_names_t;
+    typedef std::map<std::string, std::string, nocasecmp_c> step_elements_t;
+
+    typedef struct {
+      step_names_t    timed_steps;
+      step_elements_t step_elements;
+      int nb_timed_steps;
+      int nb_untimed_steps;
+    } sfc_layout_t;
+
+    typedef std::map<symbol_c *, sfc_layout_t> sfc_layout_map_t;
+    /* caches the layout of each sequential_function_chart_c already analysed */
+    static sfc_layout_map_t sfc_layout_map;
+
+    step_names_t &timed_steps;
+
+    generate_c_sfc_timed_steps_c(step_names_t &timed_steps_): timed_steps(timed_steps_) {}
+    ~generate_c_sfc_timed_steps_c(void) {}
+
+    static std::string get_name(symbol_c *symbol) {
+      token_c *token = dynamic_cast<token_c *>(symbol);
+      if (NULL == token) ERROR;
+      return token->value;
+    }
+
+    static sfc_layout_t &get_layout(symbol_c *sfc) {
+      sfc_layout_map_t::iterator it = sfc_layout_map.find(sfc);
+      if (it != sfc_layout_map.end()) return it->second;
+
+      sfc_layout_t &layout = sfc_layout_map[sfc];
+      generate_c_sfc_timed_steps_c search(layout.timed_steps);
+      sfc->accept(search);
+
+      /* steps are numbered in the order they are declared, like in generate_c_sfcdecl_c */
+      layout.nb_timed_steps = 0;
+      layout.nb_untimed_steps = 0;
+      list_c *networks = dynamic_cast<list_c *>(sfc);
+      if (NULL == networks) ERROR;
+      for(int i = 0; i < networks->n; i++) {
+        list_c *network = dynamic_cast<list_c *>(networks->get_element(i));
+        if (NULL == network) ERROR;
+        for(int j = 0; j < network->n; j++) {
+          symbol_c *step_name = NULL;
+          initial_step_c *initial_step = dynamic_cast<initial_step_c *>(network->get_element(j));
+          step_c         *step         = dynamic_cast<step_c         *>(network->get_element(j));
+          if (NULL != initial_step) step_name = initial_step->step_name;
+          if (NULL != step)         step_name = step->step_name;
+          if (NULL == step_name) continue;
+
+          std::stringstream element;
+          if (layout.timed_steps.find(get_name(step_name)) != layout.timed_steps.end())
+            element << "__step_list[" << layout.nb_timed_steps++ << "]";
+          else
+            element << "__untimed_step_list[" << layout.nb_untimed_steps++ << "]";
+          layout.step_elements[get_name(step_name)] = element.str();
+        }
+      }
+      return layout;
+    }
+
+  public:
+    /* Is the elapsed time (.T) of step <step_name> of <sfc> used? */
+    static bool is_timed(symbol_c *sfc, symbol_c *step_name) {
+      sfc_layout_t &layout = get_layout(sfc);
+      return layout.timed_steps.find(get_name(step_name)) != layout.timed_steps.end();
+    }
+
+    /* The C structure in which step <step_name> of <sfc> is stored, e.g. "__untimed_step_list[3]" */
+    static std::string get_step_element(symbol_c *sfc, symbol_c *step_name) {
+      sfc_layout_t &layout = get_layout(sfc);
+      step_elements_t::iterator it = layout.step_elements.find(get_name(step_name));
+      if (it == layout.step_elements.end()) ERROR;
+      return it->second;
+    }
+
+    static int get_nb_timed_steps  (symbol_c *sfc) {return get_layout(sfc).nb_timed_steps;}
+    static int get_nb_untimed_steps(symbol_c *sfc) {return get_layout(sfc).nb_untimed_steps;}
+
+  private:
+    void check_action_associations(symbol_c *step_name, symbol_c *action_association_list) {
+      list_c *list = dynamic_cast<list_c *>(action_association_list);
+      if (NULL == list) ERROR;
+      for(int i = 0; i < list->n; i++) {
+        action_association_c *action_association = dynamic_cast<action_association_c *>(list->get_element(i));
+        if ((NULL == action_association) || (NULL == action_association->action_qualifier)) continue;
+        action_qualifier_c *action_qualifier = dynamic_cast<action_qualifier_c *>(action_association->action_qualifier);
+        if (NULL == action_qualifier) ERROR;
+        std::string qualifier = get_name(action_qualifier->action_qualifier);
+        if ((qualifier == "L") || (qualifier == "D"))
+          timed_steps.insert(get_name(step_name));
+      }
+    }
+
+    void *visit(initial_step_c *symbol) {check_action_associations(symbol->step_name, symbol->action_association_list); return NULL;}
+    void *visit(step_c         *symbol) {check_action_associations(symbol->step_name, symbol->action_association_list); return NULL;}
+
+    /* stepname.T */
+    void *visit(structured_variable_c *symbol) {
+      symbolic_variable_c *record_variable = dynamic_cast<symbolic_variable_c *>(symbol->record_variable);
+      token_c *field_selector = dynamic_cast<token_c *>(symbol->field_selector);
+      if ((NULL != record_variable) && (NULL != field_selector) && (strcasecmp(field_selector->value, "T") == 0))
+        timed_steps.insert(get_name(record_variable->var_name));
+      return iterator_visitor_c::visit(symbol);
+    }
+}; /* generate_c_sfc_timed_steps_c */
+
+
+generate_c_sfc_timed_steps_c::sfc_layout_map_t generate_c_sfc_timed_steps_c::sfc_layout_map;
@@ -44,7 +44,8 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
         actiondef_sd,
         actionundef_sd,
         actioncount_sd,
-        transitioncount_sd
+        transitioncount_sd,
+        layout_sd      /* entries of the layout descriptor (see generate_c_layout.cc) */
        } sfcdeclaration_t;
   
   private:
@@ -52,6 +53,8 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
     int action_number;
     int transition_number;
     std::list<VARIABLE> variable_list;
+    /* the SFC being declared */
+    sequential_function_chart_c *sfc;
     
     sfcdeclaration_t wanted_sfcdeclaration;
 
@@ -78,7 +81,13 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
 /* B.1.6  Sequential function chart elements */
 /*********************************************/
     
+    /* number of DWORDs needed to store <nb_bits> bits */
+    void print_nb_words(int nb_bits) {
+      s4o.print((nb_bits + 31) / 32);
+    }
+
     void *visit(sequential_function_chart_c *symbol) {
+      sfc = symbol;
       step_number = 0;
       action_number = 0;
       transition_number = 0;
@@ -88,10 +97,27 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
             symbol->get_element(i)->accept(*this);
           
           /* steps table declaration */
-          s4o.print(s4o.indent_spaces + "STEP __step_list[");
-          s4o.print(step_number);
-          s4o.print("];\n");
-          s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+          if (generate_sfc_packed_state__) { /* global variable generate_sfc_packed_state__ is defined in generate_c.cc */
+            s4o.print(s4o.indent_spaces + "STEP __step_list[");
+            s4o.print(generate_c_sfc_timed_steps_c::get_nb_timed_steps(symbol));
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UNTIMED_STEP __untimed_step_list[");
+            s4o.print(generate_c_sfc_timed_steps_c::get_nb_untimed_steps(symbol));
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+            s4o.print(s4o.indent_spaces + "DWORD __step_bits[");
+            print_nb_words(step_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "DWORD __prev_step_bits[");
+            print_nb_words(step_number);
+            s4o.print("];\n");
+          }
+          else {
+            s4o.print(s4o.indent_spaces + "STEP __step_list[");
+            s4o.print(step_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+          }
           
           /* actions table declaration */
           s4o.print(s4o.indent_spaces + "ACTION __action_list[");
@@ -100,9 +126,16 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(s4o.indent_spaces + "UINT __nb_actions;\n");
           
           /* transitions table declaration */
-          s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __transition_list[");
-          s4o.print(transition_number);
-          s4o.print("];\n");
+          if (generate_sfc_packed_state__) {
+            s4o.print(s4o.indent_spaces + "DWORD __transition_bits[");
+            print_nb_words(transition_number);
+            s4o.print("];\n");
+          }
+          else {
+            s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __transition_list[");
+            s4o.print(transition_number);
+            s4o.print("];\n");
+          }
           
           /* transitions debug table declaration */
           s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __debug_transition_list[");
@@ -110,6 +143,34 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print("];\n");
           s4o.print(s4o.indent_spaces + "UINT __nb_transitions;\n");
           
+          if (generate_sfc_active_steps__) { /* global variable generate_sfc_active_steps__ is defined in generate_c.cc */
+            /* active steps, and steps whose state changed in the current cycle */
+            s4o.print(s4o.indent_spaces + "UINT __active_steps[");
+            s4o.print(step_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_active_steps;\n");
+            s4o.print(s4o.indent_spaces + "UINT __changed_steps[");
+            s4o.print(step_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_changed_steps;\n");
+            s4o.print(s4o.indent_spaces + "BOOL __step_changed[");
+            s4o.print(step_number);
+            s4o.print("];\n");
+            /* transitions fired in the current cycle */
+            s4o.print(s4o.indent_spaces + "UINT __fired_transitions[");
+            s4o.print(transition_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_fired_transitions;\n");
+            /* actions that must be evaluated in the current cycle */
+            s4o.print(s4o.indent_spaces + "UINT __pending_actions[");
+            s4o.print(action_number);
+            s4o.print("];\n");
+            s4o.print(s4o.indent_spaces + "UINT __nb_pending_actions;\n");
+            s4o.print(s4o.indent_spaces + "BOOL __action_pending[");
+            s4o.print(action_number);
+            s4o.print("];\n");
+          }
+          
           /* last_ticktime declaration */
           s4o.print(s4o.indent_spaces + "TIME __lasttick_time;\n");
           break;
@@ -130,16 +191,68 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = sfcinit_sd;
           
           /* steps table initialisation */
-          s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0, 0}, 0, {{0, 0}, 0}};\n");
-          s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
-          print_variable_prefix();
-          s4o.print("__nb_steps; i++) {\n");
-          s4o.indent_right();
-          s4o.print(s4o.indent_spaces);
-          print_variable_prefix();
-          s4o.print("__step_list[i] = temp_step;\n");
-          s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n");
+          if (generate_sfc_packed_state__) {
+            s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0, 0}, 0, {{0, 0}, 0}};\n");
+            s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
+            s4o.print(generate_c_sfc_timed_steps_c::get_nb_timed_steps(symbol));
+            s4o.print("; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__step_list[i] = temp_step;\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+            s4o.print(s4o.indent_spaces + "static const UNTIMED_STEP temp_untimed_step = {{0, 0}};\n");
+            s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
+            s4o.print(generate_c_sfc_timed_steps_c::get_nb_untimed_steps(symbol));
+            s4o.print("; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__untimed_step_list[i] = temp_untimed_step;\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+            s4o.print(s4o.indent_spaces + "for(i = 0; i < (");
+            print_variable_prefix();
+            s4o.print("__nb_steps + 31) / 32; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__step_bits[i] = 0;\n");
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__prev_step_bits[i] = 0;\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
+          else {
+            s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0, 0}, 0, {{0, 0}, 0}};\n");
+            s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
+            print_variable_prefix();
+            s4o.print("__nb_steps; i++) {\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__step_list[i] = temp_step;\n");
+            if (generate_sfc_active_steps__) {
+              s4o.print(s4o.indent_spaces);
+              print_variable_prefix();
+              s4o.print("__step_changed[i] = 0;\n");
+            }
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
+          if (generate_sfc_active_steps__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_active_steps = 0;\n");
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_changed_steps = 0;\n");
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_fired_transitions = 0;\n");
+          }
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
           
@@ -164,8 +277,18 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(s4o.indent_spaces);
           print_variable_prefix();
           s4o.print("__action_list[i] = temp_action;\n");
+          if (generate_sfc_active_steps__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__action_pending[i] = 0;\n");
+          }
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
+          if (generate_sfc_active_steps__) {
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__nb_pending_actions = 0;\n");
+          }
           
           /* transitions table count */
           wanted_sfcdeclaration = transitioncount_sd;
@@ -222,6 +345,27 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
             symbol->get_element(i)->accept(*this);
           s4o.print("\n");
           break;
+        case layout_sd:
+          /* The SFC state is only migrated when it is kept in the __step_list and __action_list tables */
+          if (generate_sfc_packed_state__ || generate_sfc_active_steps__) break;
+          for(int i = 0; i < symbol->n; i++)
+            symbol->get_element(i)->accept(*this);
+          {
+            // first fill up the this->variable_list variable!
+            wanted_sfcdeclaration = actioncount_sd;
+            for(int i = 0; i < symbol->n; i++)
+               symbol->get_element(i)->accept(*this);
+            wanted_sfcdeclaration = layout_sd;
+            // actions that reference a variable instead of an action block
+            std::list<VARIABLE>::iterator pt;
+            for(pt = variable_list.begin(); pt != variable_list.end(); pt++) {
+              s4o.print(s4o.indent_spaces + LAYOUT_ACTION "(");
+              pt->symbol->accept(*this);
+              s4o.print(")\n");
+            }
+          }
+          s4o.print(s4o.indent_spaces + LAYOUT_VAR "(TIME,__lasttick_time)\n");
+          break;
         case actionundef_sd:
           s4o.print("// Actions undefinitions\n");
           for(int i = 0; i < symbol->n; i++)
@@ -263,17 +407,51 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(SET_VAR);
           s4o.print("(");
           print_variable_prefix();
-          s4o.print(",__step_list[");
-          s4o.print(step_number);
-          s4o.print("].X,,1);\n");
+          if (generate_sfc_packed_state__) {
+            s4o.print(",");
+            s4o.print(generate_c_sfc_timed_steps_c::get_step_element(sfc, symbol->step_name));
+            s4o.print(".X,,1);\n");
+            s4o.print(s4o.indent_spaces + "__SET_SFC_BIT(");
+            print_variable_prefix();
+            s4o.print("__step_bits, ");
+            s4o.print(step_number);
+            s4o.print(", 1);\n");
+          }
+          else {
+            s4o.print(",__step_list[");
+            s4o.print(step_number);
+            s4o.print("].X,,1);\n");
+          }
+          if (generate_sfc_active_steps__) {
+            /* the initial step becomes active in the first cycle */
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__step_changed[");
+            s4o.print(step_number);
+            s4o.print("] = 1;\n");
+            s4o.print(s4o.indent_spaces);
+            print_variable_prefix();
+            s4o.print("__changed_steps[");
+            print_variable_prefix();
+            s4o.print("__nb_changed_steps++] = ");
+            s4o.print(step_number);
+            s4o.print(";\n");
+          }
           step_number++;
           break;
         case stepdef_sd:
           s4o.print("#define ");
           symbol->step_name->accept(*this);
-          s4o.print(" __step_list[");
-          s4o.print(step_number);
-          s4o.print("]\n");
+          if (generate_sfc_packed_state__) {
+            s4o.print(" ");
+            s4o.print(generate_c_sfc_timed_steps_c::get_step_element(sfc, symbol->step_name));
+            s4o.print("\n");
+          }
+          else {
+            s4o.print(" __step_list[");
+            s4o.print(step_number);
+            s4o.print("]\n");
+          }
 
           s4o.print("#define ");
           s4o.print(SFC_STEP_ACTION_PREFIX);
@@ -293,6 +471,11 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           symbol->step_name->accept(*this);
           s4o.print("\n");
           break;
+        case layout_sd:
+          s4o.print(s4o.indent_spaces + LAYOUT_STEP "(");
+          symbol->step_name->accept(*this);
+          s4o.print(")\n");
+          break;
         default:
           break;
       }
@@ -313,9 +496,16 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
         case stepdef_sd:
           s4o.print("#define ");
           symbol->step_name->accept(*this);
-          s4o.print(" __step_list[");
-          s4o.print(step_number);
-          s4o.print("]\n");
+          if (generate_sfc_packed_state__) {
+            s4o.print(" ");
+            s4o.print(generate_c_sfc_timed_steps_c::get_step_element(sfc, symbol->step_name));
+            s4o.print("\n");
+          }
+          else {
+            s4o.print(" __step_list[");
+            s4o.print(step_number);
+            s4o.print("]\n");
+          }
 
           s4o.print("#define ");
           s4o.print(SFC_STEP_ACTION_PREFIX);
@@ -335,6 +525,11 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           symbol->step_name->accept(*this);
           s4o.print("\n");
           break;
+        case layout_sd:
+          s4o.print(s4o.indent_spaces + LAYOUT_STEP "(");
+          symbol->step_name->accept(*this);
+          s4o.print(")\n");
+          break;
         default:
           break;
       }
@@ -388,6 +583,11 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           symbol->action_name->accept(*this);
           s4o.print("\n");
           break;
+        case layout_sd:
+          s4o.print(s4o.indent_spaces + LAYOUT_ACTION "(");
+          symbol->action_name->accept(*this);
+          s4o.print(")\n");
+          break;
         case actioncount_sd:
         case sfcdecl_sd:
           action_number++;
@@ -84,6 +84,16 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
     variablegeneration_t wanted_variablegeneration;
 
+    /* The operand of the REF() operator currently being generated, whose address is taken,
+     * so it must not be replaced by its value even if it is a CONSTANT.
+     */
+    symbol_c *ref_operand;
+
+    /* The arrays whose elements are currently being accessed through a restrict pointer
+     * (see print_vector_for() and generate_c_vector_loops.cc)
+     */
+    std::set<std::string, nocasecmp_c> vector_arrays;
+
   public:
     generate_c_st_c(stage4out_c *s4o_ptr, symbol_c *name, symbol_c *scope, const char *variable_prefix = NULL)
     : generate_c_base_and_typeid_c(s4o_ptr) {
@@ -98,6 +108,7 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
       fcall_number = 0;
       fbname = name;
       wanted_variablegeneration = expression_vg;
+      ref_operand = NULL;
     }
 
     virtual ~generate_c_st_c(void) {
@@ -119,7 +130,35 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
 
 
+/* If <symbol> is an element of an array currently being accessed through a restrict
+ * pointer (i.e. inside a FOR loop generated by print_vector_for()), print the
+ * element accessed through that pointer, and return true. Otherwise print nothing,
+ * and return false.
+ */
+bool print_vector_element(symbol_c *symbol) {
+  if (vector_arrays.empty() || (wanted_variablegeneration != expression_vg)) return false;
+  array_variable_c *element = dynamic_cast<array_variable_c *>(symbol);
+  if (NULL == element) return false;
+  token_c *array_name = get_var_name_c::get_name(element->subscripted_variable);
+  if ((NULL == array_name) || (vector_arrays.find(array_name->value) == vector_arrays.end())) return false;
+
+  current_array_type = search_varfb_instance_type->get_basetype_decl(element->subscripted_variable);
+  if (current_array_type == NULL) ERROR;
+  s4o.print(VECTOR_VAR);
+  print_token(array_name);
+  element->subscript_list->accept(*this);
+  current_array_type = NULL;
+  return true;
+}
+
+
 void *print_getter(symbol_c *symbol) {
+  /* variables promoted to C local variables are never passed by reference (i.e. with fparam_output_vg) */
+  if (print_promoted_var(symbol))
+    return NULL;
+  if (print_vector_element(symbol))
+    return NULL;
+
   unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol, scope_);
   if (wanted_variablegeneration == fparam_output_vg) {
     if (vartype == search_var_instance_decl_c::external_vt) {
@@ -169,6 +208,13 @@ void *print_setter(symbol_c* symbol,
         symbol_c* fb_symbol = NULL,
         symbol_c* fb_value = NULL) {
  
+  if ((fb_symbol == NULL) && (print_promoted_var(symbol) || print_vector_element(symbol))) {
+    s4o.print(" = ");
+    wanted_variablegeneration = expression_vg;
+    print_check_function(type, value, fb_value);
+    return NULL;
+  }
+
   if (fb_symbol == NULL) {
     unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol, scope_);
     symbol_c *first_nonfb = analyse_variable_c::find_first_nonfb(symbol);
@@ -253,7 +299,13 @@ void *visit(symbolic_variable_c *symbol) {
     case complextype_suffix_vg:
       break;
     default:
+      if ((wanted_variablegeneration == expression_vg) && (symbol != ref_operand) && print_const_value(symbol))
+        break; /* a CONSTANT variable, whose value is known at compile time */
+      if ((wanted_variablegeneration == expression_vg) && print_specialized_input(symbol))
+        break; /* an input bound to a constant, in a specialised FB body */
       if (this->is_variable_prefix_null()) {
+        if (print_byref_input(symbol))
+          break; /* a Function input passed by pointer - never written to, so never passed with fparam_output_vg */
         if (wanted_variablegeneration == fparam_output_vg) {
           s4o.print("&(");
           generate_c_base_c::visit(symbol);
@@ -396,6 +448,8 @@ void *visit(array_variable_c *symbol) {
       current_array_type = NULL;
       break;
     default:
+      if (print_vector_element(symbol))
+        break;
       if (this->is_variable_prefix_null()) {
         symbol->subscripted_variable->accept(*this);
 
@@ -545,7 +599,10 @@ void *visit(ref_expression_c *symbol) {
   if (this->is_variable_prefix_null()) {  
     /* For code in FUNCTIONs */
     s4o.print("&(");  
+    symbol_c *old_ref_operand = ref_operand;
+    ref_operand = symbol->exp;
     symbol->exp->accept(*this);    
+    ref_operand = old_ref_operand;
     s4o.print(")");  
   } else {
     /* For code in FBs, and PROGRAMS... */
@@ -583,6 +640,7 @@ void *visit(ref_expression_c *symbol) {
 
 
 void *visit(or_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_BOOL_compatible(symbol->datatype))
     return print_binary_expression(symbol->l_exp, symbol->r_exp, " || ");
   if (get_datatype_info_c::is_ANY_nBIT_compatible(symbol->datatype))
@@ -592,6 +650,7 @@ void *visit(or_expression_c *symbol) {
 }
 
 void *visit(xor_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_BOOL_compatible(symbol->datatype)) {
     s4o.print("((");
     symbol->l_exp->accept(*this);
@@ -611,6 +670,7 @@ void *visit(xor_expression_c *symbol) {
 }
 
 void *visit(and_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_BOOL_compatible(symbol->datatype))
     return print_binary_expression(symbol->l_exp, symbol->r_exp, " && ");
   if (get_datatype_info_c::is_ANY_nBIT_compatible(symbol->datatype))
@@ -620,6 +680,7 @@ return NULL;
 }
 
 void *visit(equ_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -628,6 +689,7 @@ void *visit(equ_expression_c *symbol) {
 }
 
 void *visit(notequ_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -636,6 +698,7 @@ void *visit(notequ_expression_c *symbol) {
 }
 
 void *visit(lt_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -644,6 +707,7 @@ void *visit(lt_expression_c *symbol) {
 }
 
 void *visit(gt_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -652,6 +716,7 @@ void *visit(gt_expression_c *symbol) {
 }
 
 void *visit(le_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -660,6 +725,7 @@ void *visit(le_expression_c *symbol) {
 }
 
 void *visit(ge_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->l_exp->datatype) ||
       get_datatype_info_c::is_ANY_STRING_compatible(symbol->l_exp->datatype))
@@ -668,6 +734,7 @@ void *visit(ge_expression_c *symbol) {
 }
 
 void *visit(add_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->datatype))
     return print_binary_function("__time_add", symbol->l_exp, symbol->r_exp);
@@ -675,6 +742,7 @@ void *visit(add_expression_c *symbol) {
 }
 
 void *visit(sub_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->datatype) ||
       get_datatype_info_c::is_ANY_DATE_compatible  (symbol->datatype))
     return print_binary_function("__time_sub", symbol->l_exp, symbol->r_exp);
@@ -682,18 +750,21 @@ void *visit(sub_expression_c *symbol) {
 }
 
 void *visit(mul_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->datatype))
     return print_binary_function("__time_mul", symbol->l_exp, symbol->r_exp);
   return print_binary_expression(symbol->l_exp, symbol->r_exp, " * ");
 }
 
 void *visit(div_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   if (get_datatype_info_c::is_TIME_compatible      (symbol->datatype))
     return print_binary_function("__time_div", symbol->l_exp, symbol->r_exp);
   return print_binary_expression(symbol->l_exp, symbol->r_exp, " / ");
 }
 
 void *visit(mod_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   s4o.print("((");
   symbol->r_exp->accept(*this);
   s4o.print(" == 0)?0:");
@@ -703,6 +774,7 @@ void *visit(mod_expression_c *symbol) {
 }
 
 void *visit(power_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   s4o.print("__expt((LREAL)(");
   symbol->l_exp->accept(*this);
   s4o.print("), (LREAL)(");
@@ -712,14 +784,19 @@ void *visit(power_expression_c *symbol) {
 }
 
 void *visit(neg_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   return print_unary_expression(symbol->exp, " -");
 }
 
 void *visit(not_expression_c *symbol) {
+  if (print_const_value(symbol)) return NULL;
   return print_unary_expression(symbol->exp, get_datatype_info_c::is_BOOL_compatible(symbol->datatype)?"!":"~");
 }
 
 void *visit(function_invocation_c *symbol) {
+  /* a Function invocation evaluated at compile time (see stage3/function_evaluation.hh) */
+  if (print_const_value(symbol)) return NULL;
+
   symbol_c* function_name = NULL;
   DECLARE_PARAM_LIST()
 
@@ -729,22 +806,18 @@ void *visit(function_invocation_c *symbol) {
   // NOTE-> We support the non-standard feature of POUS with no in, out and inout parameters, so this is no longer an internal error!
   //if (NULL == parameter_assignment_list) ERROR;
 
-  function_call_param_iterator_c function_call_param_iterator(symbol);
-
   function_declaration_c *f_decl = (function_declaration_c *)symbol->called_function_declaration;
   if (f_decl == NULL) ERROR;
   
   function_name = symbol->function_name;
   
-  /* loop through each function parameter, find the value we should pass
-   * to it, and then output the c equivalent...
+  /* loop through each function parameter, get the value we should pass
+   * to it (already resolved by stage 3), and then output the c equivalent...
    */
-  function_param_iterator_c fp_iterator(f_decl);
-  identifier_c *param_name;
-    /* flag to cirreclty handle calls to extensible standard functions (i.e. functions with variable number of input parameters) */
-  bool found_first_extensible_parameter = false;  
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    if (fp_iterator.is_extensible_param() && (!found_first_extensible_parameter)) {
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, f_decl);
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    if (binding.extensible_count) {
       /* We are calling an extensible function. Before passing the extensible
        * parameters, we must add a dummy paramater value to tell the called
        * function how many extensible parameters we will be passing.
@@ -766,56 +839,22 @@ void *visit(function_invocation_c *symbol) {
       uint_type_name_c *param_type  = new uint_type_name_c();
       identifier_c *param_name = new identifier_c("");
       ADD_PARAM_LIST(param_name, param_value, param_type, function_param_iterator_c::direction_in)
-      found_first_extensible_parameter = true;
+      continue;
     }
 
-    if (fp_iterator.is_extensible_param()) {      
-      /* since we are handling an extensible parameter, we must add the index to the
-       * parameter name so we can go looking for the value passed to the correct
-       * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
-       */
-      char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
-      int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
-      if ((res >= 32) || (res < 0)) ERROR;
-      param_name = new identifier_c(strdup2(param_name->value, tmp));
-      if (param_name->value == NULL) ERROR;
-    }
-    
-    symbol_c *param_type = fp_iterator.param_type();
-    if (param_type == NULL) ERROR;
-
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-    
-    symbol_c *param_value = NULL;
-    
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    if (param_value == NULL)
-      param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit()) {
-      param_value = function_call_param_iterator.next_nf();
-    }
-
-    /* if no more parameter values in function call, and the current parameter
-     * of the function declaration is an extensible parameter, we
-     * have reached the end, and should simply jump out of the for loop.
-     */
-    if ((param_value == NULL) && (fp_iterator.is_extensible_param())) {
-      break;
-    }
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
+    symbol_c *param_value = binding.param_value;
     
     if ((param_value == NULL) && (param_direction == function_param_iterator_c::direction_in)) {
       /* No value given for parameter, so we must use the default... */
       /* First check whether default value specified in function declaration...*/
-      param_value = fp_iterator.default_value();
+      param_value = binding.default_value;
     }
     
-    ADD_PARAM_LIST(param_name, param_value, param_type, param_direction)
+    ADD_PARAM_LIST(binding.param_name, param_value, binding.param_type, param_direction)
   } /* for(...) */
-  // symbol->parameter_assignment->accept(*this);
   
-  if (function_call_param_iterator.next_nf() != NULL) ERROR;
+  if (param_bindings.unbound_values) ERROR;
 
   bool has_output_params = false;
 
@@ -875,6 +914,16 @@ void *visit(function_invocation_c *symbol) {
           param_value = type_initial_value_c::get(current_param_type);
         }
         if (param_value == NULL) ERROR;
+        if (generate_c_byref_inputs_c::is_byref(f_decl, PARAM_NAME)) {
+          /* an ARRAY or STRUCT input passed by pointer (see generate_c_byref_inputs.cc) */
+          s4o.print("(const ");
+          current_param_type->accept(*this);
+          s4o.print(" *)&(");
+          param_value->accept(*this);
+          s4o.print(")");
+          nb_param++;
+          break;
+        }
         s4o.print("(");
         if      (get_datatype_info_c::is_ANY_INT_literal(current_param_type))
           get_datatype_info_c::lint_type_name.accept(*this);
@@ -975,29 +1024,16 @@ void *visit(fb_invocation_c *symbol) {
   symbol_c *function_block_type_name = get_datatype_info_c::get_id(fb_decl);
   if (NULL == function_block_type_name) ERROR;
   
-  /* loop through each function block parameter, find the value we should pass
-   * to it, and then output the c equivalent...
+  /* loop through each function block parameter, get the value we should pass
+   * to it (already resolved by stage 3), and then output the c equivalent...
    */
-  function_param_iterator_c fp_iterator(fb_decl);
-  identifier_c *param_name;
-  function_call_param_iterator_c function_call_param_iterator(symbol);
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-    
-    /*fprintf(stderr, "param : %s\n", param_name->value);*/
-    
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
-
-    symbol_c *param_type = fp_iterator.param_type();
-    if (param_type == NULL) ERROR;
+  const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, fb_decl);
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    symbol_c *param_name  = binding.param_name;
+    symbol_c *param_value = binding.param_value;
+    symbol_c *param_type  = binding.param_type;
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
     
     /* now output the value assignment */
     if (param_value != NULL)
@@ -1019,6 +1055,7 @@ void *visit(fb_invocation_c *symbol) {
 
   /* now call the function... */
   function_block_type_name->accept(*this);
+  s4o.print(generate_c_fb_specialization_c::get_suffix(scope_, symbol->fb_name));
   s4o.print(FB_FUNCTION_SUFFIX);
   s4o.print("(");
   if (search_var_instance_decl->get_vartype(symbol->fb_name) != search_var_instance_decl_c::external_vt)
@@ -1030,20 +1067,11 @@ void *visit(fb_invocation_c *symbol) {
   /* loop through each function parameter, find the variable to which
    * we should atribute the value of all output or inoutput parameters.
    */
-  fp_iterator.reset();
-  function_call_param_iterator.reset();
-  for(int i = 1; (param_name = fp_iterator.next()) != NULL; i++) {
-    function_param_iterator_c::param_direction_t param_direction = fp_iterator.param_direction();
-
-    /* Get the value from a foo(<param_name> = <param_value>) style call */
-    symbol_c *param_value = function_call_param_iterator.search_f(param_name);
-
-    /* Get the value from a foo(<param_value>) style call */
-    /* When using the informal invocation style, user can not pass values to EN or ENO parameters if these
-     * were implicitly defined!
-     */
-    if ((param_value == NULL) && !fp_iterator.is_en_eno_param_implicit())
-      param_value = function_call_param_iterator.next_nf();
+  for(unsigned int i = 0; i < param_bindings.size(); i++) {
+    const param_binding_c &binding = param_bindings[i];
+    symbol_c *param_name  = binding.param_name;
+    symbol_c *param_value = binding.param_value;
+    function_param_iterator_c::param_direction_t param_direction = (function_param_iterator_c::param_direction_t)binding.param_direction;
 
     /* now output the value assignment */
     if (param_value != NULL)
@@ -1232,8 +1260,201 @@ void *visit(case_list_c *symbol) {
 /********************************/
 /* B 3.2.4 Iteration Statements */
 /********************************/
+/* A helper function... */
+/* Is <symbol> a variable stored directly in a C local variable, i.e. a variable promoted
+ * to a C local variable, or any variable of the Function being generated other than
+ * its VAR_OUTPUT and VAR_IN_OUT parameters (which are accessed through a pointer)?
+ */
+bool is_c_local_var(symbol_c *symbol) {
+  if (NULL == dynamic_cast<symbolic_variable_c *>(symbol)) return false;
+  if (is_promoted_var(symbol))                             return true;
+  if (!this->is_variable_prefix_null())                    return false;
+  search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(symbol);
+  return ((vartype != search_var_instance_decl_c::output_vt) && (vartype != search_var_instance_decl_c::inoutput_vt));
+}
+
+/* A helper function... */
+/* Does <expression> evaluate to the same value on every iteration of the FOR loop <symbol>?
+ * Only constants, and C local variables that are never written to inside the loop, are considered.
+ */
+bool is_for_loop_invariant(symbol_c *expression, for_statement_c *symbol) {
+  if (expression->const_value._int64.is_valid() || expression->const_value._uint64.is_valid())
+    return true;
+  if (!is_c_local_var(expression))
+    return false;
+  byref_inputs_t written_vars;
+  generate_c_written_vars_c search_written_vars(written_vars);
+  symbol->accept(search_written_vars); /* includes the control variable */
+  token_c *var_name = get_var_name_c::get_name(expression);
+  return ((NULL != var_name) && (written_vars.find(var_name->value) == written_vars.end()));
+}
+
+/* A helper function... */
+/* Returns 1 (or -1) if the FOR loop <symbol> increments (or decrements) its control
+ * variable by a value known at compile time, or 0 otherwise.
+ */
+int for_loop_direction(for_statement_c *symbol) {
+  if (NULL == symbol->by_expression) return 1;
+  const_value_c &by = symbol->by_expression->const_value;
+  if (by._int64 .is_valid()) return (by._int64.get() > 0)? 1 : (by._int64.get() < 0)? -1 : 0;
+  if (by._uint64.is_valid()) return (by._uint64.get() > 0)? 1 : 0;
+  return 0;
+}
+
+/* A helper function... */
+/* Print the increment of the control variable of the FOR loop <symbol> */
+void print_for_increment(for_statement_c *symbol) {
+  if (symbol->by_expression == NULL) {
+    /* increment by 1 */    
+    /* For the increment part, we create an add_expression_c and assignment_statement_c   */
+    /* and have this visitor vist the latter!                                             */ 
+    integer_c              integer_oneval("1");
+    add_expression_c       add_expression(symbol->control_variable, &integer_oneval);
+    assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
+    integer_oneval.const_value._int64 .set(1);                    // set the stage3 anottation we need 
+    integer_oneval.const_value._uint64.set(1);                    // set the stage3 anottation we need
+    integer_oneval.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
+    add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
+    inc_assignment.accept(*this);
+    //symbol->control_variable->accept(*this);  // this does not work for VAR_GLOBAL variables
+    //s4o.print("++");
+  } else {
+    /* increment by user defined value  */
+    /* For the increment part, we create an add_expression_c and assignment_statement_c   */
+    /* and have this visitor vist the latter!                                             */ 
+    add_expression_c       add_expression(symbol->control_variable, symbol->by_expression);
+    assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
+    add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
+    inc_assignment.accept(*this);
+    //symbol->control_variable->accept(*this);  // this does not work for VAR_GLOBAL variables
+    //s4o.print(" += (");
+    //symbol->by_expression->accept(*this);
+    //s4o.print(")");
+  }
+}
+
+/* A helper function... */
+/* Print the FOR loop <symbol> as a C for(;;) loop */
+void print_native_for(for_statement_c *symbol, int direction) {
+  s4o.print("for (");
+  assignment_statement_c ini_assignment(symbol->control_variable, symbol->beg_expression);
+  ini_assignment.accept(*this);
+  s4o.print("; ");
+  symbol->control_variable->accept(*this);
+  s4o.print((direction > 0)? " <= (" : " >= (");
+  symbol->end_expression->accept(*this);
+  s4o.print("); ");
+  print_for_increment(symbol);
+  s4o.print(") {\n");
+  s4o.indent_right();
+  symbol->statement_list->accept(*this);
+  s4o.indent_left();
+  s4o.print(s4o.indent_spaces + "}");
+}
+
+/* A helper function... */
+/* Print the FOR loop <symbol> as a C for(;;) loop that accesses the arrays it
+ * iterates over through restrict pointers, preceded by the __IVDEP hint (see
+ * generate_c_vector_loops.cc). If the arrays written to in the loop may be
+ * forced, this loop is only executed when none of them is, and the loop
+ * generated by print_native_for() is executed otherwise.
+ * Returns false (having printed nothing) if the loop may not be handled this way.
+ */
+bool print_vector_for(for_statement_c *symbol, int direction) {
+  generate_c_vector_loop_c loop(symbol);
+  if (!loop.supported) return false;
+
+  token_c *control_var_name = get_var_name_c::get_name(symbol->control_variable);
+  if (NULL == control_var_name) ERROR;
+  for (unsigned int i = 0; i < loop.written_vars.size(); i++) {
+    token_c *var_name = get_var_name_c::get_name(loop.written_vars[i]);
+    if (!is_c_local_var(loop.written_vars[i]) || (NULL == var_name) || (strcasecmp(var_name->value, control_var_name->value) == 0))
+      return false;
+  }
+
+  /* Only arrays declared in the POU itself are accessed through the pointers.
+   * Any other array (VAR_EXTERNAL, VAR_IN_OUT, Function inputs that may be passed by pointer, ...)
+   * could be the same array as another one accessed in the loop.
+   */
+  std::vector<generate_c_vector_loop_c::arrays_t::iterator> arrays;
+  for (generate_c_vector_loop_c::arrays_t::iterator it = loop.arrays.begin(); it != loop.arrays.end(); it++) {
+    symbol_c *datatype = it->second.element->datatype;
+    search_var_instance_decl_c::vt_t vartype = search_var_instance_decl->get_vartype(it->second.element->subscripted_variable);
+    bool eligible =    get_datatype_info_c::is_ANY_ELEMENTARY(datatype)
+                   && !get_datatype_info_c::is_ANY_STRING(datatype)
+                   && (NULL != get_datatype_info_c::get_id_str(datatype));
+    if (this->is_variable_prefix_null())
+      eligible &= ((vartype == search_var_instance_decl_c::private_vt) || (vartype == search_var_instance_decl_c::none_vt));
+    else
+      eligible &= (   (vartype == search_var_instance_decl_c::input_vt)   || (vartype == search_var_instance_decl_c::output_vt)
+                   || (vartype == search_var_instance_decl_c::private_vt) || (vartype == search_var_instance_decl_c::temp_vt));
+    if (it->second.written && (!eligible || it->second.other_index))
+      return false;
+    if (eligible)
+      arrays.push_back(it);
+  }
+  if (arrays.empty()) return false;
+
+  /* Variables of FBs and Programs may be forced by the debugger... */
+  bool versioned = false;
+  for (unsigned int i = 0; i < arrays.size(); i++) {
+    if (!arrays[i]->second.written || this->is_variable_prefix_null()) continue;
+    s4o.print(versioned? " && !(" : "if (!(");
+    print_variable_prefix();
+    s4o.print(arrays[i]->first);
+    s4o.print(".flags & __IEC_FORCE_FLAG)");
+    versioned = true;
+  }
+  s4o.print(versioned? ") {\n" : "{\n");
+  s4o.indent_right();
+  for (unsigned int i = 0; i < arrays.size(); i++) {
+    s4o.print(s4o.indent_spaces);
+    if (!arrays[i]->second.written) s4o.print("const ");
+    s4o.print(get_datatype_info_c::get_id_str(arrays[i]->second.element->datatype));
+    s4o.print(" *__RESTRICT " VECTOR_VAR);
+    s4o.print(arrays[i]->first);
+    s4o.print(" = ");
+    print_variable_prefix();
+    s4o.print(arrays[i]->first);
+    s4o.print(this->is_variable_prefix_null()? ".table;\n" : ".value.table;\n");
+    vector_arrays.insert(arrays[i]->first);
+  }
+  s4o.print(s4o.indent_spaces + "__IVDEP\n");
+  s4o.print(s4o.indent_spaces);
+  print_native_for(symbol, direction);
+  vector_arrays.clear();
+  s4o.indent_left();
+  s4o.print("\n" + s4o.indent_spaces + "}");
+  if (versioned) {
+    s4o.print(" else {\n");
+    s4o.indent_right();
+    s4o.print(s4o.indent_spaces);
+    print_native_for(symbol, direction);
+    s4o.indent_left();
+    s4o.print("\n" + s4o.indent_spaces + "}");
+  }
+  return true;
+}
+
 void *visit(for_statement_c *symbol) {
-  /* Due to the way the GET/SET_GLOBAL accessor macros access VAR_GLOBAL variables,
+  /* When the control variable is a C local variable, and the loop's end and increment
+   * do not change while the loop executes (the increment being a constant, whose sign
+   * determines the end of loop test), we may use a C for(;;) loop. The C compiler is
+   * then able to unroll and vectorise the loop.
+   */
+  int direction = for_loop_direction(symbol);
+  if (   (0 != direction)
+      && is_c_local_var(symbol->control_variable)
+      && is_for_loop_invariant(symbol->end_expression, symbol)) {
+    s4o.print("/* FOR ... */\n" + s4o.indent_spaces);
+    if (!generate_vector_loops__ || !print_vector_for(symbol, direction))
+      print_native_for(symbol, direction);
+    s4o.print(" /* END_FOR */");
+    return NULL;
+  }
+
+  /* Otherwise...
+   * Due to the way the GET/SET_GLOBAL accessor macros access VAR_GLOBAL variables,
    * these varibles cannot be used within a C for(;;) loop.
    * We must therefore implemnt the FOR END_FOR loop as a C while() loop
    */
@@ -1283,33 +1504,7 @@ void *visit(for_statement_c *symbol) {
   /* increment part */
   s4o.print(s4o.indent_spaces + "/* BY ... (of FOR loop) */\n");
   s4o.print(s4o.indent_spaces); 
-  if (symbol->by_expression == NULL) {
-    /* increment by 1 */    
-    /* For the increment part, we create an add_expression_c and assignment_statement_c   */
-    /* and have this visitor vist the latter!                                             */ 
-    integer_c              integer_oneval("1");
-    add_expression_c       add_expression(symbol->control_variable, &integer_oneval);
-    assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
-    integer_oneval.const_value._int64 .set(1);                    // set the stage3 anottation we need 
-    integer_oneval.const_value._uint64.set(1);                    // set the stage3 anottation we need
-    integer_oneval.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
-    add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
-    inc_assignment.accept(*this);
-    //symbol->control_variable->accept(*this);  // this does not work for VAR_GLOBAL variables
-    //s4o.print("++");
-  } else {
-    /* increment by user defined value  */
-    /* For the increment part, we create an add_expression_c and assignment_statement_c   */
-    /* and have this visitor vist the latter!                                             */ 
-    add_expression_c       add_expression(symbol->control_variable, symbol->by_expression);
-    assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
-    add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
-    inc_assignment.accept(*this);
-    //symbol->control_variable->accept(*this);  // this does not work for VAR_GLOBAL variables
-    //s4o.print(" += (");
-    //symbol->by_expression->accept(*this);
-    //s4o.print(")");
-  }  
+  print_for_increment(symbol);
   
   s4o.indent_left();
   s4o.print(";\n" + s4o.indent_spaces + "} /* END_FOR */");
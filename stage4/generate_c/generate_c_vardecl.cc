@@ -23,6 +23,7 @@
  */
 
 #include <limits>  // required for std::numeric_limits<XXX>
+#include <vector>
 
 class initialization_analyzer_c: public null_visitor_c {
   public:
@@ -77,10 +78,34 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
     symbol_c* array_default_initialization;
 
   private:
+    /* The initial values of the array elements, flattened and run length encoded.
+     * e.g. [1, 2, 3(5), 9998(0)] is stored as {1,1}, {2,1}, {5,3}, {0,9998}
+     */
+    typedef struct {
+      symbol_c *value;
+      unsigned long long int count;
+    } init_run_t;
+
+    /* A sequence of array elements that are initialised together, either by a 
+     * loop/memset() (when all the elements have the same value) or 
+     * by copying a static const table (the other elements).
+     */
+    typedef struct {
+      unsigned int first_run, last_run;  /* the runs in init_runs[first_run..last_run[ */
+      unsigned long long int start, count;
+      bool is_table;
+    } init_segment_t;
+
+    /* Runs of the same value with at least this number of elements are initialised in a loop (or memset()),
+     * instead of being copied from a static const table.
+     */
+    static const unsigned long long int min_loop_count = 16;
+
     int current_dimension;
     unsigned long long int array_size;
     unsigned long long int defined_values_count;
-    unsigned long long int current_initialization_count;
+    unsigned long long int skip_values_count;
+    std::vector<init_run_t> init_runs;
 
   public:
     generate_c_array_initialization_c(stage4out_c *s4o_ptr): generate_c_base_and_typeid_c(s4o_ptr) {}
@@ -89,7 +114,8 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
     void init_array_size(symbol_c *array_specification) {
       array_size = 1;
       defined_values_count = 0;
-      current_initialization_count = 0;
+      skip_values_count = 0;
+      init_runs.clear();
       array_base_type = array_default_value = array_default_initialization = NULL;
       
       current_mode = arraysize_am;
@@ -100,49 +126,211 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
       array_default_initialization = array_initialization;
     }
 
+    /* Initialise the array variables in var1_list, inside the FBNAME_init__() function, e.g.:
+     *  {
+     *    INT *__elems;
+     *    ULINT __i;
+     *    static const INT __init_table0[3] = {1,2,3};
+     *    __elems = (INT *)__GET_VAR_REF(data__->A,.table);
+     *    memcpy(&__elems[0], __init_table0, sizeof(__init_table0));
+     *    for (__i = 3ULL; __i < 10000ULL; __i++) __elems[__i] = 42;
+     *  }
+     */
     void init_array(symbol_c *var1_list, symbol_c *array_specification, symbol_c *array_initialization) {
-      int i;
-      
       init_array_size(array_specification);
-      
+      get_array_values(array_initialization);
+
+      std::vector<init_segment_t> segments;
+      bool has_loop = false;
+      unsigned long long int start = 0;
+      for (unsigned int i = 0; i < init_runs.size(); i++) {
+        bool is_table = !is_loop_run(init_runs[i]);
+        if (is_table && !segments.empty() && segments.back().is_table) {
+          segments.back().last_run = i + 1;
+          segments.back().count += init_runs[i].count;
+        } else {
+          init_segment_t segment = {i, i + 1, start, init_runs[i].count, is_table};
+          segments.push_back(segment);
+          has_loop |= (!is_table && !is_zero(init_runs[i].value));
+        }
+        start += init_runs[i].count;
+      }
+
       s4o.print("\n");
       s4o.print(s4o.indent_spaces + "{\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
-      s4o.print("static const ");
-
-      current_mode = typedecl_am;
-      array_specification->accept(*this);
-      s4o.print(" temp = ");
-
-      init_array_values(array_initialization);
+      print_base_type();
+      s4o.print(" *__elems;\n");
+      if (has_loop)
+        s4o.print(s4o.indent_spaces + "ULINT __i;\n");
+      for (unsigned int j = 0; j < segments.size(); j++) {
+        if (!segments[j].is_table) continue;
+        s4o.print(s4o.indent_spaces + "static const ");
+        print_base_type();
+        s4o.print(" __init_table");
+        s4o.print(j);
+        s4o.print("[");
+        s4o.print(segments[j].count);
+        s4o.print("] = {");
+        print_runs(segments[j].first_run, segments[j].last_run);
+        s4o.print("};\n");
+      }
 
-      s4o.print(";\n");
-      var1_list->accept(*this);
+      list_c *list = dynamic_cast<list_c *>(var1_list);
+      if (NULL == list) ERROR;
+      for (int i = 0; i < list->n; i++) {
+        s4o.print(s4o.indent_spaces + "__elems = (");
+        print_base_type();
+        s4o.print(" *)");
+        s4o.print(GET_VAR_REF);
+        s4o.print("(");
+        print_variable_prefix();
+        list->get_element(i)->accept(*this);
+        s4o.print(",.table);\n");
+        for (unsigned int j = 0; j < segments.size(); j++)
+          print_segment(segments[j], j);
+      }
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}");
     }
     
+    /* Print the C initializer of the array, e.g. {{1,2,3}} */
     void init_array_values(symbol_c *array_initialization) {
+      get_array_values(array_initialization);
+
       s4o.print("{{");
+      print_runs(0, init_runs.size());
+      s4o.print("}}");
+    }
+    
+  private:
+    void print_base_type(void) {
+      arrayinitialization_mode_t old_mode = current_mode;
+      current_mode = typedecl_am;
+      array_base_type->accept(*this);
+      current_mode = old_mode;
+    }
+
+    /* Print the values in init_runs[first_run..last_run[, separated by commas.
+     * C initialises to 0 the elements missing at the end of an initializer, so we do not print them.
+     * This keeps {{0,0,0, ... ,0}} down to {{0}} for the default initial value of large arrays.
+     */
+    void print_runs(unsigned int first_run, unsigned int last_run) {
+      while ((last_run > first_run + 1) && is_zero(init_runs[last_run - 1].value))
+        last_run--;
+      if (is_zero(init_runs[last_run - 1].value)) {
+        /* all zero: print a single element */
+        init_runs[first_run].value->accept(*this);
+        return;
+      }
+      for (unsigned int i = first_run; i < last_run; i++)
+        for (unsigned long long int j = 0; j < init_runs[i].count; j++) {
+          if ((i > first_run) || (j > 0))
+            s4o.print(",");
+          init_runs[i].value->accept(*this);
+        }
+    }
+
+    void print_segment(const init_segment_t &segment, unsigned int index) {
+      s4o.print(s4o.indent_spaces);
+      if (segment.is_table) {
+        s4o.print("memcpy(&__elems[");
+        s4o.print_long_long_integer(segment.start);
+        s4o.print("], __init_table");
+        s4o.print(index);
+        s4o.print(", sizeof(__init_table");
+        s4o.print(index);
+        s4o.print("));\n");
+        return;
+      }
+      symbol_c *value = init_runs[segment.first_run].value;
+      if (is_zero(value)) {
+        s4o.print("memset(&__elems[");
+        s4o.print_long_long_integer(segment.start);
+        s4o.print("], 0, ");
+        s4o.print_long_long_integer(segment.count);
+        s4o.print(" * sizeof(");
+        print_base_type();
+        s4o.print("));\n");
+        return;
+      }
+      s4o.print("for (__i = ");
+      s4o.print_long_long_integer(segment.start);
+      s4o.print("; __i < ");
+      s4o.print_long_long_integer(segment.start + segment.count);
+      s4o.print("; __i++) __elems[__i] = ");
+      value->accept(*this);
+      s4o.print(";\n");
+    }
+
+    /* Is the value of the array elements in <run> to be set in a loop (or memset()), instead of copied from a table? */
+    bool is_loop_run(const init_run_t &run) {
+      if (run.count < min_loop_count) return false;
+      /* structure initializers {...} may only be used in a declaration */
+      initialization_analyzer_c initialization_analyzer(run.value);
+      return (initialization_analyzer.get_initialization_type() == initialization_analyzer_c::simple_it);
+    }
+
+    /* Is <value> a literal whose C representation has all bits set to 0? */
+    static bool is_zero(symbol_c *value) {
+      if (VALID_CVALUE( int64, value)) return (GET_CVALUE( int64, value) == 0);
+      if (VALID_CVALUE(uint64, value)) return (GET_CVALUE(uint64, value) == 0);
+      if (VALID_CVALUE(  bool, value)) return (GET_CVALUE(  bool, value) == false);
+      if (VALID_CVALUE(real64, value)) {
+        real64_t real_value = GET_CVALUE(real64, value), real_zero = 0.0;
+        return (memcmp(&real_value, &real_zero, sizeof(real64_t)) == 0);  /* -0.0 is not all zero bits! */
+      }
+      /* The default initial values returned by type_initial_value_c are not annotated by constant folding. */
+      integer_c *integer = dynamic_cast<integer_c *>(value);
+      if (NULL != integer) return (strcmp(integer->value, "0") == 0);
+      real_c *real = dynamic_cast<real_c *>(value);
+      if (NULL != real) return (strcmp(real->value, "0") == 0);
+      boolean_literal_c *boolean = dynamic_cast<boolean_literal_c *>(value);
+      if (NULL != boolean) return (NULL != dynamic_cast<boolean_false_c *>(boolean->value));
+      return false;
+    }
+
+    /* Fill init_runs with the initial values of all the array elements. */
+    void get_array_values(symbol_c *array_initialization) {
+      defined_values_count = 0;
+      skip_values_count = 0;
+      init_runs.clear();
 
       current_mode = initializationvalue_am;
       array_initialization->accept(*this);
 
-      if (array_default_initialization != NULL && defined_values_count < array_size)
+      /* The elements not initialised by the variable declaration get the initial
+       * values given in the declaration of the array datatype...
+       */
+      if (array_default_initialization != NULL && defined_values_count < array_size) {
+        skip_values_count = defined_values_count;
         array_default_initialization->accept(*this);
-      if (defined_values_count < array_size) {
-        for (unsigned long long int i = defined_values_count; i < array_size; i++) {
-          if (defined_values_count > 0)
-            s4o.print(",");
-          array_default_value->accept(*this);
-          defined_values_count++;
-        }
       }
+      /* ... or the default initial value of the array elements' datatype. */
+      add_values(array_default_value, array_size - defined_values_count);
+    }
 
-      s4o.print("}}");
+    /* Add <count> elements with <value>, after skipping the first skip_values_count elements. */
+    void add_values(symbol_c *value, unsigned long long int count) {
+      if (count <= skip_values_count) {
+        skip_values_count -= count;
+        return;
+      }
+      count -= skip_values_count;
+      skip_values_count = 0;
+      if (defined_values_count + count > array_size)
+        ERROR;
+      defined_values_count += count;
+      if (!init_runs.empty() && (init_runs.back().value == value)) {
+        init_runs.back().count += count;
+      } else {
+        init_run_t run = {value, count};
+        init_runs.push_back(run);
+      }
     }
-    
+
+  public:
     void *visit(identifier_c *type_name) {
       type_symtable_t::iterator iter = type_symtable.end();
       switch (current_mode) {
@@ -159,21 +347,6 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
       return NULL;
     }
 
-    void *visit(var1_list_c *symbol) {
-      int i, j;
-      
-      for (i = 0; i < symbol->n; i++) {
-        s4o.print(s4o.indent_spaces);
-        s4o.print(SET_VAR);
-        s4o.print("(");
-        print_variable_prefix();
-        s4o.print(",");
-        symbol->get_element(i)->accept(*this);
-        s4o.print(",,temp);\n");
-      }
-      return NULL;
-    }
-
 /********************************/
 /* B 1.3.3 - Derived data types */
 /********************************/
@@ -242,24 +415,11 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
     void *visit(array_initial_elements_list_c *symbol) {
       switch (current_mode) {
         case initializationvalue_am:
-          current_initialization_count = 0;
           for (int i = 0; i < symbol->n; i++) {
-            if (current_initialization_count >= defined_values_count) {
-              if (defined_values_count >= array_size)
-                ERROR;
-              if (defined_values_count > 0)
-                s4o.print(",");
+            if (NULL != dynamic_cast<array_initial_elements_c *>(symbol->get_element(i)))
               symbol->get_element(i)->accept(*this);
-              defined_values_count++;
-            }
-            else {
-              array_initial_elements_c *array_initial_element = dynamic_cast<array_initial_elements_c *>(symbol->get_element(i));
-            
-              if (array_initial_element != NULL) {
-                symbol->get_element(i)->accept(*this);
-              }
-            }
-            current_initialization_count++;
+            else
+              add_values(symbol->get_element(i), 1);
           }
           break;
         default:
@@ -285,34 +445,10 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
             initial_element_count = GET_CVALUE(uint64, symbol->integer);
           else ERROR;
      
-          if (current_initialization_count < defined_values_count) {
-            unsigned long long int temp_element_number = 0;
-            unsigned long long int diff = defined_values_count - current_initialization_count;
-            if (diff <= initial_element_count)
-              temp_element_number = initial_element_count - diff;
-            current_initialization_count += initial_element_count - 1;
-            initial_element_count = temp_element_number;
-            if (initial_element_count > 0) {
-              defined_values_count++;
-              s4o.print(",");
-            }
-          }
+          if (symbol->array_initial_element != NULL)
+            add_values(symbol->array_initial_element, initial_element_count);
           else
-            current_initialization_count += initial_element_count - 1;
-          if (defined_values_count + initial_element_count > array_size)
-            ERROR;
-          for (unsigned long long int i = 0; i < initial_element_count; i++) {
-            if (i > 0)
-              s4o.print(",");
-            if (symbol->array_initial_element != NULL) {
-              symbol->array_initial_element->accept(*this);
-            }
-            else {
-              array_default_value->accept(*this);
-            }
-          }
-          if (initial_element_count > 1)
-            defined_values_count += initial_element_count - 1;
+            add_values(array_default_value, initial_element_count);
           break;
         default:
           break;
@@ -853,6 +989,18 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      *
      *                e.g.
      *                __plc_pt_c<INT, 8*sizeof(INT)> START_P::loc = __plc_pt_c<INT, 8*sizeof(INT)>("I2");
+     *
+     * layout_vf: entries of the layout descriptor of a FB or Program data
+     *            structure (see generate_c_layout.cc).
+     *           e.g.
+     *                __LAYOUT_VAR(INT,a)
+     *                __LAYOUT_FB(FB1,b)
+     *
+     * retain_vf: body of the function that copies the RETAIN variables of a FB or
+     *            Program to/from the retain image (see generate_c_retain.cc).
+     *           e.g.
+     *                __RETAIN_VAR(data__->a,retain);
+     *                FB1_retain__(&data__->b,image,backup,1);
      */
     typedef enum {finterface_vf,
                   foutputassign_vf,
@@ -861,7 +1009,9 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
                   init_vf,
                   constructorinit_vf,
                   globalinit_vf,
-                  globalprototype_vf
+                  globalprototype_vf,
+                  layout_vf,
+                  retain_vf
                  } varformat_t;
 
 
@@ -942,6 +1092,12 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      */
     symbol_c *globalnamespace;
 
+    /* Only used when wanted_varformat == finterface_vf
+     * Holds a pointer to the function_declaration_c whose interface is being declared,
+     * so we can determine which inputs are passed by pointer (see generate_c_byref_inputs.cc)
+     */
+    symbol_c *finterface_function;
+
     void *print_retain(void) {
       s4o.print(",");
       switch (current_varqualifier) {
@@ -1007,10 +1163,52 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       if (list == NULL) ERROR;
 
       /* now to produce the c equivalent... */
+      if (wanted_varformat == layout_vf) {
+        for(int i = 0; i < list->n; i++) {
+          if (generate_c_dead_code_c::is_dead_var(list->get_element(i))) continue; /* see generate_c_dead_code.cc */
+          s4o.print(s4o.indent_spaces);
+          /* FB instances of a FB with no layout descriptor (e.g. a standard FB) are copied as a whole */
+          if (is_fb && generate_c_layout_c::has_layout(this->current_var_type_symbol))
+            s4o.print(LAYOUT_FB);
+          else
+            s4o.print(LAYOUT_VAR);
+          s4o.print("(");
+          this->current_var_type_symbol->accept(*this);
+          s4o.print(",");
+          print_variable_prefix();
+          list->get_element(i)->accept(*this);
+          s4o.print(")\n");
+        }
+      }
+
+      if (wanted_varformat == retain_vf) {
+        for(int i = 0; i < list->n; i++) {
+          if (generate_c_dead_code_c::is_dead_var(list->get_element(i))) continue; /* see generate_c_dead_code.cc */
+          s4o.print(s4o.indent_spaces);
+          /* FB instances of a FB with no retain function (e.g. a standard FB) are copied as a whole */
+          if (is_fb && generate_c_retain_c::has_retain(this->current_var_type_symbol)) {
+            this->current_var_type_symbol->accept(*this);
+            s4o.print(FB_RETAIN_SUFFIX "(&");
+            print_variable_prefix();
+            list->get_element(i)->accept(*this);
+            s4o.print(",image,backup");
+            print_retain();
+            s4o.print(");\n");
+          } else {
+            s4o.print(RETAIN_VAR "(");
+            print_variable_prefix();
+            list->get_element(i)->accept(*this);
+            print_retain();
+            s4o.print(");\n");
+          }
+        }
+      }
+
       if ((wanted_varformat == local_vf) ||
           (wanted_varformat == init_vf) ||
           (wanted_varformat == localinit_vf)) {
         for(int i = 0; i < list->n; i++) {
+          if (generate_c_dead_code_c::is_dead_var(list->get_element(i))) continue; /* see generate_c_dead_code.cc */
           s4o.print(s4o.indent_spaces);
           if (wanted_varformat == local_vf) {
             if (!is_fb) {
@@ -1094,9 +1292,15 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
           finterface_var_count++;
           s4o.print(nv->get());
           s4o.print("\n" + s4o.indent_spaces);
+          bool byref_input =    ((current_vartype & input_vt) != 0)
+                             && generate_c_byref_inputs_c::is_byref(finterface_function, list->get_element(i));
+          if (byref_input)
+            s4o.print("const ");
           this->current_var_type_symbol->accept(*this);
           if ((current_vartype & (output_vt | inoutput_vt)) != 0)
             s4o.print(" *__");
+          else if (byref_input)
+            s4o.print(" *");
           else
             s4o.print(" ");
           list->get_element(i)->accept(*this);
@@ -1130,6 +1334,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
 
       if (wanted_varformat == constructorinit_vf) {
         for(int i = 0; i < list->n; i++) {
+          if (generate_c_dead_code_c::is_dead_var(list->get_element(i))) continue; /* see generate_c_dead_code.cc */
           if (is_fb) {
             /* If we are declaring and/or initializing a FB instance, then we
              * simply call the FBNAME_init__() function, which will initialise the
@@ -1190,6 +1395,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       current_var_type_symbol = NULL;
       current_var_init_symbol = NULL;
       globalnamespace         = NULL;
+      finterface_function     = NULL;
       nv = NULL;
       resource_name = res_name;
     }
@@ -1200,6 +1406,8 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       this->set_variable_prefix(variable_prefix);
       if (globalinit_vf == wanted_varformat)
         globalnamespace = scope;
+      if (finterface_vf == wanted_varformat)
+        finterface_function = scope;
 
       finterface_var_count = 0;
 
@@ -1216,6 +1424,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       delete nv;
       nv = NULL;
       globalnamespace = NULL;
+      finterface_function = NULL;
     }
 
   protected:
@@ -1359,6 +1568,15 @@ void *visit(en_param_declaration_c *symbol) {
       symbol->name->accept(*this);
     }
 
+    if (wanted_varformat == layout_vf) {
+      s4o.print(s4o.indent_spaces + LAYOUT_VAR "(");
+      this->current_var_type_symbol->accept(*this);
+      s4o.print(",");
+      print_variable_prefix();
+      symbol->name->accept(*this);
+      s4o.print(")\n");
+    }
+
     if ((wanted_varformat == local_vf) ||
         (wanted_varformat == init_vf) ||
         (wanted_varformat == localinit_vf)) {
@@ -1417,6 +1635,15 @@ void *visit(eno_param_declaration_c *symbol) {
       symbol->name->accept(*this);
     }
 
+    if (wanted_varformat == layout_vf) {
+      s4o.print(s4o.indent_spaces + LAYOUT_VAR "(");
+      symbol->type->accept(*this);
+      s4o.print(",");
+      print_variable_prefix();
+      symbol->name->accept(*this);
+      s4o.print(")\n");
+    }
+
     if ((wanted_varformat == local_vf) ||
         (wanted_varformat == init_vf) ||
         (wanted_varformat == localinit_vf)) {
@@ -0,0 +1,183 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ *  Vectorisation hints for FOR loops over arrays.
+ *
+ *  Elements of the arrays of a FB or Program are accessed through the
+ *  __GET_VAR() and __SET_VAR() macros (i.e. data__->ARR.value.table[i - lo]),
+ *  and every write first tests the array's force flag. The C compiler
+ *  can not tell that distinct arrays do not overlap, nor move the flag test
+ *  out of the loop, so it hardly ever vectorises these loops.
+ *
+ *  When the 'x' stage4 option is given (-O x), a FOR loop that is already
+ *  generated as a C for(;;) loop (see visit(for_statement_c *) in
+ *  generate_c_st.cc) has its array elements accessed through restrict
+ *  qualified pointers to the array tables, declared just before the loop,
+ *  and is preceded by a hint that the loop has no loop carried dependencies
+ *  (__IVDEP, i.e. #pragma GCC ivdep). If any of the arrays written in the
+ *  loop may be forced by the debugger, this version of the loop is only
+ *  executed when none of them is forced, and the usual version of the
+ *  loop is executed otherwise.
+ *
+ *  This is only done when the loop's body:
+ *    - only contains assignment and IF statements;
+ *    - only writes to C local variables (other than the control variable),
+ *      and to elements of one dimensional arrays that are indexed by the
+ *      control variable itself, and nothing else, on every access to that array;
+ *    - does not use any array as a whole (e.g. assigning or passing it to a Function),
+ *      nor pass anything to an OUT or IN_OUT parameter of a Function;
+ *  and when the arrays accessed through the pointers are elementary (non string)
+ *  arrays declared in the POU itself (not VAR_EXTERNAL, nor VAR_IN_OUT, nor
+ *  inputs of Functions, which may all refer to the same array).
+ *
+ *  This class analyses the body of the FOR loop. The decision on which arrays
+ *  are accessed through the pointers, which depends on how each variable is stored
+ *  in C, is left to generate_c_st_c.
+ */
+
+
+class generate_c_vector_loop_c: public iterator_visitor_c {
+  public:
+    typedef struct {
+      array_variable_c *element;  /* one of the accesses to an element of the array */
+      bool written;               /* is any element of the array written to in the loop? */
+      bool other_index;           /* is any element of the array accessed with an index other than the control variable? */
+    } array_info_t;
+    typedef std::map<std::string, array_info_t, nocasecmp_c> arrays_t;
+
+    /* the one dimensional arrays whose elements are accessed in the loop */
+    arrays_t arrays;
+    /* the variables (other than array elements) written to in the loop */
+    std::vector<symbolic_variable_c *> written_vars;
+    /* false if the loop contains anything we do not handle */
+    bool supported;
+
+  private:
+    token_c *control_var_name;
+
+  public:
+    generate_c_vector_loop_c(for_statement_c *symbol): supported(true) {
+      control_var_name = get_var_name_c::get_name(symbol->control_variable);
+      if (NULL == control_var_name) ERROR;
+      symbol->statement_list->accept(*this);
+    }
+    ~generate_c_vector_loop_c(void) {}
+
+  private:
+    void add_element(array_variable_c *symbol, bool written) {
+      symbolic_variable_c *array = dynamic_cast<symbolic_variable_c *>(symbol->subscripted_variable);
+      list_c *subscript_list = dynamic_cast<list_c *>(symbol->subscript_list);
+      if ((NULL == array) || (NULL == subscript_list) || (subscript_list->n != 1)) {supported = false; return;}
+      token_c *array_name = get_var_name_c::get_name(array);
+      if (NULL == array_name) ERROR;
+
+      symbolic_variable_c *index = dynamic_cast<symbolic_variable_c *>(subscript_list->get_element(0));
+      token_c *index_name = (NULL == index)? NULL : dynamic_cast<token_c *>(index->var_name);
+      bool other_index = ((NULL == index_name) || (strcasecmp(index_name->value, control_var_name->value) != 0));
+
+      arrays_t::iterator it = arrays.find(array_name->value);
+      if (it == arrays.end()) {
+        array_info_t info = {symbol, written, other_index};
+        arrays[array_name->value] = info;
+      } else {
+        it->second.written     |= written;
+        it->second.other_index |= other_index;
+      }
+    }
+
+    /*********************/
+    /* B 1.4 - Variables */
+    /*********************/
+    void *visit(symbolic_variable_c *symbol) {
+      /* an array used as a whole */
+      if (get_datatype_info_c::is_array(symbol->datatype)) supported = false;
+      return NULL;
+    }
+
+    void *visit(array_variable_c *symbol) {
+      add_element(symbol, false);
+      symbol->subscript_list->accept(*this);
+      return NULL;
+    }
+
+    void *visit(structured_variable_c *symbol) {supported = false; return NULL;}
+    void *visit(direct_variable_c     *symbol) {return NULL;}
+
+    /***************************************/
+    /* B.3 - Language ST (Structured Text) */
+    /***************************************/
+    /***********************/
+    /* B 3.1 - Expressions */
+    /***********************/
+    void *visit(ref_expression_c   *symbol) {supported = false; return NULL;}
+    void *visit(deref_expression_c *symbol) {supported = false; return NULL;}
+
+    void *visit(function_invocation_c *symbol) {
+      /* NOTE: the called Function may not have been determined if the code contains errors. */
+      if (NULL == symbol->called_function_declaration) {supported = false; return NULL;}
+      const param_binding_list_c &param_bindings = call_param_bindings_c::get(symbol, symbol->called_function_declaration);
+      for (unsigned int i = 0; i < param_bindings.size(); i++) {
+        const param_binding_c &binding = param_bindings[i];
+        if (   (NULL != binding.param_value)
+            && (binding.param_direction != function_param_iterator_c::direction_in))
+          supported = false;
+      }
+      return iterator_visitor_c::visit(symbol);
+    }
+
+    /*********************************/
+    /* B 3.2.1 Assignment Statements */
+    /*********************************/
+    void *visit(assignment_statement_c *symbol) {
+      array_variable_c    *element  = dynamic_cast<array_variable_c    *>(symbol->l_exp);
+      symbolic_variable_c *variable = dynamic_cast<symbolic_variable_c *>(symbol->l_exp);
+      if (NULL != element) {
+        add_element(element, true);
+        element->subscript_list->accept(*this);
+      } else if ((NULL != variable) && !get_datatype_info_c::is_array(variable->datatype))
+        written_vars.push_back(variable);
+      else
+        supported = false;
+      symbol->r_exp->accept(*this);
+      return NULL;
+    }
+
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(fb_invocation_c    *symbol) {supported = false; return NULL;}
+    void *visit(return_statement_c *symbol) {supported = false; return NULL;}
+
+    /********************************/
+    /* B 3.2.3 Selection Statements */
+    /********************************/
+    void *visit(case_statement_c *symbol) {supported = false; return NULL;}
+
+    /********************************/
+    /* B 3.2.4 Iteration Statements */
+    /********************************/
+    void *visit(for_statement_c    *symbol) {supported = false; return NULL;}
+    void *visit(while_statement_c  *symbol) {supported = false; return NULL;}
+    void *visit(repeat_statement_c *symbol) {supported = false; return NULL;}
+    void *visit(exit_statement_c   *symbol) {supported = false; return NULL;}
+}; /* generate_c_vector_loop_c */
@@ -235,6 +235,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     unsigned int step_number;
     unsigned int transition_number;
     unsigned int action_number;
+    sequential_function_chart_c *current_sfc;
     bool configuration_defined;
     std::list<SYMBOL> current_symbol_list;
     search_type_symbol_c *search_type_symbol;
@@ -282,6 +283,15 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       current_declarationtype = none_dt;
       s4o.print("\n");
     }
+
+    /* List the variables of any instance of the FB or Program <pou_decl>, relative to the instance */
+    void generate_pou_variables(symbol_c *pou_decl) {
+      current_var_number = 0;
+      configuration_defined = true;
+      current_declarationtype = variables_dt;
+      pou_decl->accept(*this);
+      current_declarationtype = none_dt;
+    }
     
     void declare_variables(symbol_c *symbol) {
       list_c *list = dynamic_cast<list_c *>(symbol);
@@ -294,6 +304,9 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     }
     
     void declare_variable(symbol_c *symbol) {
+      // Variables removed from the FB/Program data structures (see generate_c_dead_code.cc)
+      if (generate_c_dead_code_c::is_dead_var(symbol))
+        return;
       // Arrays and structures are not supported in debugging
       switch (search_type_symbol->current_var_type_category) {
           case search_type_symbol_c::array_vtc:
@@ -376,6 +389,16 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       current_var_number++;
     }
         
+    void print_step_element(symbol_c *step_name) {
+      if (generate_sfc_packed_state__) { /* global variable generate_sfc_packed_state__ is defined in generate_c.cc */
+        s4o.print(generate_c_sfc_timed_steps_c::get_step_element(current_sfc, step_name));
+        return;
+      }
+      s4o.print("__step_list[");
+      print_step_number();
+      s4o.print("]");
+    }
+
     void print_step_number(void) {
       char str[10];
       sprintf(str, "%d", step_number);
@@ -856,6 +879,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     /* | sequential_function_chart sfc_network */
     //SYM_LIST(sequential_function_chart_c)
     void *visit(sequential_function_chart_c *symbol) {
+      current_sfc = symbol;
       step_number = 0;
       transition_number = 0;
       action_number = 0;
@@ -874,9 +898,8 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       symbol->step_name->accept(*this);
       s4o.print(".X;");
       print_symbol_list();
-      s4o.print("__step_list[");
-      print_step_number();
-      s4o.print("].X;BOOL;\n");
+      print_step_element(symbol->step_name);
+      s4o.print(".X;BOOL;\n");
       step_number++;
       return NULL;
     }
@@ -890,9 +913,8 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       symbol->step_name->accept(*this);
       s4o.print(".X;");
       print_symbol_list();
-      s4o.print("__step_list[");
-      print_step_number();
-      s4o.print("].X;BOOL;\n");
+      print_step_element(symbol->step_name);
+      s4o.print(".X;BOOL;\n");
       step_number++;
       return NULL;
     }
@@ -0,0 +1,17 @@
+/* Runs the TEST_MAIN program generated by iec2c once, and returns the
+ * number of checks that failed (i.e. the value of its FAILED output).
+ */
+#include "iec_std_lib.h"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#include "POUS.h"
+#include "POUS.c"
+
+int main(void) {
+  TEST_MAIN test_main;
+  TEST_MAIN_init__(&test_main, 0);
+  TEST_MAIN_body__(&test_main);
+  return test_main.FAILED.value;
+}